@@ -0,0 +1,113 @@
+// Copyright 2022 Matthias Heinz
+// Compares ME2JP text parsing throughput of stream extraction and the
+// parallel std::from_chars parser.
+//
+// Usage: me2jp_parsing.out [emax] [repetitions]
+// Reads the O16 NAT test data for the given emax (default 4) from tests/data
+// and must be run from the repository root.
+
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fmt/core.h"
+#include "spdlog/spdlog.h"
+
+#include "imsrg/files/formats/helpers/text.h"
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/openmp_runtime.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+namespace {
+
+template <typename F>
+double TimeInSeconds(F&& f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+void ReportThroughput(const std::string& label, std::size_t num_bytes,
+                      int reps, double time) {
+  spdlog::info("{:<24} time = {:.4f} s, throughput = {:>8.1f} MB/s", label,
+               time / reps, num_bytes * reps / time / 1e6);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+
+  const std::string filler(72, '*');
+  const int emax_int = argc > 1 ? std::atoi(argv[1]) : 4;
+  const int reps = argc > 2 ? std::atoi(argv[2]) : 10;
+  const HOEnergy emax(emax_int);
+
+  const std::string path_to_file = fmt::format(
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_{0:02}/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_{0:02}_hw_24.00_"
+      "emax_{0:02}.me2jp",
+      emax_int);
+
+  imsrg::OpenMPRuntime::InitializeRuntime();
+
+  const auto text = imsrg::mexj::ReadWholeFile(path_to_file);
+  const auto body = std::string_view(text).substr(text.find('\n'));
+
+  std::vector<double> values;
+  {
+    std::istringstream stream(std::string{body});
+    double value;
+    while (stream >> value) {
+      values.push_back(value);
+    }
+  }
+  std::vector<double> parsed(values.size(), 0.0);
+
+  spdlog::info(filler);
+  spdlog::info("ME2JP text parsing, emax = {}, {} B, {} values, {} threads",
+               emax_int, text.size(), values.size(),
+               imsrg::OpenMPRuntime::GetInstance().MaxNumberOfThreads());
+  spdlog::info(filler);
+
+  double time = TimeInSeconds([&]() {
+    for (int i = 0; i < reps; i += 1) {
+      std::istringstream stream(std::string{body});
+      for (auto& value : parsed) {
+        stream >> value;
+      }
+    }
+  });
+  ReportThroughput("istream >>", body.size(), reps, time);
+
+  time = TimeInSeconds([&]() {
+    for (int i = 0; i < reps; i += 1) {
+      imsrg::mexj::ParseDoubles(body, parsed.data(), parsed.size());
+    }
+  });
+  ReportThroughput("parallel from_chars", body.size(), reps, time);
+
+  for (std::size_t i = 0; i < values.size(); i += 1) {
+    if (parsed[i] != values[i]) {
+      spdlog::error("Value {} differs: {} != {}", i, parsed[i], values[i]);
+      return 1;
+    }
+  }
+
+  time = TimeInSeconds([&]() {
+    for (int i = 0; i < reps; i += 1) {
+      ME2JPFile::FromTextFile(path_to_file, emax, Hermiticity::Hermitian());
+    }
+  });
+  ReportThroughput("ME2JPFile::FromTextFile", text.size(), reps, time);
+
+  return 0;
+}
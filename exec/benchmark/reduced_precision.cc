@@ -0,0 +1,178 @@
+// Copyright 2022 Matthias Heinz
+// Compares reduced-precision two-body operator storage against double.
+//
+// Usage: reduced_precision.out [emax]
+// Reads the O16 NAT test data for the given emax (default 4) from tests/data
+// and must be run from the repository root.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+#include "fmt/core.h"
+#include "spdlog/spdlog.h"
+
+#include "imsrg/commutator/scalar/comm_220.h"
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/model_space/scalar/two_body/model_space.h"
+#include "imsrg/model_space/single_particle/full_basis.h"
+#include "imsrg/model_space/single_particle/model_space.h"
+#include "imsrg/model_space/single_particle/reference_state.h"
+#include "imsrg/operator/scalar/two_body/compact_operator.h"
+#include "imsrg/operator/scalar/two_body/operator.h"
+#include "imsrg/operator/scalar/two_body/read.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+namespace {
+
+struct StorageError {
+  double max_abs_err = 0.0;
+  double max_rel_err = 0.0;
+  double norm_rel_err = 0.0;
+};
+
+template <typename T>
+StorageError ComputeStorageError(
+    const imsrg::Scalar2BOperator& op,
+    const imsrg::Scalar2BCompactOperator<T>& compact_op) {
+  StorageError err;
+  double norm_sq = 0.0;
+  double diff_norm_sq = 0.0;
+  for (std::size_t i = 0; i < op.size(); i += 1) {
+    const auto& tensor = op.GetTensorAtIndex(i);
+    const auto& compact_tensor = compact_op.GetTensorAtIndex(i);
+    for (std::size_t s = 0; s < tensor.dim_size(3); s += 1) {
+      for (std::size_t r = 0; r < tensor.dim_size(2); r += 1) {
+        for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+          for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+            const double val = tensor(p, q, r, s);
+            const double diff = std::abs(compact_tensor(p, q, r, s) - val);
+            norm_sq += val * val;
+            diff_norm_sq += diff * diff;
+            err.max_abs_err = std::max(err.max_abs_err, diff);
+            if (val != 0.0) {
+              err.max_rel_err = std::max(err.max_rel_err, diff / std::abs(val));
+            }
+          }
+        }
+      }
+    }
+  }
+  err.norm_rel_err = std::sqrt(diff_norm_sq / norm_sq);
+  return err;
+}
+
+template <typename F>
+double TimeInSeconds(F&& f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+void ReportStorage(const std::string& label, const StorageError& err,
+                   std::size_t size_in_bytes) {
+  spdlog::info("{:<24} size = {:>12} B, max abs err = {:.3e}, "
+               "max rel err = {:.3e}, rel norm err = {:.3e}",
+               label, size_in_bytes, err.max_abs_err, err.max_rel_err,
+               err.norm_rel_err);
+}
+
+void ReportCommutator(const std::string& label, double val, double ref,
+                      double time) {
+  spdlog::info("{:<24} [eta, H] = {:.10f}, abs err = {:.3e}, "
+               "rel err = {:.3e}, time = {:.4f} s",
+               label, val, std::abs(val - ref), std::abs((val - ref) / ref),
+               time);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+
+  const std::string filler(72, '*');
+  const int emax_int = argc > 1 ? std::atoi(argv[1]) : 4;
+  const HOEnergy emax(emax_int);
+
+  const std::string path_prefix = fmt::format(
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_{0:02}/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_{0:02}_hw_24.00_"
+      "emax_{0:02}",
+      emax_int);
+
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  auto h2 = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b, Hermiticity::Hermitian());
+  auto gen2 = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b, Hermiticity::AntiHermitian());
+  imsrg::ReadOperatorFromME2JP(
+      ME2JPFile::FromTextFile(path_prefix + ".me2jp", emax,
+                              Hermiticity::Hermitian()),
+      h2);
+  imsrg::ReadOperatorFromME2JP(
+      ME2JPFile::FromTextFile(
+          path_prefix + "_imaginary-time_Moller_Plesset_gen2.me2jp", emax,
+          Hermiticity::AntiHermitian()),
+      gen2);
+
+  const auto h2_f = imsrg::Scalar2BFloatOperator::FromScalar2BOperator(h2);
+  const auto h2_bf = imsrg::Scalar2BBFloat16Operator::FromScalar2BOperator(h2);
+  const auto gen2_f = imsrg::Scalar2BFloatOperator::FromScalar2BOperator(gen2);
+  const auto gen2_bf =
+      imsrg::Scalar2BBFloat16Operator::FromScalar2BOperator(gen2);
+
+  std::size_t double_size = 0;
+  for (std::size_t i = 0; i < h2.size(); i += 1) {
+    const auto& tensor = h2.GetTensorAtIndex(i);
+    double_size += tensor.dim_size(0) * tensor.dim_size(1) *
+                   tensor.dim_size(2) * tensor.dim_size(3) * sizeof(double);
+  }
+
+  spdlog::info(filler);
+  spdlog::info("Reduced-precision storage, emax = {}", emax_int);
+  spdlog::info(filler);
+  spdlog::info("{:<24} size = {:>12} B", "double", double_size);
+  ReportStorage("H (float)", ComputeStorageError(h2, h2_f),
+                h2_f.SizeInBytes());
+  ReportStorage("H (bfloat16)", ComputeStorageError(h2, h2_bf),
+                h2_bf.SizeInBytes());
+  ReportStorage("eta (float)", ComputeStorageError(gen2, gen2_f),
+                gen2_f.SizeInBytes());
+  ReportStorage("eta (bfloat16)", ComputeStorageError(gen2, gen2_bf),
+                gen2_bf.SizeInBytes());
+
+  spdlog::info(filler);
+  spdlog::info("[2, 2] -> 0 commutator, double accumulation");
+  spdlog::info(filler);
+
+  double ref = 0.0;
+  double val = 0.0;
+  double time = TimeInSeconds([&]() {
+    ref = imsrg::EvaluateScalar220CommutatorRefImpl(gen2, h2);
+  });
+  ReportCommutator("double", ref, ref, time);
+
+  time = TimeInSeconds(
+      [&]() { val = imsrg::EvaluateScalar220Commutator(gen2_f, h2_f); });
+  ReportCommutator("float", val, ref, time);
+
+  time = TimeInSeconds(
+      [&]() { val = imsrg::EvaluateScalar220Commutator(gen2_bf, h2_f); });
+  ReportCommutator("eta bfloat16, H float", val, ref, time);
+
+  time = TimeInSeconds(
+      [&]() { val = imsrg::EvaluateScalar220Commutator(gen2_bf, h2_bf); });
+  ReportCommutator("bfloat16", val, ref, time);
+
+  return 0;
+}
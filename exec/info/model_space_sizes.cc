@@ -56,6 +56,8 @@ int main(void) {
     spdlog::info(
         "bare_channels size in memory = {}",
         ms2b->BareChannels().size() * sizeof(imsrg::Scalar2BBareChannelKey));
+    spdlog::info("channel index lookup size in memory = {}",
+                 ms2b->ChannelIndexLookup().SizeInBytes());
     spdlog::info(filler);
   }
 
@@ -7,6 +7,7 @@
 #include "ntcl/algorithms/easy_tensor_contraction_interface_cbind.h"
 #include "ntcl/data/f_array.h"
 
+#include "imsrg/commutator/scalar/leading_block.h"
 #include "imsrg/model_space/scalar/one_body/channel_key.h"
 #include "imsrg/operator/scalar/one_body/operator.h"
 #include "imsrg/operator/scalar/two_body/operator.h"
@@ -22,6 +23,13 @@ static ntcl::FArray<double, 2> WeightMatrixElementsWithOccs(
     const std::vector<double>& occs_p, const std::vector<double>& occs_q,
     const ntcl::FArray<double, 2>& tensor);
 
+// C(i,j) += factor * A(p,q) * B(i,q,j,p) where B may be an e2max truncated
+// tensor covering only the leading states of C and A.
+static void ContractWithTwoBodyTensor(const ntcl::FArray<double, 2>& tensor_a,
+                                      const ntcl::FArray<double, 4>& tensor_b,
+                                      double factor,
+                                      ntcl::FArray<double, 2>& tensor_c);
+
 static void EvaluateScalar121CommutatorWithFactorOld(const Scalar1BOperator& a,
                                                      const Scalar2BOperator& b,
                                                      Scalar1BOperator& c,
@@ -92,8 +100,6 @@ void EvaluateScalar121CommutatorWithFactorOld(const Scalar1BOperator& a,
   Expects(a.GetModelSpacePtr() == c.GetModelSpacePtr());
   Expects(c.Herm() == Hermiticity::CommutatorHermiticity(a.Herm(), b.Herm()));
 
-  const auto& ntcl_engine = ntcl::AlgorithmsEngine::GetInstance();
-
   const auto& ms_1b = a.GetModelSpace();
   const auto& ms_2b = b.GetModelSpace();
 
@@ -149,10 +155,10 @@ void EvaluateScalar121CommutatorWithFactorOld(const Scalar1BOperator& a,
     const auto tensor_a_occsbar_occs =
         WeightMatrixElementsWithOccs(occsbar_p, occs_q, tensor_a);
 
-    ntcl_engine.Contract(tensor_c, tensor_a_occs_occsbar, tensor_b,
-                         "C(i,j)=A(p,q)*B(i,q,j,p)", channel_factor, 1.0);
-    ntcl_engine.Contract(tensor_c, tensor_a_occsbar_occs, tensor_b,
-                         "C(i,j)=A(p,q)*B(i,q,j,p)", -1 * channel_factor, 1.0);
+    ContractWithTwoBodyTensor(tensor_a_occs_occsbar, tensor_b, channel_factor,
+                              tensor_c);
+    ContractWithTwoBodyTensor(tensor_a_occsbar_occs, tensor_b,
+                              -1 * channel_factor, tensor_c);
   }
 }
 
@@ -162,8 +168,6 @@ void EvaluateScalar121CommutatorWithFactor(const Scalar1BOperator& a,
   Expects(a.GetModelSpacePtr() == c.GetModelSpacePtr());
   Expects(c.Herm() == Hermiticity::CommutatorHermiticity(a.Herm(), b.Herm()));
 
-  const auto& ntcl_engine = ntcl::AlgorithmsEngine::GetInstance();
-
   const auto& ms_1b = a.GetModelSpace();
   const auto& ms_2b = b.GetModelSpace();
 
@@ -223,12 +227,11 @@ void EvaluateScalar121CommutatorWithFactor(const Scalar1BOperator& a,
         const auto chan_b_index = ms_2b.IndexOfChannelInModelSpace(chankey_b);
         const auto& tensor_b = b.GetTensorAtIndex(chan_b_index);
 
-        ntcl_engine.Contract(tensor_c, tensor_a_occs_occsbar, tensor_b,
-                             "C(i,j)=A(p,q)*B(i,q,j,p)",
-                             channel_factor1 * channel_factor2, 1.0);
-        ntcl_engine.Contract(tensor_c, tensor_a_occsbar_occs, tensor_b,
-                             "C(i,j)=A(p,q)*B(i,q,j,p)",
-                             -1 * channel_factor1 * channel_factor2, 1.0);
+        ContractWithTwoBodyTensor(tensor_a_occs_occsbar, tensor_b,
+                                  channel_factor1 * channel_factor2, tensor_c);
+        ContractWithTwoBodyTensor(tensor_a_occsbar_occs, tensor_b,
+                                  -1 * channel_factor1 * channel_factor2,
+                                  tensor_c);
       }
     }
   }
@@ -285,11 +288,11 @@ void EvaluateScalar121CommutatorRefImplWithFactorOld(const Scalar1BOperator& a,
     const auto& tensor_a = a.GetTensorAtIndex(chan_a_index);
     const auto& tensor_b = b.GetTensorAtIndex(chan_b_index);
 
-    // Dims
-    const auto dim_p = chan_p.size();
-    const auto dim_q = chan_q.size();
-    const auto dim_1 = chan_1.size();
-    const auto dim_2 = chan_2.size();
+    // Dims (of the possibly e2max truncated 2B channel)
+    const auto dim_1 = chan_b.BraDim1();
+    const auto dim_q = chan_b.BraDim2();
+    const auto dim_2 = chan_b.KetDim1();
+    const auto dim_p = chan_b.KetDim2();
 
     // Occs
     const auto& occs_p = chan_p.ChannelBasis().Occs();
@@ -378,10 +381,18 @@ void EvaluateScalar121CommutatorRefImplWithFactor(const Scalar1BOperator& a,
         }
         const auto chan_b_index = ms_2b.IndexOfChannelInModelSpace(chankey_b);
         const auto& tensor_b = b.GetTensorAtIndex(chan_b_index);
-        for (std::size_t i2 = 0; i2 < dim_2; i2 += 1) {
-          for (std::size_t i1 = 0; i1 < dim_1; i1 += 1) {
-            for (std::size_t q = 0; q < dim_q; q += 1) {
-              for (std::size_t p = 0; p < dim_p; p += 1) {
+
+        // Only the leading states of a truncated channel contribute.
+        const auto& chan_b = ms_2b.ChannelAtIndex(chan_b_index);
+        const auto dim_1_b = std::min(dim_1, chan_b.BraDim1());
+        const auto dim_q_b = std::min(dim_q, chan_b.BraDim2());
+        const auto dim_2_b = std::min(dim_2, chan_b.KetDim1());
+        const auto dim_p_b = std::min(dim_p, chan_b.KetDim2());
+
+        for (std::size_t i2 = 0; i2 < dim_2_b; i2 += 1) {
+          for (std::size_t i1 = 0; i1 < dim_1_b; i1 += 1) {
+            for (std::size_t q = 0; q < dim_q_b; q += 1) {
+              for (std::size_t p = 0; p < dim_p_b; p += 1) {
                 tensor_c(i1, i2) += channel_factor1 * channel_factor2 *
                                     occs_p[p] * occsbar_q[q] * tensor_a(p, q) *
                                     tensor_b(i1, q, i2, p);
@@ -397,5 +408,29 @@ void EvaluateScalar121CommutatorRefImplWithFactor(const Scalar1BOperator& a,
   }
 }
 
+void ContractWithTwoBodyTensor(const ntcl::FArray<double, 2>& tensor_a,
+                               const ntcl::FArray<double, 4>& tensor_b,
+                               double factor,
+                               ntcl::FArray<double, 2>& tensor_c) {
+  const auto& ntcl_engine = ntcl::AlgorithmsEngine::GetInstance();
+
+  const auto dim_i = tensor_b.dim_size(0);
+  const auto dim_q = tensor_b.dim_size(1);
+  const auto dim_j = tensor_b.dim_size(2);
+  const auto dim_p = tensor_b.dim_size(3);
+
+  if ((dim_i == tensor_c.dim_size(0)) && (dim_j == tensor_c.dim_size(1)) &&
+      (dim_p == tensor_a.dim_size(0)) && (dim_q == tensor_a.dim_size(1))) {
+    ntcl_engine.Contract(tensor_c, tensor_a, tensor_b,
+                         "C(i,j)=A(p,q)*B(i,q,j,p)", factor, 1.0);
+    return;
+  }
+
+  auto block_c = LeadingBlock(tensor_c, dim_i, dim_j);
+  ntcl_engine.Contract(block_c, LeadingBlock(tensor_a, dim_p, dim_q), tensor_b,
+                       "C(i,j)=A(p,q)*B(i,q,j,p)", factor, 1.0);
+  SetLeadingBlock(block_c, tensor_c);
+}
+
 }  // namespace detail
 }  // namespace imsrg
@@ -8,8 +8,10 @@
 #include "ntcl/data/f_array.h"
 
 #include "imsrg/model_space/scalar/one_body/channel_key.h"
+#include "imsrg/openmp_runtime.h"
 #include "imsrg/operator/scalar/one_body/operator.h"
 #include "imsrg/operator/scalar/two_body/antisymmetry.h"
+#include "imsrg/operator/scalar/two_body/truncation.h"
 
 namespace imsrg {
 
@@ -60,13 +62,22 @@ void EvaluateScalar122CommutatorWithFactor(const Scalar1BOperator& a,
 
   // const auto& ntcl_engine = ntcl::AlgorithmsEngine::GetInstance();
 
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
   const auto& ms_1b = a.GetModelSpace();
   const auto& ms_2b = b.GetModelSpace();
 
+#pragma omp parallel for schedule(static)
   for (std::size_t chan_c_index = 0; chan_c_index < ms_2b.NumberOfChannels();
        chan_c_index += 1) {
     std::size_t chan_b_index = chan_c_index;
 
+    // Read ahead in schedule order (no-op for in-memory operators).
+    b.PrefetchTensorAtIndex(chan_b_index + 1);
+    c.PrefetchTensorAtIndex(chan_c_index + 1);
+
     const auto& chan_c = ms_2b.ChannelAtIndex(chan_c_index);
     const auto& chan_1 = chan_c.BraChannel1();
     const auto& chan_2 = chan_c.BraChannel2();
@@ -90,18 +101,18 @@ void EvaluateScalar122CommutatorWithFactor(const Scalar1BOperator& a,
     const auto chan_a_3_index = ms_1b.IndexOfChannelInModelSpace(chankey_a_3);
     const auto chan_a_4_index = ms_1b.IndexOfChannelInModelSpace(chankey_a_4);
 
-    auto& tensor_c = c.GetMutableTensorAtIndex(chan_c_index);
+    auto tensor_c = c.GetMutableTensorAtIndex(chan_c_index);
     const auto& tensor_b = b.GetTensorAtIndex(chan_b_index);
     const auto& tensor_a_1 = a.GetTensorAtIndex(chan_a_1_index);
     const auto& tensor_a_2 = a.GetTensorAtIndex(chan_a_2_index);
     const auto& tensor_a_3 = a.GetTensorAtIndex(chan_a_3_index);
     const auto& tensor_a_4 = a.GetTensorAtIndex(chan_a_4_index);
 
-    // Dims
-    const auto dim_1 = chan_1.size();
-    const auto dim_2 = chan_2.size();
-    const auto dim_3 = chan_3.size();
-    const auto dim_4 = chan_4.size();
+    // Dims (of the possibly e2max truncated channel)
+    const auto dim_1 = chan_c.BraDim1();
+    const auto dim_2 = chan_c.BraDim2();
+    const auto dim_3 = chan_c.KetDim1();
+    const auto dim_4 = chan_c.KetDim2();
 
     // These tensors contractions do not seem to work.
     // ntcl_engine.Contract(tensor_c, tensor_a_1, tensor_b,
@@ -137,6 +148,9 @@ void EvaluateScalar122CommutatorWithFactor(const Scalar1BOperator& a,
         }
       }
     }
+
+    b.EvictTensorAtIndex(chan_b_index);
+    c.EvictTensorAtIndex(chan_c_index);
   }
 
   for (std::size_t chan_c_index = 0; chan_c_index < ms_2b.NumberOfChannels();
@@ -145,6 +159,7 @@ void EvaluateScalar122CommutatorWithFactor(const Scalar1BOperator& a,
 
     imsrg::AntisymmetrizeOperatorInChannel(c, chankey_c);
   }
+  imsrg::ZeroStatesAboveE2Max(c);
 }
 
 void EvaluateScalar122CommutatorRefImplWithFactor(const Scalar1BOperator& a,
@@ -154,13 +169,22 @@ void EvaluateScalar122CommutatorRefImplWithFactor(const Scalar1BOperator& a,
   Expects(b.GetModelSpacePtr() == c.GetModelSpacePtr());
   Expects(c.Herm() == Hermiticity::CommutatorHermiticity(a.Herm(), b.Herm()));
 
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
   const auto& ms_1b = a.GetModelSpace();
   const auto& ms_2b = b.GetModelSpace();
 
+#pragma omp parallel for schedule(static)
   for (std::size_t chan_c_index = 0; chan_c_index < ms_2b.NumberOfChannels();
        chan_c_index += 1) {
     std::size_t chan_b_index = chan_c_index;
 
+    // Read ahead in schedule order (no-op for in-memory operators).
+    b.PrefetchTensorAtIndex(chan_b_index + 1);
+    c.PrefetchTensorAtIndex(chan_c_index + 1);
+
     const auto& chan_c = ms_2b.ChannelAtIndex(chan_c_index);
     const auto& chan_1 = chan_c.BraChannel1();
     const auto& chan_2 = chan_c.BraChannel2();
@@ -184,18 +208,18 @@ void EvaluateScalar122CommutatorRefImplWithFactor(const Scalar1BOperator& a,
     const auto chan_a_3_index = ms_1b.IndexOfChannelInModelSpace(chankey_a_3);
     const auto chan_a_4_index = ms_1b.IndexOfChannelInModelSpace(chankey_a_4);
 
-    auto& tensor_c = c.GetMutableTensorAtIndex(chan_c_index);
+    auto tensor_c = c.GetMutableTensorAtIndex(chan_c_index);
     const auto& tensor_b = b.GetTensorAtIndex(chan_b_index);
     const auto& tensor_a_1 = a.GetTensorAtIndex(chan_a_1_index);
     const auto& tensor_a_2 = a.GetTensorAtIndex(chan_a_2_index);
     const auto& tensor_a_3 = a.GetTensorAtIndex(chan_a_3_index);
     const auto& tensor_a_4 = a.GetTensorAtIndex(chan_a_4_index);
 
-    // Dims
-    const auto dim_1 = chan_1.size();
-    const auto dim_2 = chan_2.size();
-    const auto dim_3 = chan_3.size();
-    const auto dim_4 = chan_4.size();
+    // Dims (of the possibly e2max truncated channel)
+    const auto dim_1 = chan_c.BraDim1();
+    const auto dim_2 = chan_c.BraDim2();
+    const auto dim_3 = chan_c.KetDim1();
+    const auto dim_4 = chan_c.KetDim2();
 
     for (std::size_t i1 = 0; i1 < dim_1; i1 += 1) {
       for (std::size_t i2 = 0; i2 < dim_2; i2 += 1) {
@@ -221,7 +245,11 @@ void EvaluateScalar122CommutatorRefImplWithFactor(const Scalar1BOperator& a,
         }
       }
     }
+
+    b.EvictTensorAtIndex(chan_b_index);
+    c.EvictTensorAtIndex(chan_c_index);
   }
+  imsrg::ZeroStatesAboveE2Max(c);
 }
 
 }  // namespace detail
@@ -7,6 +7,8 @@
 
 #include "imsrg/assert.h"
 #include "imsrg/model_space/scalar/two_body/channel_key.h"
+#include "imsrg/openmp_runtime.h"
+#include "imsrg/operator/scalar/two_body/compact_operator.h"
 #include "imsrg/operator/scalar/two_body/operator.h"
 #include "imsrg/quantum_numbers/coupling/factors.h"
 
@@ -17,7 +19,13 @@ static ntcl::FArray<double, 4> WeightMatrixElementsWithOccs(
     const std::vector<double>& occs_p, const std::vector<double>& occs_q,
     const std::vector<double>& occs_r, const std::vector<double>& occs_s,
     const ntcl::FArray<double, 4>& tensor);
-}
+
+// Channel loop of the reference implementation, shared by Scalar2BOperator
+// and Scalar2BCompactOperator. Tensors of OpA and OpB are read as
+// tensor(p, q, r, s) (converted to double for compact operators).
+template <typename OpA, typename OpB>
+static double EvaluateScalar220CommutatorLoop(const OpA& a, const OpB& b);
+}  // namespace detail
 
 double EvaluateScalar220Commutator(const Scalar2BOperator& a,
                                    const Scalar2BOperator& b) {
@@ -78,16 +86,46 @@ double EvaluateScalar220Commutator(const Scalar2BOperator& a,
 // Evaluates scalar [2, 2] -> 0 commutator.
 double EvaluateScalar220CommutatorRefImpl(const Scalar2BOperator& a,
                                           const Scalar2BOperator& b) {
+  return imsrg::detail::EvaluateScalar220CommutatorLoop(a, b);
+}
+
+template <typename TA, typename TB>
+double EvaluateScalar220Commutator(const Scalar2BCompactOperator<TA>& a,
+                                   const Scalar2BCompactOperator<TB>& b) {
+  return imsrg::detail::EvaluateScalar220CommutatorLoop(a, b);
+}
+
+template double EvaluateScalar220Commutator(
+    const Scalar2BCompactOperator<float>& a,
+    const Scalar2BCompactOperator<float>& b);
+template double EvaluateScalar220Commutator(
+    const Scalar2BCompactOperator<float>& a,
+    const Scalar2BCompactOperator<BFloat16>& b);
+template double EvaluateScalar220Commutator(
+    const Scalar2BCompactOperator<BFloat16>& a,
+    const Scalar2BCompactOperator<float>& b);
+template double EvaluateScalar220Commutator(
+    const Scalar2BCompactOperator<BFloat16>& a,
+    const Scalar2BCompactOperator<BFloat16>& b);
+
+namespace detail {
+template <typename OpA, typename OpB>
+double EvaluateScalar220CommutatorLoop(const OpA& a, const OpB& b) {
   Expects(a.GetModelSpacePtr() == b.GetModelSpacePtr());
 
   if (a.Herm() == b.Herm()) {
     return 0.0;
   }
 
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
   const auto& ms_2b = a.GetModelSpace();
 
   double val = 0.0;
 
+#pragma omp parallel for schedule(static) reduction(+ : val)
   for (std::size_t chan_a_index = 0; chan_a_index < ms_2b.NumberOfChannels();
        chan_a_index += 1) {
     const auto& chan_a = ms_2b.ChannelAtIndex(chan_a_index);
@@ -101,14 +139,14 @@ double EvaluateScalar220CommutatorRefImpl(const Scalar2BOperator& a,
     double factor = 0.25 * imsrg::HatSquared(jj_2b);
 
     // Tensors
-    const auto& tensor_a = a.GetTensorAtIndex(chan_a_index);
-    const auto& tensor_b = b.GetTensorAtIndex(chan_b_index);
+    const auto tensor_a = a.GetTensorAtIndex(chan_a_index);
+    const auto tensor_b = b.GetTensorAtIndex(chan_b_index);
 
     // Dims
-    const auto dim_p = chan_a.BraChannel1().size();
-    const auto dim_q = chan_a.BraChannel2().size();
-    const auto dim_r = chan_a.KetChannel1().size();
-    const auto dim_s = chan_a.KetChannel2().size();
+    const auto dim_p = chan_a.BraDim1();
+    const auto dim_q = chan_a.BraDim2();
+    const auto dim_r = chan_a.KetDim1();
+    const auto dim_s = chan_a.KetDim2();
 
     // Occs
     const auto& occs_p = chan_a.BraChannel1().ChannelBasis().Occs();
@@ -122,14 +160,15 @@ double EvaluateScalar220CommutatorRefImpl(const Scalar2BOperator& a,
 
     double interm_val = 0.0;
 
-    for (std::size_t p = 0; p < dim_p; p += 1) {
-      for (std::size_t q = 0; q < dim_q; q += 1) {
-        for (std::size_t r = 0; r < dim_r; r += 1) {
-          for (std::size_t s = 0; s < dim_s; s += 1) {
-            interm_val += occs_p[p] * occs_q[q] * occsbar_r[r] * occsbar_s[s] *
-                          tensor_a(p, q, r, s) * tensor_b(r, s, p, q);
-            interm_val -= occsbar_p[p] * occsbar_q[q] * occs_r[r] * occs_s[s] *
-                          tensor_a(p, q, r, s) * tensor_b(r, s, p, q);
+    for (std::size_t s = 0; s < dim_s; s += 1) {
+      for (std::size_t r = 0; r < dim_r; r += 1) {
+        for (std::size_t q = 0; q < dim_q; q += 1) {
+          for (std::size_t p = 0; p < dim_p; p += 1) {
+            const double occ_factor =
+                occs_p[p] * occs_q[q] * occsbar_r[r] * occsbar_s[s] -
+                occsbar_p[p] * occsbar_q[q] * occs_r[r] * occs_s[s];
+            interm_val +=
+                occ_factor * tensor_a(p, q, r, s) * tensor_b(r, s, p, q);
           }
         }
       }
@@ -141,22 +180,22 @@ double EvaluateScalar220CommutatorRefImpl(const Scalar2BOperator& a,
   return val;
 }
 
-namespace detail {
 ntcl::FArray<double, 4> WeightMatrixElementsWithOccs(
     const std::vector<double>& occs_p, const std::vector<double>& occs_q,
     const std::vector<double>& occs_r, const std::vector<double>& occs_s,
     const ntcl::FArray<double, 4>& tensor) {
-  Expects(occs_p.size() == tensor.dim_size(0));
-  Expects(occs_q.size() == tensor.dim_size(1));
-  Expects(occs_r.size() == tensor.dim_size(2));
-  Expects(occs_s.size() == tensor.dim_size(3));
+  // Tensors of e2max truncated channels only cover the leading states.
+  Expects(occs_p.size() >= tensor.dim_size(0));
+  Expects(occs_q.size() >= tensor.dim_size(1));
+  Expects(occs_r.size() >= tensor.dim_size(2));
+  Expects(occs_s.size() >= tensor.dim_size(3));
 
   ntcl::FArray<double, 4> new_tensor(tensor);
 
-  for (std::size_t p = 0; p < occs_p.size(); p += 1) {
-    for (std::size_t q = 0; q < occs_q.size(); q += 1) {
-      for (std::size_t r = 0; r < occs_r.size(); r += 1) {
-        for (std::size_t s = 0; s < occs_s.size(); s += 1) {
+  for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+    for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+      for (std::size_t r = 0; r < tensor.dim_size(2); r += 1) {
+        for (std::size_t s = 0; s < tensor.dim_size(3); s += 1) {
           new_tensor(p, q, r, s) *=
               occs_p[p] * occs_q[q] * occs_r[r] * occs_s[s];
         }
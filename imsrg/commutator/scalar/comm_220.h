@@ -2,6 +2,7 @@
 #ifndef IMSRG_COMMUTATOR_SCALAR_COMM_220_H_
 #define IMSRG_COMMUTATOR_SCALAR_COMM_220_H_
 
+#include "imsrg/operator/scalar/two_body/compact_operator.h"
 #include "imsrg/operator/scalar/two_body/operator.h"
 
 namespace imsrg {
@@ -12,6 +13,12 @@ double EvaluateScalar220Commutator(const Scalar2BOperator& a,
 // Evaluates scalar [2, 2] -> 0 commutator.
 double EvaluateScalar220CommutatorRefImpl(const Scalar2BOperator& a,
                                           const Scalar2BOperator& b);
+
+// Evaluates scalar [2, 2] -> 0 commutator for operators stored in reduced
+// precision (TA, TB = float or BFloat16), accumulating in double.
+template <typename TA, typename TB>
+double EvaluateScalar220Commutator(const Scalar2BCompactOperator<TA>& a,
+                                   const Scalar2BCompactOperator<TB>& b);
 }  // namespace imsrg
 
 #endif  // IMSRG_COMMUTATOR_SCALAR_COMM_220_H_
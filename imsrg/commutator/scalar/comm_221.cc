@@ -6,6 +6,7 @@
 #include "ntcl/algorithms/easy_tensor_contraction_interface_cbind.h"
 
 #include "imsrg/assert.h"
+#include "imsrg/commutator/scalar/leading_block.h"
 #include "imsrg/model_space/scalar/one_body/channel_key.h"
 #include "imsrg/operator/scalar/one_body/operator.h"
 #include "imsrg/operator/scalar/two_body/operator.h"
@@ -51,7 +52,12 @@ void EvaluateScalar221Commutator(const Scalar2BOperator& a,
     // Tensors
     const auto& tensor_a_1rpq = a.GetTensorAtIndex(chan_1rpq_index);
     const auto& tensor_b_1rpq = b.GetTensorAtIndex(chan_1rpq_index);
-    auto& tensor_c = c.GetMutableTensorAtIndex(chan_c_index);
+    auto& tensor_c_full = c.GetMutableTensorAtIndex(chan_c_index);
+
+    // The channel only covers the leading states of an e2max truncated SP
+    // channel 1, so it contributes to the leading block of C.
+    const auto dim_1 = chan_1rpq.BraDim1();
+    auto tensor_c = imsrg::LeadingBlock(tensor_c_full, dim_1, dim_1);
 
     // Occs
     const auto& occs_p = chan_1rpq.KetChannel1().ChannelBasis().Occs();
@@ -83,6 +89,8 @@ void EvaluateScalar221Commutator(const Scalar2BOperator& a,
                          "C(i,j)=A(i,r,p,q)*B(j,r,p,q)", -1 * factor_a, 1.0);
     ntcl_engine.Contract(tensor_c, tensor_b_1rpq_n_n_nbar, tensor_a_1rpq,
                          "C(i,j)=A(i,r,p,q)*B(j,r,p,q)", -1 * factor_a, 1.0);
+
+    imsrg::SetLeadingBlock(tensor_c, tensor_c_full);
   }
 }
 
@@ -131,11 +139,11 @@ void EvaluateScalar221CommutatorRefImpl(const Scalar2BOperator& a,
     const auto& occsbar_r = chan_1rpq.BraChannel2().ChannelBasis().OccsBar();
 
     // Dims
-    const auto dim_1 = chan_1rpq.BraChannel1().size();
-    const auto dim_2 = chan_1rpq.BraChannel1().size();
-    const auto dim_r = chan_1rpq.BraChannel2().size();
-    const auto dim_p = chan_1rpq.KetChannel1().size();
-    const auto dim_q = chan_1rpq.KetChannel2().size();
+    const auto dim_1 = chan_1rpq.BraDim1();
+    const auto dim_2 = chan_1rpq.BraDim1();
+    const auto dim_r = chan_1rpq.BraDim2();
+    const auto dim_p = chan_1rpq.KetDim1();
+    const auto dim_q = chan_1rpq.KetDim2();
 
     for (std::size_t i1 = 0; i1 < dim_1; i1 += 1) {
       for (std::size_t i2 = 0; i2 < dim_2; i2 += 1) {
@@ -166,16 +174,17 @@ namespace detail {
 ntcl::FArray<double, 4> WeightMatrixElementsWithOccs(
     const std::vector<double>& occs_p, const std::vector<double>& occs_q,
     const std::vector<double>& occs_r, const ntcl::FArray<double, 4>& tensor) {
-  Expects(occs_p.size() == tensor.dim_size(2));
-  Expects(occs_q.size() == tensor.dim_size(3));
-  Expects(occs_r.size() == tensor.dim_size(1));
+  // Tensors of e2max truncated channels only cover the leading states.
+  Expects(occs_p.size() >= tensor.dim_size(2));
+  Expects(occs_q.size() >= tensor.dim_size(3));
+  Expects(occs_r.size() >= tensor.dim_size(1));
 
   ntcl::FArray<double, 4> new_tensor(tensor);
 
   for (std::size_t i1 = 0; i1 < tensor.dim_size(0); i1 += 1) {
-    for (std::size_t r = 0; r < occs_r.size(); r += 1) {
-      for (std::size_t p = 0; p < occs_p.size(); p += 1) {
-        for (std::size_t q = 0; q < occs_q.size(); q += 1) {
+    for (std::size_t r = 0; r < tensor.dim_size(1); r += 1) {
+      for (std::size_t p = 0; p < tensor.dim_size(2); p += 1) {
+        for (std::size_t q = 0; q < tensor.dim_size(3); q += 1) {
           new_tensor(i1, r, p, q) *= occs_p[p] * occs_q[q] * occs_r[r];
         }
       }
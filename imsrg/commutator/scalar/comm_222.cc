@@ -1,16 +1,20 @@
 // Copyright 2022 Matthias Heinz
 #include "imsrg/commutator/scalar/comm_222.h"
 
+#include <array>
 #include <vector>
 
 #include "ntcl/algorithms/easy_tensor_contraction_interface_cbind.h"
 #include "ntcl/data/f_array.h"
 
+#include "imsrg/model_space/scalar/two_body/bare_channel_key.h"
 #include "imsrg/model_space/scalar/two_body/channel_key.h"
+#include "imsrg/model_space/scalar/two_body/model_space.h"
+#include "imsrg/model_space/scalar/two_body/state_channel_key.h"
 #include "imsrg/openmp_runtime.h"
 #include "imsrg/operator/scalar/two_body/antisymmetry.h"
 #include "imsrg/operator/scalar/two_body/operator.h"
-#include "imsrg/quantum_numbers/coupling/wigner_symbols.h"
+#include "imsrg/operator/scalar/two_body/truncation.h"
 #include "imsrg/quantum_numbers/hermiticity.h"
 
 namespace imsrg {
@@ -40,6 +44,25 @@ static void Scalar222CommutatorDirectTermRefImplCorePreweighted(
 static ntcl::FArray<double, 4> WeightTensorWithOccupations(
     const std::vector<double>& occs_p, const std::vector<double>& occs_q,
     const ntcl::FArray<double, 4>& tensor_pq12);
+
+// Indices of the channels (pq, 12) and (pq, 34) read for channel (12, 34).
+static std::array<std::size_t, 2> DirectTermChannelIndices(
+    const Scalar2BModelSpace& ms_2b, Scalar2BStateChannelKey state_chankey_pq,
+    Scalar2BChannelKey chankey_c);
+
+// Out-of-core hints for the channels of a and b read by one (pq) term of
+// the direct term. No-ops for in-memory operators.
+static void PrefetchDirectTermTensors(const Scalar2BOperator& a,
+                                      const Scalar2BOperator& b,
+                                      std::array<std::size_t, 2> chan_indices);
+static void EvictDirectTermTensors(const Scalar2BOperator& a,
+                                   const Scalar2BOperator& b,
+                                   std::array<std::size_t, 2> chan_indices);
+
+// Evicts the channels of op with single-particle channels sp_chankeys (all
+// J). No-op for in-memory operators.
+static void EvictTensorsInBareChannel(const Scalar2BOperator& op,
+                                      Scalar2BBareChannelKey sp_chankeys);
 }  // namespace detail
 
 void EvaluateScalar222Commutator(const Scalar2BOperator& a,
@@ -47,6 +70,7 @@ void EvaluateScalar222Commutator(const Scalar2BOperator& a,
                                  Scalar2BOperator& c) {
   imsrg::detail::EvaluateScalar222CommutatorDirectTermNTCLImpl(a, b, c);
   imsrg::detail::EvaluateScalar222CommutatorPandyaTermRefImpl(a, b, c);
+  imsrg::ZeroStatesAboveE2Max(c);
 }
 
 // Evaluates scalar [2, 2] -> 2 commutator.
@@ -55,6 +79,7 @@ void EvaluateScalar222CommutatorRefImpl(const Scalar2BOperator& a,
                                         Scalar2BOperator& c) {
   imsrg::detail::EvaluateScalar222CommutatorDirectTermRefImpl(a, b, c);
   imsrg::detail::EvaluateScalar222CommutatorPandyaTermRefImpl(a, b, c);
+  imsrg::ZeroStatesAboveE2Max(c);
 }
 
 namespace detail {
@@ -74,28 +99,36 @@ void EvaluateScalar222CommutatorDirectTermNTCLImpl(const Scalar2BOperator& a,
 
   const auto& ms_2b = a.GetModelSpace();
 
+  const bool out_of_core = a.IsOutOfCore() || b.IsOutOfCore();
+
+  // Static schedule matches first-touch placement in Scalar2BOperator.
+#pragma omp parallel for schedule(static)
   for (std::size_t chan_c_index = 0; chan_c_index < ms_2b.NumberOfChannels();
        chan_c_index += 1) {
+    // Read ahead in schedule order (no-op for in-memory operators).
+    c.PrefetchTensorAtIndex(chan_c_index + 1);
+
     const auto chankey_c = ms_2b.ChannelAtIndex(chan_c_index).ChannelKey();
     const auto op_chan = chankey_c.OpChannel();
-    const auto state_chankey_12 = chankey_c.BraChannelKey();
-    const auto state_chankey_34 = chankey_c.KetChannelKey();
 
-    auto& tensor_c = c.GetMutableTensorAtIndex(chan_c_index);
+    auto tensor_c = c.GetMutableTensorAtIndex(chan_c_index);
 
     const auto& state_chankeys_pq =
         ms_2b.GetStateChannelsInOperatorChannel(op_chan);
 
-    for (const auto& state_chankey_pq : state_chankeys_pq) {
-      const imsrg::Scalar2BChannelKey chankey_pq12(
-          state_chankey_pq, state_chankey_12, op_chan.JJ());
-      const imsrg::Scalar2BChannelKey chankey_pq34(
-          state_chankey_pq, state_chankey_34, op_chan.JJ());
-
-      const auto chan_pq12_index =
-          ms_2b.IndexOfChannelInModelSpace(chankey_pq12);
-      const auto chan_pq34_index =
-          ms_2b.IndexOfChannelInModelSpace(chankey_pq34);
+    for (std::size_t pq_index = 0; pq_index < state_chankeys_pq.size();
+         pq_index += 1) {
+      const auto chan_indices = DirectTermChannelIndices(
+          ms_2b, state_chankeys_pq[pq_index], chankey_c);
+      const auto chan_pq12_index = chan_indices[0];
+      const auto chan_pq34_index = chan_indices[1];
+
+      if (out_of_core && (pq_index + 1 < state_chankeys_pq.size())) {
+        PrefetchDirectTermTensors(
+            a, b,
+            DirectTermChannelIndices(ms_2b, state_chankeys_pq[pq_index + 1],
+                                     chankey_c));
+      }
 
       // Occs
       const auto& occs_p = ms_2b.ChannelAtIndex(chan_pq12_index)
@@ -146,7 +179,11 @@ void EvaluateScalar222CommutatorDirectTermNTCLImpl(const Scalar2BOperator& a,
           tensor_a_pq12_n_n, tensor_b_pq34, tensor_c, -0.5 * a.Herm().Factor());
       Scalar222CommutatorDirectTermRefImplCorePreweighted(
           tensor_b_pq12_n_n, tensor_a_pq34, tensor_c, 0.5 * b.Herm().Factor());
+
+      EvictDirectTermTensors(a, b, chan_indices);
     }
+
+    c.EvictTensorAtIndex(chan_c_index);
   }
 }
 
@@ -163,29 +200,36 @@ void EvaluateScalar222CommutatorDirectTermRefImpl(const Scalar2BOperator& a,
 
   const auto& ms_2b = a.GetModelSpace();
 
-#pragma omp parallel for schedule(dynamic, 100)
+  const bool out_of_core = a.IsOutOfCore() || b.IsOutOfCore();
+
+  // Static schedule matches first-touch placement in Scalar2BOperator.
+#pragma omp parallel for schedule(static)
   for (std::size_t chan_c_index = 0; chan_c_index < ms_2b.NumberOfChannels();
        chan_c_index += 1) {
+    // Read ahead in schedule order (no-op for in-memory operators).
+    c.PrefetchTensorAtIndex(chan_c_index + 1);
+
     const auto chankey_c = ms_2b.ChannelAtIndex(chan_c_index).ChannelKey();
     const auto op_chan = chankey_c.OpChannel();
-    const auto state_chankey_12 = chankey_c.BraChannelKey();
-    const auto state_chankey_34 = chankey_c.KetChannelKey();
 
-    auto& tensor_c = c.GetMutableTensorAtIndex(chan_c_index);
+    auto tensor_c = c.GetMutableTensorAtIndex(chan_c_index);
 
     const auto& state_chankeys_pq =
         ms_2b.GetStateChannelsInOperatorChannel(op_chan);
 
-    for (const auto& state_chankey_pq : state_chankeys_pq) {
-      const imsrg::Scalar2BChannelKey chankey_pq12(
-          state_chankey_pq, state_chankey_12, op_chan.JJ());
-      const imsrg::Scalar2BChannelKey chankey_pq34(
-          state_chankey_pq, state_chankey_34, op_chan.JJ());
-
-      const auto chan_pq12_index =
-          ms_2b.IndexOfChannelInModelSpace(chankey_pq12);
-      const auto chan_pq34_index =
-          ms_2b.IndexOfChannelInModelSpace(chankey_pq34);
+    for (std::size_t pq_index = 0; pq_index < state_chankeys_pq.size();
+         pq_index += 1) {
+      const auto chan_indices = DirectTermChannelIndices(
+          ms_2b, state_chankeys_pq[pq_index], chankey_c);
+      const auto chan_pq12_index = chan_indices[0];
+      const auto chan_pq34_index = chan_indices[1];
+
+      if (out_of_core && (pq_index + 1 < state_chankeys_pq.size())) {
+        PrefetchDirectTermTensors(
+            a, b,
+            DirectTermChannelIndices(ms_2b, state_chankeys_pq[pq_index + 1],
+                                     chankey_c));
+      }
 
       // Occs
       const auto& occs_p = ms_2b.ChannelAtIndex(chan_pq12_index)
@@ -223,7 +267,11 @@ void EvaluateScalar222CommutatorDirectTermRefImpl(const Scalar2BOperator& a,
       Scalar222CommutatorDirectTermRefImplCore(occs_p, occs_q, tensor_b_pq12,
                                                tensor_a_pq34, tensor_c,
                                                0.5 * b.Herm().Factor());
+
+      EvictDirectTermTensors(a, b, chan_indices);
     }
+
+    c.EvictTensorAtIndex(chan_c_index);
   }
 }
 
@@ -237,15 +285,18 @@ void EvaluateScalar222CommutatorPandyaTermRefImpl(const Scalar2BOperator& a,
   if (!imsrg::OpenMPRuntime::IsInitialized()) {
     imsrg::OpenMPRuntime::InitializeRuntime();
   }
-  imsrg::WignerSymbolEngine::GetInstance();
 
   const auto& ms_2b = a.GetModelSpace();
   const auto& sp_ms = ms_2b.SingleParticleModelSpace();
   const auto& bare_channels = ms_2b.BareChannels();
+  const auto& pandya_table = ms_2b.PandyaChannelTable();
 
   const int factor = 4 * b.Herm().Factor();
 
-#pragma omp parallel for schedule(dynamic, 100)
+  // Iteration i adds to the c channels of bare_channels[i] only, and the
+  // static schedule hands each thread the same contiguous block of bare
+  // channels on every call, so the pages of c it writes stay with it.
+#pragma omp parallel for schedule(static)
   for (std::size_t i = 0; i < bare_channels.size(); i += 1) {
     const auto pandya_bare_chan =
         imsrg::BareChannelKeyPandyaSwap(bare_channels[i]);
@@ -256,16 +307,13 @@ void EvaluateScalar222CommutatorPandyaTermRefImpl(const Scalar2BOperator& a,
     const auto dim_3 = sp_ms.ChannelDim(chan_3);
     const auto dim_4 = sp_ms.ChannelDim(chan_4);
 
-    const auto pandya_chans = imsrg::GeneratePandyaChannels(pandya_bare_chan);
-    for (const auto pandya_chan : pandya_chans) {
+    for (const auto& pandya_chan : pandya_table.PandyaChannels(i)) {
       ntcl::FArray<double, 4> tensor_c(dim_1, dim_4, dim_3, dim_2);
 
-      const auto op_chan = pandya_chan.OperatorChannel();
-
-      const auto& state_chankeys_pq =
-          ms_2b.GetStateChannelsInPandyaOperatorChannel(op_chan);
+      const auto op_chan = pandya_chan.chankey.OperatorChannel();
 
-      for (const auto [chan_p, chan_q] : state_chankeys_pq) {
+      for (const auto [chan_p, chan_q] :
+           pandya_table.StateChannels(pandya_chan.op_chan_index)) {
         const auto& occs_p = sp_ms.Occs(chan_p);
         const auto& occsbar_p = sp_ms.OccsBar(chan_p);
         const auto& occs_q = sp_ms.Occs(chan_q);
@@ -281,6 +329,11 @@ void EvaluateScalar222CommutatorPandyaTermRefImpl(const Scalar2BOperator& a,
 
         const auto tensor_a = a.GeneratePandyaTensorInPandyaChannel(a_chankey);
         const auto tensor_b = b.GeneratePandyaTensorInPandyaChannel(b_chankey);
+        // Pandya tensors are copies, their standard channels can go.
+        EvictTensorsInBareChannel(a, imsrg::BareChannelKeyPandyaSwap(
+                                         a_chankey.SingleParticleChannels()));
+        EvictTensorsInBareChannel(b, imsrg::BareChannelKeyPandyaSwap(
+                                         b_chankey.SingleParticleChannels()));
 
         for (std::size_t i2 = 0; i2 < dim_2; i2 += 1) {
           for (std::size_t i3 = 0; i3 < dim_3; i3 += 1) {
@@ -304,6 +357,9 @@ void EvaluateScalar222CommutatorPandyaTermRefImpl(const Scalar2BOperator& a,
 
       c.AddPandyaTensor(pandya_chan, tensor_c, factor);
     }
+
+    // All Pandya channels of this bare channel add to the same channels of c.
+    EvictTensorsInBareChannel(c, bare_channels[i]);
   }
 
   for (std::size_t chan_c_index = 0; chan_c_index < ms_2b.NumberOfChannels();
@@ -323,8 +379,9 @@ void Scalar222CommutatorDirectTermRefImplCore(
   const auto dim_i2 = tensor_1234.dim_size(1);
   const auto dim_i3 = tensor_1234.dim_size(2);
   const auto dim_i4 = tensor_1234.dim_size(3);
-  const auto dim_p = occs_p.size();
-  const auto dim_q = occs_q.size();
+  // Only the leading states of e2max truncated channels
+  const auto dim_p = tensor_pq12.dim_size(0);
+  const auto dim_q = tensor_pq12.dim_size(1);
 
   for (std::size_t i4 = 0; i4 < dim_i4; i4 += 1) {
     for (std::size_t i3 = 0; i3 < dim_i3; i3 += 1) {
@@ -377,8 +434,9 @@ ntcl::FArray<double, 4> WeightTensorWithOccupations(
     const ntcl::FArray<double, 4>& tensor_pq12) {
   const auto dim_i1 = tensor_pq12.dim_size(2);
   const auto dim_i2 = tensor_pq12.dim_size(3);
-  const auto dim_p = occs_p.size();
-  const auto dim_q = occs_q.size();
+  // Only the leading states of e2max truncated channels
+  const auto dim_p = tensor_pq12.dim_size(0);
+  const auto dim_q = tensor_pq12.dim_size(1);
 
   ntcl::FArray<double, 4> out(dim_p, dim_q, dim_i1, dim_i2);
 
@@ -393,5 +451,48 @@ ntcl::FArray<double, 4> WeightTensorWithOccupations(
   }
   return out;
 }
+
+std::array<std::size_t, 2> DirectTermChannelIndices(
+    const Scalar2BModelSpace& ms_2b, Scalar2BStateChannelKey state_chankey_pq,
+    Scalar2BChannelKey chankey_c) {
+  const auto op_chan = chankey_c.OpChannel();
+  const imsrg::Scalar2BChannelKey chankey_pq12(
+      state_chankey_pq, chankey_c.BraChannelKey(), op_chan.JJ());
+  const imsrg::Scalar2BChannelKey chankey_pq34(
+      state_chankey_pq, chankey_c.KetChannelKey(), op_chan.JJ());
+
+  return {ms_2b.IndexOfChannelInModelSpace(chankey_pq12),
+          ms_2b.IndexOfChannelInModelSpace(chankey_pq34)};
+}
+
+void PrefetchDirectTermTensors(const Scalar2BOperator& a,
+                               const Scalar2BOperator& b,
+                               std::array<std::size_t, 2> chan_indices) {
+  for (const auto index : chan_indices) {
+    a.PrefetchTensorAtIndex(index);
+    b.PrefetchTensorAtIndex(index);
+  }
+}
+
+void EvictDirectTermTensors(const Scalar2BOperator& a,
+                            const Scalar2BOperator& b,
+                            std::array<std::size_t, 2> chan_indices) {
+  for (const auto index : chan_indices) {
+    a.EvictTensorAtIndex(index);
+    b.EvictTensorAtIndex(index);
+  }
+}
+
+void EvictTensorsInBareChannel(const Scalar2BOperator& op,
+                               Scalar2BBareChannelKey sp_chankeys) {
+  if (!op.IsOutOfCore()) {
+    return;
+  }
+  const auto range =
+      op.GetModelSpace().ChannelIndexLookup().FindRange(sp_chankeys);
+  for (std::size_t i = 0; i < range.num_jj; i += 1) {
+    op.EvictTensorAtIndex(range.first_index + i);
+  }
+}
 }  // namespace detail
 }  // namespace imsrg
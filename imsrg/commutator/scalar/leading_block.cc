@@ -0,0 +1,27 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/commutator/scalar/leading_block.h"
+
+#include "ntcl/data/f_array.h"
+
+namespace imsrg {
+
+ntcl::FArray<double, 2> LeadingBlock(const ntcl::FArray<double, 2>& tensor,
+                                     std::size_t dim_0, std::size_t dim_1) {
+  ntcl::FArray<double, 2> block(dim_0, dim_1);
+  for (std::size_t j = 0; j < dim_1; j += 1) {
+    for (std::size_t i = 0; i < dim_0; i += 1) {
+      block(i, j) = tensor(i, j);
+    }
+  }
+  return block;
+}
+
+void SetLeadingBlock(const ntcl::FArray<double, 2>& block,
+                     ntcl::FArray<double, 2>& tensor) {
+  for (std::size_t j = 0; j < block.dim_size(1); j += 1) {
+    for (std::size_t i = 0; i < block.dim_size(0); i += 1) {
+      tensor(i, j) = block(i, j);
+    }
+  }
+}
+}  // namespace imsrg
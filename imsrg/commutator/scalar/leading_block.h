@@ -0,0 +1,20 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_COMMUTATOR_SCALAR_LEADING_BLOCK_H_
+#define IMSRG_COMMUTATOR_SCALAR_LEADING_BLOCK_H_
+
+#include "ntcl/data/f_array.h"
+
+namespace imsrg {
+// Leading blocks of 1B tensors, used to contract them with e2max truncated
+// 2B tensors that only cover the leading states of each SP channel.
+
+// Copy of tensor(0:dim_0, 0:dim_1)
+ntcl::FArray<double, 2> LeadingBlock(const ntcl::FArray<double, 2>& tensor,
+                                     std::size_t dim_0, std::size_t dim_1);
+
+// tensor(0:dim_0, 0:dim_1) = block
+void SetLeadingBlock(const ntcl::FArray<double, 2>& block,
+                     ntcl::FArray<double, 2>& tensor);
+}  // namespace imsrg
+
+#endif  // IMSRG_COMMUTATOR_SCALAR_LEADING_BLOCK_H_
@@ -0,0 +1,235 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/formats/helpers/binary.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fmt/core.h"
+
+#include "imsrg/assert.h"
+#include "imsrg/error.h"
+#include "imsrg/files/temporary_file.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+namespace imsrg {
+
+namespace mexj {
+
+namespace detail {
+// "IMSRGMEX"
+constexpr std::uint64_t kMEXJBinaryMagic = 0x58454D4753524D49;
+// Bump whenever the layout changes.
+constexpr std::uint32_t kMEXJBinaryVersion = 2;
+
+constexpr std::uint64_t kFNVOffsetBasis = 0xcbf29ce484222325;
+constexpr std::uint64_t kFNVPrime = 0x100000001b3;
+// Matrix elements per checksum chunk, fixed so the checksum does not depend
+// on the number of threads.
+constexpr std::size_t kChecksumChunkSize = 1 << 16;
+
+static std::uint64_t FNV1aOfWords(const std::uint64_t* words,
+                                  std::size_t num_words,
+                                  std::uint64_t hash = kFNVOffsetBasis);
+
+static const char* FormatName(MEXJBinaryFormat format);
+
+// Read-only private mapping of a whole file, unmapped on destruction.
+class MappedMEXJFile {
+ public:
+  explicit MappedMEXJFile(const std::string& path);
+  ~MappedMEXJFile();
+
+  MappedMEXJFile(const MappedMEXJFile&) = delete;
+  MappedMEXJFile& operator=(const MappedMEXJFile&) = delete;
+
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+}  // namespace detail
+
+MEArray MEArray::FromVector(std::vector<double>&& mes) {
+  auto owner = std::make_shared<const std::vector<double>>(std::move(mes));
+  const auto* data = owner->data();
+  const auto size = owner->size();
+  return MEArray(std::move(owner), data, size);
+}
+
+MEArray MEArray::FromSharedMemory(std::shared_ptr<const void>&& owner,
+                                  const double* data, std::size_t size) {
+  return MEArray(std::move(owner), data, size);
+}
+
+MEArray::MEArray(std::shared_ptr<const void>&& owner, const double* data,
+                 std::size_t size)
+    : owner_(std::move(owner)), data_(data), size_(size) {
+  Expects((data_ != nullptr) || (size_ == 0));
+}
+
+std::uint64_t MEChecksum(const double* mes, std::size_t num_mes) {
+  static_assert(sizeof(double) == sizeof(std::uint64_t),
+                "Matrix elements are hashed as 64-bit words.");
+  const auto* words = reinterpret_cast<const std::uint64_t*>(mes);
+  const std::size_t chunk_size = imsrg::mexj::detail::kChecksumChunkSize;
+  const std::size_t num_chunks = (num_mes + chunk_size - 1) / chunk_size;
+
+  std::vector<std::uint64_t> chunk_hashes(num_chunks);
+  // Also called per channel from parallel loops, where this runs serially.
+#pragma omp parallel for schedule(static) if (num_chunks > 1)
+  for (std::size_t chunk = 0; chunk < num_chunks; chunk += 1) {
+    const std::size_t begin = chunk * chunk_size;
+    const std::size_t end = std::min(begin + chunk_size, num_mes);
+    chunk_hashes[chunk] = imsrg::mexj::detail::FNV1aOfWords(words + begin,
+                                                            end - begin);
+  }
+  return imsrg::mexj::detail::FNV1aOfWords(chunk_hashes.data(), num_chunks);
+}
+
+void WriteMEXJBinaryFile(const std::string& path_to_file,
+                         MEXJBinaryFormat format, HOEnergy emax,
+                         Hermiticity herm, double me_0b, const double* mes,
+                         std::size_t num_mes) {
+  MEXJBinaryHeader header = {};
+  header.magic = imsrg::mexj::detail::kMEXJBinaryMagic;
+  header.version = imsrg::mexj::detail::kMEXJBinaryVersion;
+  header.format = static_cast<std::uint32_t>(format);
+  header.emax = emax.AsInt();
+  header.herm = herm.Factor();
+  header.num_mes = num_mes;
+  header.checksum = MEChecksum(mes, num_mes);
+  header.me_0b = me_0b;
+
+  const std::string tmp_path = imsrg::CreateTemporaryFileNextTo(path_to_file);
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(mes), num_mes * sizeof(double));
+    if (!file.good()) {
+      imsrg::RemoveTemporaryFile(tmp_path);
+      imsrg::Error(fmt::format("Failed to write binary {} file at {}",
+                               imsrg::mexj::detail::FormatName(format),
+                               tmp_path));
+    }
+  }
+  imsrg::CheckForError(
+      !imsrg::MoveTemporaryFileIntoPlace(tmp_path, path_to_file),
+      fmt::format("Failed to move binary {} file to {}",
+                  imsrg::mexj::detail::FormatName(format), path_to_file));
+}
+
+MEXJBinaryContents ReadMEXJBinaryFile(const std::string& path_to_file,
+                                      MEXJBinaryFormat format, HOEnergy emax,
+                                      Hermiticity herm, std::size_t num_mes) {
+  const auto* name = imsrg::mexj::detail::FormatName(format);
+  auto file = std::make_shared<const imsrg::mexj::detail::MappedMEXJFile>(
+      path_to_file);
+  imsrg::CheckForError(
+      file->data() == nullptr,
+      fmt::format("Failed to map binary {} file at {}", name, path_to_file));
+  imsrg::CheckForError(
+      file->size() < sizeof(MEXJBinaryHeader),
+      fmt::format("Binary {} file at {} is truncated.", name, path_to_file));
+
+  MEXJBinaryHeader header;
+  std::memcpy(&header, file->data(), sizeof(header));
+  imsrg::CheckForError(
+      (header.magic != imsrg::mexj::detail::kMEXJBinaryMagic) ||
+          (header.version != imsrg::mexj::detail::kMEXJBinaryVersion),
+      fmt::format("File at {} is not a binary matrix element file of version "
+                  "{}.",
+                  path_to_file, imsrg::mexj::detail::kMEXJBinaryVersion));
+  imsrg::CheckForError(
+      header.format != static_cast<std::uint32_t>(format),
+      fmt::format("File at {} is not a binary {} file.", path_to_file, name));
+  imsrg::CheckForError(
+      header.herm != herm.Factor(),
+      fmt::format("Binary {} file at {} has hermiticity {}, expected {}.",
+                  name, path_to_file, header.herm, herm.Factor()));
+  imsrg::CheckForError(
+      header.emax < emax.AsInt(),
+      fmt::format("Binary {} file at {} has emax = {}, expected at least {}.",
+                  name, path_to_file, header.emax, emax.AsInt()));
+  imsrg::CheckForError(
+      (header.num_mes < num_mes) ||
+          (file->size() !=
+           sizeof(MEXJBinaryHeader) + header.num_mes * sizeof(double)),
+      fmt::format("Binary {} file at {} has an invalid size.", name,
+                  path_to_file));
+
+  const auto* mes =
+      reinterpret_cast<const double*>(file->data() + sizeof(MEXJBinaryHeader));
+  imsrg::CheckForError(
+      MEChecksum(mes, header.num_mes) != header.checksum,
+      fmt::format("Checksum mismatch in binary {} file at {}.", name,
+                  path_to_file));
+
+  return {header.me_0b, MEArray::FromSharedMemory(std::move(file), mes,
+                                                  num_mes)};
+}
+
+namespace detail {
+std::uint64_t FNV1aOfWords(const std::uint64_t* words, std::size_t num_words,
+                           std::uint64_t hash) {
+  for (std::size_t i = 0; i < num_words; i += 1) {
+    hash ^= words[i];
+    hash *= kFNVPrime;
+  }
+  return hash;
+}
+
+const char* FormatName(MEXJBinaryFormat format) {
+  switch (format) {
+    case MEXJBinaryFormat::kME1J:
+      return "ME1J";
+    case MEXJBinaryFormat::kME2JP:
+      return "ME2JP";
+  }
+  return "MEXJ";
+}
+
+MappedMEXJFile::MappedMEXJFile(const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat file_stat;
+  if ((fstat(fd, &file_stat) != 0) || (file_stat.st_size <= 0)) {
+    close(fd);
+    return;
+  }
+  const auto size = static_cast<std::size_t>(file_stat.st_size);
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (map == MAP_FAILED) {
+    return;
+  }
+  data_ = static_cast<const char*>(map);
+  size_ = size;
+}
+
+MappedMEXJFile::~MappedMEXJFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+}  // namespace detail
+
+}  // namespace mexj
+
+}  // namespace imsrg
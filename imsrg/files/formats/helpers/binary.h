@@ -0,0 +1,104 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_FILES_FORMATS_HELPERS_BINARY_H_
+#define IMSRG_FILES_FORMATS_HELPERS_BINARY_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+namespace imsrg {
+
+namespace mexj {
+
+// Binary matrix element files (native byte order):
+//
+// MEXJBinaryHeader (64 B)
+// double x num_mes, in the order of the corresponding text format
+//
+// The zero-body part of ME1J files is stored in the header. The checksum is
+// computed by MEChecksum. Like the text formats,
+// a file for a larger emax starts with all matrix elements for a smaller
+// emax, so it can be read for any emax up to its own.
+struct MEXJBinaryHeader {
+  std::uint64_t magic;
+  std::uint32_t version;
+  std::uint32_t format;
+  std::int32_t emax;
+  std::int32_t herm;
+  std::uint64_t num_mes;
+  std::uint64_t checksum;
+  double me_0b;
+  std::uint64_t reserved[2];
+};
+static_assert(sizeof(MEXJBinaryHeader) == 64,
+              "MEXJBinaryHeader must keep the matrix elements 8 B aligned.");
+
+enum class MEXJBinaryFormat : std::uint32_t { kME1J = 1, kME2JP = 2 };
+
+// Read-only matrix elements, either owned or mapped from a binary file.
+// Copies share the underlying memory.
+class MEArray {
+ public:
+  static MEArray FromVector(std::vector<double>&& mes);
+
+  // size matrix elements at data, kept alive (e.g., mapped) by owner
+  static MEArray FromSharedMemory(std::shared_ptr<const void>&& owner,
+                                  const double* data, std::size_t size);
+
+  // Default copy, move, and dtor
+
+  const double* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  double operator[](std::size_t i) const { return data_[i]; }
+
+  void swap(MEArray& other) noexcept {
+    using std::swap;
+    swap(owner_, other.owner_);
+    swap(data_, other.data_);
+    swap(size_, other.size_);
+  }
+
+ private:
+  // Keeps the vector or the mapping alive
+  std::shared_ptr<const void> owner_;
+  const double* data_;
+  std::size_t size_;
+
+  explicit MEArray(std::shared_ptr<const void>&& owner, const double* data,
+                   std::size_t size);
+};
+
+inline void swap(MEArray& a, MEArray& b) noexcept { a.swap(b); }
+
+struct MEXJBinaryContents {
+  double me_0b;
+  MEArray mes;
+};
+
+// 64-bit FNV-1a hash of the matrix elements as 64-bit words, computed in
+// parallel over fixed chunks whose hashes are again hashed with FNV-1a.
+std::uint64_t MEChecksum(const double* mes, std::size_t num_mes);
+
+// Writes to a temporary file first, so readers never see a partial file.
+void WriteMEXJBinaryFile(const std::string& path_to_file,
+                         MEXJBinaryFormat format, HOEnergy emax,
+                         Hermiticity herm, double me_0b, const double* mes,
+                         std::size_t num_mes);
+
+// Maps the file and uses its matrix elements in place. Validates the header
+// (format, hermiticity, emax of the file at least emax, size) and the
+// checksum, and returns the first num_mes matrix elements.
+MEXJBinaryContents ReadMEXJBinaryFile(const std::string& path_to_file,
+                                      MEXJBinaryFormat format, HOEnergy emax,
+                                      Hermiticity herm, std::size_t num_mes);
+
+}  // namespace mexj
+
+}  // namespace imsrg
+
+#endif  // IMSRG_FILES_FORMATS_HELPERS_BINARY_H_
@@ -0,0 +1,154 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/formats/helpers/gzip.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "fmt/core.h"
+
+#include "imsrg/assert.h"
+#include "imsrg/error.h"
+
+namespace imsrg {
+
+namespace mexj {
+
+namespace detail {
+// Size of decompressed chunks
+constexpr std::size_t kGZipChunkSize = 1 << 20;
+// Number of decompressed chunks the background thread may run ahead
+constexpr std::size_t kGZipMaxQueuedChunks = 4;
+// Size of zlib's internal input buffer
+constexpr unsigned int kGZipBufferSize = 1 << 18;
+}  // namespace detail
+
+GZipStreamBuf::GZipStreamBuf(const std::string& path_to_file)
+    : file_(gzopen(path_to_file.c_str(), "rb")) {
+  if (file_ == nullptr) {
+    return;
+  }
+  gzbuffer(file_, imsrg::mexj::detail::kGZipBufferSize);
+  decompressor_ = std::thread(&GZipStreamBuf::Decompress, this);
+}
+
+GZipStreamBuf::~GZipStreamBuf() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  slot_free_.notify_all();
+  if (decompressor_.joinable()) {
+    decompressor_.join();
+  }
+  if (file_ != nullptr) {
+    gzclose(file_);
+  }
+}
+
+std::string GZipStreamBuf::Error() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return error_;
+}
+
+GZipStreamBuf::int_type GZipStreamBuf::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    chunk_ready_.wait(lock, [this] { return !chunks_.empty() || done_; });
+    if (chunks_.empty()) {
+      return traits_type::eof();
+    }
+    current_ = std::move(chunks_.front());
+    chunks_.pop_front();
+  }
+  slot_free_.notify_one();
+
+  setg(current_.data(), current_.data(), current_.data() + current_.size());
+  return traits_type::to_int_type(*gptr());
+}
+
+void GZipStreamBuf::Decompress() {
+  std::string error;
+  while (true) {
+    std::vector<char> chunk(imsrg::mexj::detail::kGZipChunkSize);
+    const int num_read = gzread(file_, chunk.data(),
+                                static_cast<unsigned int>(chunk.size()));
+    if (num_read < 0) {
+      int errnum = 0;
+      error = fmt::format("Failed to decompress file: {}",
+                          gzerror(file_, &errnum));
+      break;
+    }
+    if (num_read == 0) {
+      break;
+    }
+    chunk.resize(static_cast<std::size_t>(num_read));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    slot_free_.wait(lock, [this] {
+      return stop_ ||
+             (chunks_.size() < imsrg::mexj::detail::kGZipMaxQueuedChunks);
+    });
+    if (stop_) {
+      return;
+    }
+    chunks_.push_back(std::move(chunk));
+    lock.unlock();
+    chunk_ready_.notify_one();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+    error_ = std::move(error);
+  }
+  chunk_ready_.notify_all();
+}
+
+GZipFileWriter::GZipFileWriter(const std::string& path_to_file)
+    : path_(path_to_file), file_(gzopen(path_to_file.c_str(), "wb")) {
+  imsrg::CheckForError(
+      file_ == nullptr,
+      fmt::format("Failed to open gzipped file at {}", path_to_file));
+  gzbuffer(file_, imsrg::mexj::detail::kGZipBufferSize);
+}
+
+GZipFileWriter::~GZipFileWriter() {
+  if (file_ != nullptr) {
+    gzclose(file_);
+  }
+}
+
+void GZipFileWriter::Write(std::string_view text) {
+  Expects(file_ != nullptr);
+  while (!text.empty()) {
+    const auto size = static_cast<unsigned int>(std::min<std::size_t>(
+        text.size(), imsrg::mexj::detail::kGZipChunkSize));
+    imsrg::CheckForError(
+        gzwrite(file_, text.data(), size) != static_cast<int>(size),
+        fmt::format("Failed to write gzipped file at {}", path_));
+    text.remove_prefix(size);
+  }
+}
+
+void GZipFileWriter::Close() {
+  Expects(file_ != nullptr);
+  const int status = gzclose(file_);
+  file_ = nullptr;
+  imsrg::CheckForError(
+      status != Z_OK, fmt::format("Failed to close gzipped file at {}", path_));
+}
+
+}  // namespace mexj
+
+}  // namespace imsrg
@@ -0,0 +1,85 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_FILES_FORMATS_HELPERS_GZIP_H_
+#define IMSRG_FILES_FORMATS_HELPERS_GZIP_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// From zlib.h, which is only needed in the implementation.
+struct gzFile_s;
+
+namespace imsrg {
+
+namespace mexj {
+
+// Stream buffer over a gzipped (or plain) file that is decompressed on a
+// background thread, so decompression overlaps with parsing of the stream.
+//
+// Decompressed chunks are handed over through a bounded queue. Stopping early
+// (e.g., reading a smaller emax from a larger file) is fine: the destructor
+// stops and joins the background thread.
+class GZipStreamBuf : public std::streambuf {
+ public:
+  explicit GZipStreamBuf(const std::string& path_to_file);
+  ~GZipStreamBuf() override;
+
+  GZipStreamBuf(const GZipStreamBuf&) = delete;
+  GZipStreamBuf& operator=(const GZipStreamBuf&) = delete;
+
+  bool is_open() const { return file_ != nullptr; }
+
+  // Empty if no decompression error has occurred (so far).
+  std::string Error() const;
+
+ protected:
+  int_type underflow() override;
+
+ private:
+  gzFile_s* file_ = nullptr;
+
+  mutable std::mutex mutex_;
+  std::condition_variable chunk_ready_;
+  std::condition_variable slot_free_;
+  std::deque<std::vector<char>> chunks_;
+  bool done_ = false;
+  bool stop_ = false;
+  std::string error_;
+
+  // Chunk currently exposed through the get area
+  std::vector<char> current_;
+
+  std::thread decompressor_;
+
+  void Decompress();
+};
+
+// Writes a gzipped file. Throws if the file cannot be opened or written.
+class GZipFileWriter {
+ public:
+  explicit GZipFileWriter(const std::string& path_to_file);
+  ~GZipFileWriter();
+
+  GZipFileWriter(const GZipFileWriter&) = delete;
+  GZipFileWriter& operator=(const GZipFileWriter&) = delete;
+
+  void Write(std::string_view text);
+
+  // Flushes and closes the file, throws on failure.
+  void Close();
+
+ private:
+  std::string path_;
+  gzFile_s* file_ = nullptr;
+};
+
+}  // namespace mexj
+
+}  // namespace imsrg
+
+#endif  // IMSRG_FILES_FORMATS_HELPERS_GZIP_H_
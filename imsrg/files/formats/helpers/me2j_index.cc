@@ -0,0 +1,210 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/formats/helpers/me2j_index.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "imsrg/assert.h"
+#include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/orbital_ang_mom.h"
+#include "imsrg/quantum_numbers/total_ang_mom.h"
+
+namespace imsrg {
+
+namespace mexj {
+
+namespace detail {
+// Parity of pairs
+constexpr std::size_t kNumOrbitPairGroups = 2;
+// Group index of pairs not in the file
+constexpr std::uint32_t kExcludedOrbitPair = UINT32_MAX;
+
+struct OrbitPairJJRange {
+  int jj_min;
+  int jj_max;
+};
+
+static std::size_t OrbitPairIndex(std::size_t i, std::size_t j) {
+  return i * (i + 1) / 2 + j;
+}
+
+static bool IsOrbitPairInFile(const NLJJ& a, const NLJJ& b, HOEnergy e2max,
+                              OrbitalAngMom lmax) {
+  return (a.L() <= lmax) && (b.L() <= lmax) &&
+         (a.E().AsInt() + b.E().AsInt() <= e2max.AsInt());
+}
+
+static std::size_t OrbitPairGroup(const NLJJ& a, const NLJJ& b) {
+  return (a.P() + b.P()).IsEven() ? 0 : 1;
+}
+
+static OrbitPairJJRange OrbitPairRange(const NLJJ& a, const NLJJ& b);
+
+// Number of J values allowed for both ranges
+static std::uint32_t OrbitPairOverlapSize(OrbitPairJJRange a,
+                                          OrbitPairJJRange b);
+}  // namespace detail
+
+ME2JIndexTable ME2JIndexTable::FromEMaxE2MaxAndLMax(HOEnergy emax,
+                                                    HOEnergy e2max,
+                                                    OrbitalAngMom lmax) {
+  const auto basis = imsrg::mexj::GetNLJJs(emax);
+  const std::size_t num_orbits = basis.size();
+  const std::size_t num_pairs = num_orbits * (num_orbits + 1) / 2;
+
+  std::vector<std::uint32_t> pair_group_indices(num_pairs, 0);
+  std::vector<std::uint32_t> pair_row_classes(num_pairs, 0);
+
+  std::array<std::vector<imsrg::mexj::detail::OrbitPairJJRange>,
+             imsrg::mexj::detail::kNumOrbitPairGroups>
+      group_ranges;
+  // (group, jj_min, jj_max) -> row class
+  std::map<std::array<int, 3>, std::uint32_t> row_classes;
+  std::vector<std::array<int, 3>> row_class_keys;
+
+  // Pair indices are increasing in this loop, so pairs are in file order.
+  for (std::size_t i_a = 0; i_a < num_orbits; i_a += 1) {
+    for (std::size_t i_b = 0; i_b <= i_a; i_b += 1) {
+      const auto pair = imsrg::mexj::detail::OrbitPairIndex(i_a, i_b);
+      if (!imsrg::mexj::detail::IsOrbitPairInFile(basis[i_a], basis[i_b],
+                                                  e2max, lmax)) {
+        pair_group_indices[pair] = imsrg::mexj::detail::kExcludedOrbitPair;
+        continue;
+      }
+      const auto group =
+          imsrg::mexj::detail::OrbitPairGroup(basis[i_a], basis[i_b]);
+      const auto range =
+          imsrg::mexj::detail::OrbitPairRange(basis[i_a], basis[i_b]);
+
+      pair_group_indices[pair] =
+          static_cast<std::uint32_t>(group_ranges[group].size());
+      group_ranges[group].push_back(range);
+
+      const std::array<int, 3> key = {static_cast<int>(group), range.jj_min,
+                                      range.jj_max};
+      const auto [it, inserted] = row_classes.emplace(
+          key, static_cast<std::uint32_t>(row_class_keys.size()));
+      if (inserted) {
+        row_class_keys.push_back(key);
+      }
+      pair_row_classes[pair] = it->second;
+    }
+  }
+
+  std::vector<std::size_t> class_offsets;
+  class_offsets.reserve(row_class_keys.size());
+  std::vector<std::uint32_t> class_prefix_sums;
+  for (const auto& key : row_class_keys) {
+    const auto& ranges = group_ranges[static_cast<std::size_t>(key[0])];
+    const imsrg::mexj::detail::OrbitPairJJRange row_range = {key[1], key[2]};
+
+    class_offsets.push_back(class_prefix_sums.size());
+    std::uint32_t sum = 0;
+    class_prefix_sums.push_back(sum);
+    for (const auto& range : ranges) {
+      sum += imsrg::mexj::detail::OrbitPairOverlapSize(row_range, range);
+      class_prefix_sums.push_back(sum);
+    }
+  }
+
+  // Rows (a, b) contain the pairs of their group up to and including (a, b).
+  std::vector<std::size_t> row_offsets(num_pairs, 0);
+  std::size_t num_mes = 0;
+  for (std::size_t pair = 0; pair < num_pairs; pair += 1) {
+    row_offsets[pair] = num_mes;
+    if (pair_group_indices[pair] == imsrg::mexj::detail::kExcludedOrbitPair) {
+      continue;
+    }
+    num_mes += kNumIsospinMEs *
+               class_prefix_sums[class_offsets[pair_row_classes[pair]] +
+                                 pair_group_indices[pair] + 1];
+  }
+
+  return ME2JIndexTable(num_orbits, num_mes, std::move(row_offsets),
+                        std::move(pair_group_indices),
+                        std::move(pair_row_classes), std::move(class_offsets),
+                        std::move(class_prefix_sums));
+}
+
+ME2JIndexTable::ME2JIndexTable(
+    std::size_t num_orbits, std::size_t num_mes,
+    std::vector<std::size_t>&& row_offsets,
+    std::vector<std::uint32_t>&& pair_group_indices,
+    std::vector<std::uint32_t>&& pair_row_classes,
+    std::vector<std::size_t>&& class_offsets,
+    std::vector<std::uint32_t>&& class_prefix_sums)
+    : num_orbits_(num_orbits),
+      num_mes_(num_mes),
+      row_offsets_(std::move(row_offsets)),
+      pair_group_indices_(std::move(pair_group_indices)),
+      pair_row_classes_(std::move(pair_row_classes)),
+      class_offsets_(std::move(class_offsets)),
+      class_prefix_sums_(std::move(class_prefix_sums)) {
+  Expects(row_offsets_.size() == num_orbits_ * (num_orbits_ + 1) / 2);
+  Expects(pair_group_indices_.size() == row_offsets_.size());
+  Expects(pair_row_classes_.size() == row_offsets_.size());
+}
+
+std::size_t ME2JIndexTable::Offset(const NLJJ& a, const NLJJ& b,
+                                   const NLJJ& c, const NLJJ& d) const {
+  const auto i_a = a.Index().AsSizeT();
+  if (i_a >= num_orbits_) {
+    return npos;
+  }
+  if (imsrg::mexj::detail::OrbitPairGroup(a, b) !=
+      imsrg::mexj::detail::OrbitPairGroup(c, d)) {
+    return npos;
+  }
+
+  const auto pair_ab =
+      imsrg::mexj::detail::OrbitPairIndex(i_a, b.Index().AsSizeT());
+  const auto pair_cd = imsrg::mexj::detail::OrbitPairIndex(
+      c.Index().AsSizeT(), d.Index().AsSizeT());
+  if ((pair_group_indices_[pair_ab] ==
+       imsrg::mexj::detail::kExcludedOrbitPair) ||
+      (pair_group_indices_[pair_cd] ==
+       imsrg::mexj::detail::kExcludedOrbitPair)) {
+    return npos;
+  }
+  const auto* prefix_sums = class_prefix_sums_.data() +
+                            class_offsets_[pair_row_classes_[pair_ab]] +
+                            pair_group_indices_[pair_cd];
+  if (prefix_sums[0] == prefix_sums[1]) {
+    return npos;
+  }
+  return row_offsets_[pair_ab] + kNumIsospinMEs * prefix_sums[0];
+}
+
+std::size_t ME2JIndexTable::SizeInBytes() const {
+  return row_offsets_.size() * sizeof(std::size_t) +
+         pair_group_indices_.size() * sizeof(std::uint32_t) +
+         pair_row_classes_.size() * sizeof(std::uint32_t) +
+         class_offsets_.size() * sizeof(std::size_t) +
+         class_prefix_sums_.size() * sizeof(std::uint32_t);
+}
+
+namespace detail {
+OrbitPairJJRange OrbitPairRange(const NLJJ& a, const NLJJ& b) {
+  return {imsrg::CouplingMinimum<imsrg::TotalAngMom>(a.JJ(), b.JJ()).AsInt(),
+          imsrg::CouplingMaximum<imsrg::TotalAngMom>(a.JJ(), b.JJ()).AsInt()};
+}
+
+std::uint32_t OrbitPairOverlapSize(OrbitPairJJRange a, OrbitPairJJRange b) {
+  const int jj_min = std::max(a.jj_min, b.jj_min);
+  const int jj_max = std::min(a.jj_max, b.jj_max);
+  if (jj_max < jj_min) {
+    return 0;
+  }
+  return static_cast<std::uint32_t>((jj_max - jj_min) / 2 + 1);
+}
+}  // namespace detail
+
+}  // namespace mexj
+
+}  // namespace imsrg
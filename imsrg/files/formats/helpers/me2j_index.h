@@ -0,0 +1,88 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_FILES_FORMATS_HELPERS_ME2J_INDEX_H_
+#define IMSRG_FILES_FORMATS_HELPERS_ME2J_INDEX_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/orbital_ang_mom.h"
+
+namespace imsrg {
+
+namespace mexj {
+
+// Offsets of matrix elements in (isospin-coupled) me2j files, computed like
+// in ME2JPIndexTable.
+//
+// The file stores, for orbit pairs (a, b) with b <= a (rows) and (c, d) with
+// d <= c and (c, d) <= (a, b) (lexicographic), all J allowed for both pairs,
+// and for each J the 4 matrix elements T = 0 and T = 1 with T_z = -1, 0, 1.
+// Orbits with l > lmax and pairs with e_a + e_b > e2max are not in the file.
+class ME2JIndexTable {
+ public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  // Number of matrix elements per J
+  static constexpr std::size_t kNumIsospinMEs = 4;
+
+  static ME2JIndexTable FromEMaxE2MaxAndLMax(HOEnergy emax, HOEnergy e2max,
+                                             OrbitalAngMom lmax);
+
+  // Default copy, move, and dtor
+
+  std::size_t NumberOfMatrixElements() const { return num_mes_; }
+
+  // Offset of the T = 0 matrix element with the lowest allowed J for a, b, c,
+  // d with b <= a, d <= c, and (c, d) <= (a, b), npos if no matrix element
+  // is stored (orbits above emax or lmax, pairs above e2max, or broken
+  // symmetries).
+  std::size_t Offset(const NLJJ& a, const NLJJ& b, const NLJJ& c,
+                     const NLJJ& d) const;
+
+  std::size_t SizeInBytes() const;
+
+  void swap(ME2JIndexTable& other) noexcept {
+    using std::swap;
+    swap(num_orbits_, other.num_orbits_);
+    swap(num_mes_, other.num_mes_);
+    swap(row_offsets_, other.row_offsets_);
+    swap(pair_group_indices_, other.pair_group_indices_);
+    swap(pair_row_classes_, other.pair_row_classes_);
+    swap(class_offsets_, other.class_offsets_);
+    swap(class_prefix_sums_, other.class_prefix_sums_);
+  }
+
+ private:
+  std::size_t num_orbits_;
+  std::size_t num_mes_;
+  // Indexed by pair index a * (a + 1) / 2 + b:
+  // Offset of the first matrix element in row (a, b)
+  std::vector<std::size_t> row_offsets_;
+  // Index of pair among pairs of the same parity (a marker for pairs not in
+  // the file)
+  std::vector<std::uint32_t> pair_group_indices_;
+  // Row class of pair
+  std::vector<std::uint32_t> pair_row_classes_;
+  // Start of prefix sums of each row class in class_prefix_sums_
+  std::vector<std::size_t> class_offsets_;
+  // Number of J values in a row before pair with group index i
+  std::vector<std::uint32_t> class_prefix_sums_;
+
+  explicit ME2JIndexTable(std::size_t num_orbits, std::size_t num_mes,
+                          std::vector<std::size_t>&& row_offsets,
+                          std::vector<std::uint32_t>&& pair_group_indices,
+                          std::vector<std::uint32_t>&& pair_row_classes,
+                          std::vector<std::size_t>&& class_offsets,
+                          std::vector<std::uint32_t>&& class_prefix_sums);
+};
+
+inline void swap(ME2JIndexTable& a, ME2JIndexTable& b) noexcept { a.swap(b); }
+
+}  // namespace mexj
+
+}  // namespace imsrg
+
+#endif  // IMSRG_FILES_FORMATS_HELPERS_ME2J_INDEX_H_
@@ -0,0 +1,252 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/formats/helpers/me2jp_index.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "imsrg/assert.h"
+#include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/total_ang_mom.h"
+
+namespace imsrg {
+
+namespace mexj {
+
+namespace detail {
+// Parity x isospin projection of pairs
+constexpr std::size_t kNumPairGroups = 6;
+// Group index of pairs above e2max
+constexpr std::uint32_t kExcludedPair = UINT32_MAX;
+
+struct JJRange {
+  int jj_min;
+  int jj_max;
+};
+
+static std::size_t PairIndex(std::size_t i, std::size_t j) {
+  return i * (i + 1) / 2 + j;
+}
+
+static bool IsPairBelowE2Max(const NLJJT& p, const NLJJT& q, HOEnergy e2max) {
+  return p.E().AsInt() + q.E().AsInt() <= e2max.AsInt();
+}
+
+static std::size_t PairGroup(const NLJJT& p, const NLJJT& q);
+
+static JJRange PairJJRange(const NLJJT& p, const NLJJT& q);
+
+// Number of J values allowed for both ranges
+static std::uint32_t OverlapSize(JJRange a, JJRange b);
+}  // namespace detail
+
+ME2JPIndexTable ME2JPIndexTable::FromEMax(HOEnergy emax) {
+  return FromEMaxAndE2Max(emax, HOEnergy(2 * emax.AsInt()));
+}
+
+ME2JPIndexTable ME2JPIndexTable::FromEMaxAndE2Max(HOEnergy emax,
+                                                  HOEnergy e2max) {
+  const auto basis = imsrg::mexj::GetNLJJTs(emax);
+  const std::size_t num_states = basis.size();
+  const std::size_t num_pairs = num_states * (num_states + 1) / 2;
+
+  std::vector<std::uint32_t> pair_group_indices(num_pairs, 0);
+  std::vector<std::uint32_t> pair_row_classes(num_pairs, 0);
+
+  std::array<std::vector<imsrg::mexj::detail::JJRange>,
+             imsrg::mexj::detail::kNumPairGroups>
+      group_ranges;
+  // (group, jj_min, jj_max) -> row class
+  std::map<std::array<int, 3>, std::uint32_t> row_classes;
+  std::vector<std::array<int, 3>> row_class_keys;
+
+  // Pair indices are increasing in this loop, so pairs are in file order.
+  for (std::size_t i_p = 0; i_p < num_states; i_p += 1) {
+    for (std::size_t i_q = 0; i_q <= i_p; i_q += 1) {
+      const auto pair = imsrg::mexj::detail::PairIndex(i_p, i_q);
+      if (!imsrg::mexj::detail::IsPairBelowE2Max(basis[i_p], basis[i_q],
+                                                 e2max)) {
+        pair_group_indices[pair] = imsrg::mexj::detail::kExcludedPair;
+        continue;
+      }
+      const auto group = imsrg::mexj::detail::PairGroup(basis[i_p], basis[i_q]);
+      const auto range =
+          imsrg::mexj::detail::PairJJRange(basis[i_p], basis[i_q]);
+
+      pair_group_indices[pair] =
+          static_cast<std::uint32_t>(group_ranges[group].size());
+      group_ranges[group].push_back(range);
+
+      const std::array<int, 3> key = {static_cast<int>(group), range.jj_min,
+                                      range.jj_max};
+      const auto [it, inserted] = row_classes.emplace(
+          key, static_cast<std::uint32_t>(row_class_keys.size()));
+      if (inserted) {
+        row_class_keys.push_back(key);
+      }
+      pair_row_classes[pair] = it->second;
+    }
+  }
+
+  std::vector<std::size_t> class_offsets;
+  class_offsets.reserve(row_class_keys.size());
+  std::vector<std::uint32_t> class_prefix_sums;
+  for (const auto& key : row_class_keys) {
+    const auto& ranges = group_ranges[static_cast<std::size_t>(key[0])];
+    const imsrg::mexj::detail::JJRange row_range = {key[1], key[2]};
+
+    class_offsets.push_back(class_prefix_sums.size());
+    std::uint32_t sum = 0;
+    class_prefix_sums.push_back(sum);
+    for (const auto& range : ranges) {
+      sum += imsrg::mexj::detail::OverlapSize(row_range, range);
+      class_prefix_sums.push_back(sum);
+    }
+  }
+
+  // Rows (p, q) contain the pairs of their group up to and including (p, q).
+  std::vector<std::size_t> row_offsets(num_pairs, 0);
+  std::size_t num_mes = 0;
+  for (std::size_t pair = 0; pair < num_pairs; pair += 1) {
+    row_offsets[pair] = num_mes;
+    if (pair_group_indices[pair] == imsrg::mexj::detail::kExcludedPair) {
+      continue;
+    }
+    num_mes += class_prefix_sums[class_offsets[pair_row_classes[pair]] +
+                                 pair_group_indices[pair] + 1];
+  }
+
+  return ME2JPIndexTable(num_states, num_mes, std::move(row_offsets),
+                         std::move(pair_group_indices),
+                         std::move(pair_row_classes), std::move(class_offsets),
+                         std::move(class_prefix_sums));
+}
+
+ME2JPIndexTable::ME2JPIndexTable(
+    std::size_t num_states, std::size_t num_mes,
+    std::vector<std::size_t>&& row_offsets,
+    std::vector<std::uint32_t>&& pair_group_indices,
+    std::vector<std::uint32_t>&& pair_row_classes,
+    std::vector<std::size_t>&& class_offsets,
+    std::vector<std::uint32_t>&& class_prefix_sums)
+    : num_states_(num_states),
+      num_mes_(num_mes),
+      row_offsets_(std::move(row_offsets)),
+      pair_group_indices_(std::move(pair_group_indices)),
+      pair_row_classes_(std::move(pair_row_classes)),
+      class_offsets_(std::move(class_offsets)),
+      class_prefix_sums_(std::move(class_prefix_sums)) {
+  Expects(row_offsets_.size() == num_states_ * (num_states_ + 1) / 2);
+  Expects(pair_group_indices_.size() == row_offsets_.size());
+  Expects(pair_row_classes_.size() == row_offsets_.size());
+}
+
+std::size_t ME2JPIndexTable::Offset(const NLJJT& p, const NLJJT& q,
+                                    const NLJJT& r, const NLJJT& s) const {
+  const auto i_p = p.Index().AsSizeT();
+  if (i_p >= num_states_) {
+    return npos;
+  }
+  if (imsrg::mexj::detail::PairGroup(p, q) !=
+      imsrg::mexj::detail::PairGroup(r, s)) {
+    return npos;
+  }
+
+  const auto pair_pq = imsrg::mexj::detail::PairIndex(i_p, q.Index().AsSizeT());
+  const auto pair_rs = imsrg::mexj::detail::PairIndex(r.Index().AsSizeT(),
+                                                      s.Index().AsSizeT());
+  if ((pair_group_indices_[pair_pq] == imsrg::mexj::detail::kExcludedPair) ||
+      (pair_group_indices_[pair_rs] == imsrg::mexj::detail::kExcludedPair)) {
+    return npos;
+  }
+  const auto* prefix_sums = class_prefix_sums_.data() +
+                            class_offsets_[pair_row_classes_[pair_pq]] +
+                            pair_group_indices_[pair_rs];
+  if (prefix_sums[0] == prefix_sums[1]) {
+    return npos;
+  }
+  return row_offsets_[pair_pq] + prefix_sums[0];
+}
+
+std::size_t ME2JPIndexTable::SizeInBytes() const {
+  return row_offsets_.size() * sizeof(std::size_t) +
+         pair_group_indices_.size() * sizeof(std::uint32_t) +
+         pair_row_classes_.size() * sizeof(std::uint32_t) +
+         class_offsets_.size() * sizeof(std::size_t) +
+         class_prefix_sums_.size() * sizeof(std::uint32_t);
+}
+
+std::vector<std::size_t> ME2JPTruncationRuns(HOEnergy emax, HOEnergy e2max) {
+  const auto basis = imsrg::mexj::GetNLJJTs(emax);
+  const std::size_t num_states = basis.size();
+  const std::size_t num_pairs = num_states * (num_states + 1) / 2;
+
+  std::vector<imsrg::mexj::detail::JJRange> pair_ranges(num_pairs);
+  std::vector<std::uint8_t> pair_kept(num_pairs, 0);
+  // Pairs of each group in file order, up to the current row
+  std::array<std::vector<std::size_t>, imsrg::mexj::detail::kNumPairGroups>
+      group_pairs;
+
+  std::vector<std::size_t> runs = {0};
+  bool run_kept = true;
+  for (std::size_t i_p = 0; i_p < num_states; i_p += 1) {
+    for (std::size_t i_q = 0; i_q <= i_p; i_q += 1) {
+      const auto pair = imsrg::mexj::detail::PairIndex(i_p, i_q);
+      const auto group = imsrg::mexj::detail::PairGroup(basis[i_p], basis[i_q]);
+      pair_ranges[pair] =
+          imsrg::mexj::detail::PairJJRange(basis[i_p], basis[i_q]);
+      pair_kept[pair] =
+          imsrg::mexj::detail::IsPairBelowE2Max(basis[i_p], basis[i_q], e2max);
+      // Rows contain the pairs of their group up to and including the row.
+      group_pairs[group].push_back(pair);
+
+      for (const auto pair_rs : group_pairs[group]) {
+        const auto num_mes = imsrg::mexj::detail::OverlapSize(
+            pair_ranges[pair], pair_ranges[pair_rs]);
+        const bool kept = (pair_kept[pair] != 0) && (pair_kept[pair_rs] != 0);
+        if (num_mes == 0) {
+          continue;
+        }
+        if (kept != run_kept) {
+          runs.push_back(0);
+          run_kept = kept;
+        }
+        runs.back() += num_mes;
+      }
+    }
+  }
+  return runs;
+}
+
+namespace detail {
+std::size_t PairGroup(const NLJJT& p, const NLJJT& q) {
+  const std::size_t parity_index = (p.P() + q.P()).IsEven() ? 0 : 1;
+  // m_tt of pairs is -2, 0, or 2
+  const auto m_tt_index =
+      static_cast<std::size_t>((p.M_TT() + q.M_TT()).AsInt() + 2) / 2;
+  return 2 * m_tt_index + parity_index;
+}
+
+JJRange PairJJRange(const NLJJT& p, const NLJJT& q) {
+  return {imsrg::CouplingMinimum<imsrg::TotalAngMom>(p.JJ(), q.JJ()).AsInt(),
+          imsrg::CouplingMaximum<imsrg::TotalAngMom>(p.JJ(), q.JJ()).AsInt()};
+}
+
+std::uint32_t OverlapSize(JJRange a, JJRange b) {
+  const int jj_min = std::max(a.jj_min, b.jj_min);
+  const int jj_max = std::min(a.jj_max, b.jj_max);
+  if (jj_max < jj_min) {
+    return 0;
+  }
+  return static_cast<std::uint32_t>((jj_max - jj_min) / 2 + 1);
+}
+}  // namespace detail
+
+}  // namespace mexj
+
+}  // namespace imsrg
@@ -0,0 +1,96 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_FILES_FORMATS_HELPERS_ME2JP_INDEX_H_
+#define IMSRG_FILES_FORMATS_HELPERS_ME2JP_INDEX_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+namespace imsrg {
+
+namespace mexj {
+
+// Offsets of matrix elements in ME2JP files, computed with table lookups and
+// arithmetic instead of a hash map over all (p, q, r, s).
+//
+// The file stores, for pairs (p, q) with q <= p (rows) and (r, s) with s <= r
+// and (r, s) <= (p, q) (lexicographic), all allowed J of <pq|V|rs>. Within a
+// row, the number of J values before (r, s) only depends on (r, s) and on the
+// parity, isospin projection and J coupling range of (p, q) (the row class).
+// So per row class, we store prefix sums over the pairs (r, s) of matching
+// parity and isospin projection, and per row the offset of its first element.
+class ME2JPIndexTable {
+ public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  static ME2JPIndexTable FromEMax(HOEnergy emax);
+
+  // Only matrix elements with e_p + e_q <= e2max and e_r + e_s <= e2max, in
+  // file order.
+  static ME2JPIndexTable FromEMaxAndE2Max(HOEnergy emax, HOEnergy e2max);
+
+  // Default copy, move, and dtor
+
+  std::size_t NumberOfMatrixElements() const { return num_mes_; }
+
+  // Offset of the matrix element with the lowest allowed J for p, q, r, s
+  // with q <= p, s <= r, and (r, s) <= (p, q), npos if no matrix element is
+  // stored (states above emax, pairs above e2max, or broken symmetries).
+  std::size_t Offset(const NLJJT& p, const NLJJT& q, const NLJJT& r,
+                     const NLJJT& s) const;
+
+  std::size_t SizeInBytes() const;
+
+  void swap(ME2JPIndexTable& other) noexcept {
+    using std::swap;
+    swap(num_states_, other.num_states_);
+    swap(num_mes_, other.num_mes_);
+    swap(row_offsets_, other.row_offsets_);
+    swap(pair_group_indices_, other.pair_group_indices_);
+    swap(pair_row_classes_, other.pair_row_classes_);
+    swap(class_offsets_, other.class_offsets_);
+    swap(class_prefix_sums_, other.class_prefix_sums_);
+  }
+
+ private:
+  std::size_t num_states_;
+  std::size_t num_mes_;
+  // Indexed by pair index p * (p + 1) / 2 + q:
+  // Offset of the first matrix element in row (p, q)
+  std::vector<std::size_t> row_offsets_;
+  // Index of pair among pairs of the same parity and isospin projection
+  // (a marker for pairs above e2max)
+  std::vector<std::uint32_t> pair_group_indices_;
+  // Row class of pair
+  std::vector<std::uint32_t> pair_row_classes_;
+  // Start of prefix sums of each row class in class_prefix_sums_
+  std::vector<std::size_t> class_offsets_;
+  // Number of matrix elements in a row before pair with group index i
+  std::vector<std::uint32_t> class_prefix_sums_;
+
+  explicit ME2JPIndexTable(std::size_t num_states, std::size_t num_mes,
+                           std::vector<std::size_t>&& row_offsets,
+                           std::vector<std::uint32_t>&& pair_group_indices,
+                           std::vector<std::uint32_t>&& pair_row_classes,
+                           std::vector<std::size_t>&& class_offsets,
+                           std::vector<std::uint32_t>&& class_prefix_sums);
+};
+
+inline void swap(ME2JPIndexTable& a, ME2JPIndexTable& b) noexcept {
+  a.swap(b);
+}
+
+// Lengths of alternating runs of kept and dropped matrix elements in an ME2JP
+// file for emax when truncating to e2max (see FromEMaxAndE2Max), starting
+// with a (possibly empty) run of kept matrix elements. Kept matrix elements
+// are in the order of ME2JPIndexTable::FromEMaxAndE2Max(emax, e2max).
+std::vector<std::size_t> ME2JPTruncationRuns(HOEnergy emax, HOEnergy e2max);
+
+}  // namespace mexj
+
+}  // namespace imsrg
+
+#endif  // IMSRG_FILES_FORMATS_HELPERS_ME2JP_INDEX_H_
@@ -114,11 +114,6 @@ NLJJTIndex2::NLJJTIndex2(NLJJTIndex i1, NLJJTIndex i2)
 NLJJTIndex3::NLJJTIndex3(NLJJTIndex i1, NLJJTIndex i2, NLJJTIndex i3)
     : index_(i1.AsSizeT() + i2.AsSizeT() * kMEXJIndexFoldFactor +
              i3.AsSizeT() * kMEXJIndexFoldFactor2) {}
-NLJJTIndex4::NLJJTIndex4(NLJJTIndex i1, NLJJTIndex i2, NLJJTIndex i3,
-                         NLJJTIndex i4)
-    : index_(i1.AsSizeT() + i2.AsSizeT() * kMEXJIndexFoldFactor +
-             i3.AsSizeT() * kMEXJIndexFoldFactor2 +
-             i4.AsSizeT() * kMEXJIndexFoldFactor3) {}
 NLJJTIndex5::NLJJTIndex5(NLJJTIndex i1, NLJJTIndex i2, NLJJTIndex i3,
                          NLJJTIndex i4, NLJJTIndex i5)
     : index_(i1.AsSizeT() + i2.AsSizeT() * kMEXJIndexFoldFactor +
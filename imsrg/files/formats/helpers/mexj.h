@@ -80,6 +80,7 @@ class NLJJT {
       : NLJJT(s.RadialN(), s.L(), s.JJ(), s.M_TT()) {}
 
   NLJJTIndex Index() const { return index_; }
+  imsrg::HOEnergy E() const { return imsrg::HOEnergy(n_, l_); }
   imsrg::TotalAngMom JJ() const { return jj_; }
   imsrg::Parity P() const { return l_.Parity(); }
   imsrg::IsospinProj M_TT() const { return m_tt_; }
@@ -153,6 +154,8 @@ class NLJJ {
   explicit NLJJ(const imsrg::SPState& s) : NLJJ(s.RadialN(), s.L(), s.JJ()) {}
 
   NLJJIndex Index() const { return index_; }
+  imsrg::HOEnergy E() const { return imsrg::HOEnergy(n_, l_); }
+  imsrg::OrbitalAngMom L() const { return l_; }
   imsrg::TotalAngMom JJ() const { return jj_; }
   imsrg::Parity P() const { return l_.Parity(); }
 
@@ -223,31 +226,6 @@ inline bool operator==(const NLJJTIndex3& a, const NLJJTIndex3& b) {
   return a.AsSizeT() == b.AsSizeT();
 }
 
-class NLJJTIndex4 {
- public:
-  explicit NLJJTIndex4(NLJJTIndex i1, NLJJTIndex i2, NLJJTIndex i3,
-                       NLJJTIndex i4);
-
-  std::size_t AsSizeT() const { return index_; }
-
-  template <typename H>
-  friend H AbslHashValue(H h, const NLJJTIndex4& o) {
-    return H::combine(std::move(h), o.index_);
-  }
-
-  void swap(NLJJTIndex4& other) noexcept {
-    using std::swap;
-    swap(index_, other.index_);
-  }
-
- private:
-  std::size_t index_;
-};
-inline void swap(NLJJTIndex4& a, NLJJTIndex4& b) noexcept { a.swap(b); }
-inline bool operator==(const NLJJTIndex4& a, const NLJJTIndex4& b) {
-  return a.AsSizeT() == b.AsSizeT();
-}
-
 class NLJJTIndex5 {
  public:
   explicit NLJJTIndex5(NLJJTIndex i1, NLJJTIndex i2, NLJJTIndex i3,
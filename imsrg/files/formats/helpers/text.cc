@@ -0,0 +1,302 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/formats/helpers/text.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "fmt/core.h"
+
+#include "imsrg/error.h"
+#include "imsrg/openmp_runtime.h"
+
+namespace imsrg {
+
+namespace mexj {
+
+namespace detail {
+// Chunks are at least this large, so small files are parsed serially.
+constexpr std::size_t kMinParseChunkSize = 1 << 16;
+// Chunks per thread, to balance lines of different lengths
+constexpr std::size_t kParseChunksPerThread = 4;
+
+constexpr std::size_t kNoBadToken = std::string_view::npos;
+
+// Text read per block by StreamDoubles
+constexpr std::size_t kStreamBlockSize = 1 << 24;
+
+constexpr std::size_t kValuesPerLine = 10;
+// Values formatted before text is passed on (multiple of kValuesPerLine)
+constexpr std::size_t kFormatBlockSize = 1 << 20;
+// Values formatted per task (multiple of kValuesPerLine)
+constexpr std::size_t kFormatChunkSize = 1 << 14;
+// Enough for the shortest representation of any double and a separator
+constexpr std::size_t kMaxFormattedSize = 32;
+
+static bool IsSpace(char c) {
+  return (c == ' ') || (c == '\n') || (c == '\t') || (c == '\r');
+}
+
+static std::vector<std::size_t> GenerateChunkBoundaries(std::string_view text);
+
+static std::size_t CountTokens(std::string_view text, std::size_t begin,
+                               std::size_t end);
+
+// Returns the position of the first token that is not a number,
+// kNoBadToken if there is none.
+static std::size_t ParseTokens(std::string_view text, std::size_t begin,
+                               std::size_t end, double* values,
+                               std::size_t offset, std::size_t max_values);
+
+// Formats values[begin:end] into out. Line breaks follow the global index.
+static void FormatChunk(const double* values, std::size_t begin,
+                        std::size_t end, std::string& out);
+}  // namespace detail
+
+std::string ReadWholeFile(const std::string& path_to_file) {
+  std::ifstream file(path_to_file, std::ios::binary | std::ios::ate);
+  imsrg::CheckForError(!file.is_open(),
+                       fmt::format("Failed to open file at {}", path_to_file));
+  const auto size = static_cast<std::size_t>(file.tellg());
+  file.seekg(0);
+
+  std::string contents(size, '\0');
+  file.read(contents.data(), static_cast<std::streamsize>(size));
+  imsrg::CheckForError(!file.good(),
+                       fmt::format("Failed to read file at {}", path_to_file));
+  return contents;
+}
+
+std::size_t ParseDoubles(std::string_view text, double* values,
+                         std::size_t max_values) {
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const auto boundaries = imsrg::mexj::detail::GenerateChunkBoundaries(text);
+  const std::size_t num_chunks = boundaries.size() - 1;
+  const auto round_size = static_cast<std::size_t>(
+      imsrg::OpenMPRuntime::GetInstance().MaxNumberOfThreads());
+
+  // Offset of first value of each chunk. Chunks are counted one round (a
+  // chunk per thread) at a time, and chunks after the round in which
+  // max_values is reached are neither counted nor parsed.
+  std::vector<std::size_t> offsets(num_chunks + 1, 0);
+  std::size_t num_counted = 0;
+  while ((num_counted < num_chunks) && (offsets[num_counted] < max_values)) {
+    const std::size_t round_end =
+        std::min(num_counted + round_size, num_chunks);
+#pragma omp parallel for schedule(static)
+    for (std::size_t i = num_counted; i < round_end; i += 1) {
+      offsets[i + 1] = imsrg::mexj::detail::CountTokens(text, boundaries[i],
+                                                        boundaries[i + 1]);
+    }
+    for (std::size_t i = num_counted; i < round_end; i += 1) {
+      offsets[i + 1] += offsets[i];
+    }
+    num_counted = round_end;
+  }
+
+  std::vector<std::size_t> bad_tokens(num_counted,
+                                      imsrg::mexj::detail::kNoBadToken);
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t i = 0; i < num_counted; i += 1) {
+    if (offsets[i] >= max_values) {
+      continue;
+    }
+    bad_tokens[i] = imsrg::mexj::detail::ParseTokens(
+        text, boundaries[i], boundaries[i + 1], values, offsets[i],
+        max_values);
+  }
+
+  for (const auto pos : bad_tokens) {
+    if (pos == imsrg::mexj::detail::kNoBadToken) {
+      continue;
+    }
+    std::size_t end = pos;
+    while ((end < text.size()) && !imsrg::mexj::detail::IsSpace(text[end])) {
+      end += 1;
+    }
+    imsrg::Error(fmt::format("Failed to parse \"{}\" as a number.",
+                             text.substr(pos, end - pos)));
+  }
+
+  return std::min(offsets[num_counted], max_values);
+}
+
+std::size_t StreamDoubles(
+    std::istream& stream, std::size_t max_values,
+    const std::function<void(const double*, std::size_t)>& consume) {
+  using imsrg::mexj::detail::kStreamBlockSize;
+
+  std::string text;
+  // Incomplete token at the end of the previous block
+  std::string carry;
+  std::vector<double> values;
+  std::size_t num_read = 0;
+  while (num_read < max_values) {
+    text.swap(carry);
+    const std::size_t carry_size = text.size();
+    text.resize(carry_size + kStreamBlockSize);
+    stream.read(text.data() + carry_size,
+                static_cast<std::streamsize>(kStreamBlockSize));
+    text.resize(carry_size + static_cast<std::size_t>(stream.gcount()));
+    const bool at_end = !stream;
+
+    // Cut the block after its last separator, unless the stream has ended.
+    std::size_t parse_end = text.size();
+    if (!at_end) {
+      const auto last_space = text.find_last_of(" \n\t\r");
+      imsrg::CheckForError(last_space == std::string::npos,
+                           "Failed to parse stream, token is too long.");
+      parse_end = last_space + 1;
+    }
+    carry.assign(text, parse_end, std::string::npos);
+
+    // Tokens are separated, so there are at most parse_end / 2 + 1.
+    values.resize(std::min(max_values - num_read, parse_end / 2 + 1));
+    const auto num_parsed = ParseDoubles(
+        std::string_view(text).substr(0, parse_end), values.data(),
+        values.size());
+    if (num_parsed > 0) {
+      consume(values.data(), num_parsed);
+    }
+    num_read += num_parsed;
+
+    if (at_end) {
+      break;
+    }
+  }
+  return num_read;
+}
+
+void FormatDoubles(const double* values, std::size_t num_values,
+                   const std::function<void(std::string_view)>& write) {
+  using imsrg::mexj::detail::kFormatBlockSize;
+  using imsrg::mexj::detail::kFormatChunkSize;
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  constexpr std::size_t chunks_per_block = kFormatBlockSize / kFormatChunkSize;
+  std::vector<std::string> chunks(chunks_per_block);
+
+  for (std::size_t block_begin = 0; block_begin < num_values;
+       block_begin += kFormatBlockSize) {
+    const std::size_t block_end =
+        std::min(block_begin + kFormatBlockSize, num_values);
+    const std::size_t num_chunks =
+        (block_end - block_begin + kFormatChunkSize - 1) / kFormatChunkSize;
+
+#pragma omp parallel for schedule(static)
+    for (std::size_t i = 0; i < num_chunks; i += 1) {
+      const std::size_t begin = block_begin + i * kFormatChunkSize;
+      imsrg::mexj::detail::FormatChunk(
+          values, begin, std::min(begin + kFormatChunkSize, block_end),
+          chunks[i]);
+    }
+
+    for (std::size_t i = 0; i < num_chunks; i += 1) {
+      write(chunks[i]);
+    }
+  }
+
+  // Last line is not complete
+  if (num_values % imsrg::mexj::detail::kValuesPerLine != 0) {
+    write("\n");
+  }
+}
+
+namespace detail {
+std::vector<std::size_t> GenerateChunkBoundaries(std::string_view text) {
+  const std::size_t max_chunks =
+      kParseChunksPerThread * static_cast<std::size_t>(
+                                  imsrg::OpenMPRuntime::GetInstance()
+                                      .MaxNumberOfThreads());
+  const std::size_t num_chunks = std::max<std::size_t>(
+      1, std::min(max_chunks, text.size() / kMinParseChunkSize));
+
+  // Boundaries are moved forward to whitespace, so no token is split.
+  std::vector<std::size_t> boundaries(num_chunks + 1, 0);
+  for (std::size_t i = 1; i < num_chunks; i += 1) {
+    std::size_t pos =
+        std::max(i * (text.size() / num_chunks), boundaries[i - 1]);
+    while ((pos < text.size()) && !IsSpace(text[pos])) {
+      pos += 1;
+    }
+    boundaries[i] = pos;
+  }
+  boundaries[num_chunks] = text.size();
+  return boundaries;
+}
+
+std::size_t CountTokens(std::string_view text, std::size_t begin,
+                        std::size_t end) {
+  std::size_t count = 0;
+  bool in_token = false;
+  for (std::size_t pos = begin; pos < end; pos += 1) {
+    const bool is_space = IsSpace(text[pos]);
+    if (!is_space && !in_token) {
+      count += 1;
+    }
+    in_token = !is_space;
+  }
+  return count;
+}
+
+std::size_t ParseTokens(std::string_view text, std::size_t begin,
+                        std::size_t end, double* values, std::size_t offset,
+                        std::size_t max_values) {
+  const char* const data = text.data();
+  std::size_t pos = begin;
+  std::size_t index = offset;
+  while (index < max_values) {
+    while ((pos < end) && IsSpace(data[pos])) {
+      pos += 1;
+    }
+    if (pos == end) {
+      break;
+    }
+    std::size_t token_end = pos;
+    while ((token_end < end) && !IsSpace(data[token_end])) {
+      token_end += 1;
+    }
+
+    // std::from_chars does not accept a leading plus sign.
+    const std::size_t number_begin = (data[pos] == '+') ? pos + 1 : pos;
+    const auto [ptr, ec] =
+        std::from_chars(data + number_begin, data + token_end, values[index]);
+    if ((ec != std::errc()) || (ptr != data + token_end)) {
+      return pos;
+    }
+
+    index += 1;
+    pos = token_end;
+  }
+  return kNoBadToken;
+}
+
+void FormatChunk(const double* values, std::size_t begin, std::size_t end,
+                 std::string& out) {
+  out.resize((end - begin) * kMaxFormattedSize);
+  char* const first = out.data();
+  char* const last = first + out.size();
+  char* pos = first;
+  for (std::size_t i = begin; i < end; i += 1) {
+    pos = std::to_chars(pos, last, values[i]).ptr;
+    *pos = ((i + 1) % kValuesPerLine == 0) ? '\n' : ' ';
+    pos += 1;
+  }
+  out.resize(static_cast<std::size_t>(pos - first));
+}
+}  // namespace detail
+
+}  // namespace mexj
+
+}  // namespace imsrg
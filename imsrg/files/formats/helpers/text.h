@@ -0,0 +1,51 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_FILES_FORMATS_HELPERS_TEXT_H_
+#define IMSRG_FILES_FORMATS_HELPERS_TEXT_H_
+
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace imsrg {
+
+namespace mexj {
+
+// Whole file contents, throws if the file cannot be read.
+std::string ReadWholeFile(const std::string& path_to_file);
+
+// Parses whitespace-separated numbers in text into values[0], values[1], ...,
+// stopping after max_values numbers. Returns the number of values parsed,
+// which is less than max_values if text runs out.
+//
+// The text is split into chunks at whitespace, and chunks are parsed in
+// parallel with std::from_chars (locale-independent). Chunks past the first
+// max_values numbers are mostly skipped (tokens are counted a round of
+// chunks at a time). Throws on a token that is not a number.
+std::size_t ParseDoubles(std::string_view text, double* values,
+                         std::size_t max_values);
+
+// Parses whitespace-separated numbers from stream block by block (each block
+// with ParseDoubles) and passes them to consume in order, stopping after
+// max_values numbers. Returns the number of values passed to consume.
+//
+// Only one block of text and values is held at a time, so memory does not
+// scale with the size of the stream.
+std::size_t StreamDoubles(
+    std::istream& stream, std::size_t max_values,
+    const std::function<void(const double*, std::size_t)>& consume);
+
+// Formats values with std::to_chars (shortest representation that reads
+// back to the same double), 10 per line, ending with a newline.
+//
+// Values are formatted block by block, each block in parallel chunks, and
+// the text is passed to write chunk by chunk in order, so it can be streamed
+// to a file.
+void FormatDoubles(const double* values, std::size_t num_values,
+                   const std::function<void(std::string_view)>& write);
+
+}  // namespace mexj
+
+}  // namespace imsrg
+
+#endif  // IMSRG_FILES_FORMATS_HELPERS_TEXT_H_
@@ -2,6 +2,7 @@
 #include "imsrg/files/formats/me1j.h"
 
 #include <fstream>
+#include <istream>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -14,7 +15,10 @@
 
 #include "imsrg/assert.h"
 #include "imsrg/error.h"
+#include "imsrg/files/formats/helpers/binary.h"
+#include "imsrg/files/formats/helpers/gzip.h"
 #include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/files/formats/helpers/text.h"
 #include "imsrg/quantum_numbers/hermiticity.h"
 #include "imsrg/quantum_numbers/ho_energy.h"
 
@@ -36,6 +40,9 @@ static imsrg::ValidationResult ValidateFile(S&& stream, HOEnergy emax);
 
 static imsrg::ValidationResult ValidateHeader(std::string_view header);
 
+constexpr std::string_view kME1JTextHeader =
+    "    me1j-f3 -- written by imsrg-ntcl\n";
+
 }  // namespace detail
 
 ME1JFile ME1JFile::FromTextFile(std::string path_to_file, HOEnergy emax,
@@ -45,30 +52,84 @@ ME1JFile ME1JFile::FromTextFile(std::string path_to_file, HOEnergy emax,
       !file.is_open(),
       fmt::format("Failed to open ME1J text file at {}", path_to_file));
   auto [me_0b, mes] = imsrg::detail::ReadFile(std::move(file), emax);
-  return ME1JFile(me_0b, herm, std::move(mes),
+  return ME1JFile(me_0b, herm, emax,
+                  imsrg::mexj::MEArray::FromVector(std::move(mes)),
+                  imsrg::detail::MakeME1JIndexLookup(emax));
+}
+
+ME1JFile ME1JFile::FromGZippedFile(std::string path_to_file, HOEnergy emax,
+                                   Hermiticity herm) {
+  imsrg::mexj::GZipStreamBuf buf(path_to_file);
+  imsrg::CheckForError(
+      !buf.is_open(),
+      fmt::format("Failed to open gzipped ME1J file at {}", path_to_file));
+  auto [me_0b, mes] = imsrg::detail::ReadFile(std::istream(&buf), emax);
+  const auto error = buf.Error();
+  imsrg::CheckForError(
+      !error.empty(),
+      fmt::format("Failed to read gzipped ME1J file at {}: {}", path_to_file,
+                  error));
+  return ME1JFile(me_0b, herm, emax,
+                  imsrg::mexj::MEArray::FromVector(std::move(mes)),
                   imsrg::detail::MakeME1JIndexLookup(emax));
 }
 
-// ME1JFile ME1JFile::FromGZippedFile(std::string path_to_file, HOEnergy emax,
-//                                    Hermiticity herm) {
-//   (void)path_to_file;
-//   (void)emax;
-//   imsrg::Error("ME1J::FromGZippedFile not implemented.");
-// }
-
-// ME1JFile ME1JFile::FromBinary(std::string path_to_file, HOEnergy emax,
-//                               Hermiticity herm) {
-//   (void)path_to_file;
-//   (void)emax;
-//   imsrg::Error("ME1J::FromBinary not implemented.");
-//   // This implementation will need to different from those above.
-// }
+ME1JFile ME1JFile::FromMatrixElements(double me_0b, std::vector<double>&& mes,
+                                      HOEnergy emax, Hermiticity herm) {
+  Expects(mes.size() == imsrg::detail::GetME1JSize(emax));
+  return ME1JFile(me_0b, herm, emax,
+                  imsrg::mexj::MEArray::FromVector(std::move(mes)),
+                  imsrg::detail::MakeME1JIndexLookup(emax));
+}
+
+ME1JFile ME1JFile::FromBinary(std::string path_to_file, HOEnergy emax,
+                              Hermiticity herm) {
+  auto contents = imsrg::mexj::ReadMEXJBinaryFile(
+      path_to_file, imsrg::mexj::MEXJBinaryFormat::kME1J, emax, herm,
+      imsrg::detail::GetME1JSize(emax));
+  return ME1JFile(contents.me_0b, herm, emax, std::move(contents.mes),
+                  imsrg::detail::MakeME1JIndexLookup(emax));
+}
+
+void ME1JFile::WriteTextFile(const std::string& path_to_file) const {
+  std::ofstream file(path_to_file, std::ios::trunc);
+  imsrg::CheckForError(
+      !file.is_open(),
+      fmt::format("Failed to open ME1J text file at {}", path_to_file));
+  const auto write = [&file](std::string_view text) {
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+  };
+  file << imsrg::detail::kME1JTextHeader;
+  // Zero-body part on its own line
+  imsrg::mexj::FormatDoubles(&me_0b_, 1, write);
+  imsrg::mexj::FormatDoubles(mes_.data(), mes_.size(), write);
+  imsrg::CheckForError(
+      !file.good(),
+      fmt::format("Failed to write ME1J text file at {}", path_to_file));
+}
+
+void ME1JFile::WriteGZippedFile(const std::string& path_to_file) const {
+  imsrg::mexj::GZipFileWriter file(path_to_file);
+  const auto write = [&file](std::string_view text) { file.Write(text); };
+  file.Write(imsrg::detail::kME1JTextHeader);
+  // Zero-body part on its own line
+  imsrg::mexj::FormatDoubles(&me_0b_, 1, write);
+  imsrg::mexj::FormatDoubles(mes_.data(), mes_.size(), write);
+  file.Close();
+}
+
+void ME1JFile::WriteBinaryFile(const std::string& path_to_file) const {
+  imsrg::mexj::WriteMEXJBinaryFile(
+      path_to_file, imsrg::mexj::MEXJBinaryFormat::kME1J, emax_, herm_, me_0b_,
+      mes_.data(), mes_.size());
+}
 
 ME1JFile::ME1JFile(
-    double me_0b, Hermiticity herm, std::vector<double>&& mes,
+    double me_0b, Hermiticity herm, HOEnergy emax, imsrg::mexj::MEArray&& mes,
     absl::flat_hash_map<imsrg::mexj::NLJJTIndex2, std::size_t>&& me_lookup)
     : me_0b_(me_0b),
       herm_(herm),
+      emax_(emax),
       mes_(std::move(mes)),
       me_lookup_(std::move(me_lookup)) {}
 
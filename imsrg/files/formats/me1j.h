@@ -9,6 +9,7 @@
 
 #include "absl/container/flat_hash_map.h"
 
+#include "imsrg/files/formats/helpers/binary.h"
 #include "imsrg/files/formats/helpers/mexj.h"
 #include "imsrg/model_space/single_particle/state.h"
 #include "imsrg/quantum_numbers/hermiticity.h"
@@ -19,10 +20,25 @@ class ME1JFile {
  public:
   static ME1JFile FromTextFile(std::string path_to_file, HOEnergy emax,
                                Hermiticity herm);
+
+  // Decompresses on a background thread while parsing.
   static ME1JFile FromGZippedFile(std::string path_to_file, HOEnergy emax,
-                                  Hermiticity herm) = delete;
+                                  Hermiticity herm);
+
+  // Matrix elements in file order (e.g., from WriteOperatorToME1J)
+  static ME1JFile FromMatrixElements(double me_0b, std::vector<double>&& mes,
+                                     HOEnergy emax, Hermiticity herm);
+
+  // Maps a binary file (see helpers/binary.h) and uses the matrix elements
+  // in place, without parsing.
   static ME1JFile FromBinary(std::string path_to_file, HOEnergy emax,
-                             Hermiticity herm) = delete;
+                             Hermiticity herm);
+
+  // Writers, text is formatted in parallel.
+  // Binary files round-trip bit-exactly.
+  void WriteTextFile(const std::string& path_to_file) const;
+  void WriteGZippedFile(const std::string& path_to_file) const;
+  void WriteBinaryFile(const std::string& path_to_file) const;
 
   double Get0BPart() const { return me_0b_; }
   double Get1BMatrixElement(const SPState& p, const SPState& q) const;
@@ -32,6 +48,7 @@ class ME1JFile {
     using std::swap;
     swap(me_0b_, other.me_0b_);
     swap(herm_, other.herm_);
+    swap(emax_, other.emax_);
     swap(mes_, other.mes_);
     swap(me_lookup_, other.me_lookup_);
   }
@@ -39,11 +56,13 @@ class ME1JFile {
  private:
   double me_0b_;
   Hermiticity herm_;
-  std::vector<double> mes_;
+  HOEnergy emax_;
+  imsrg::mexj::MEArray mes_;
   absl::flat_hash_map<imsrg::mexj::NLJJTIndex2, std::size_t> me_lookup_;
 
   explicit ME1JFile(
-      double me_0b, Hermiticity herm, std::vector<double>&& mes,
+      double me_0b, Hermiticity herm, HOEnergy emax,
+      imsrg::mexj::MEArray&& mes,
       absl::flat_hash_map<imsrg::mexj::NLJJTIndex2, std::size_t>&& me_lookup);
 };
 
@@ -0,0 +1,225 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/formats/me2j.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fmt/core.h"
+
+#include "imsrg/assert.h"
+#include "imsrg/error.h"
+#include "imsrg/files/formats/helpers/binary.h"
+#include "imsrg/files/formats/helpers/gzip.h"
+#include "imsrg/files/formats/helpers/me2j_index.h"
+#include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/files/formats/helpers/text.h"
+#include "imsrg/model_space/single_particle/state.h"
+#include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
+#include "imsrg/quantum_numbers/coupling/phases.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/isospin_projection.h"
+#include "imsrg/quantum_numbers/orbital_ang_mom.h"
+#include "imsrg/quantum_numbers/total_ang_mom.h"
+
+namespace imsrg {
+
+namespace detail {
+
+// Parses matrix elements (after the header line) block by block.
+static std::vector<double> StreamME2JFile(std::istream& stream,
+                                          std::size_t size);
+
+// Coefficients of the T = 0 and T = 1 states of orbits (a, b) in the
+// normalized antisymmetrized state of p and q (in orbits a and b).
+static std::array<double, 2> IsospinCoefficients(const SPState& p,
+                                                 const SPState& q,
+                                                 bool same_orbit,
+                                                 TotalAngMom jj_2b);
+
+// Position of the T = 1 matrix element for the isospin projection of the
+// pair among the 4 matrix elements (T = 0, T = 1 with T_z = -1, 0, 1) of
+// each J. Two protons have T_z = -1 in me2j files.
+static std::size_t IsospinSlot(const SPState& p, const SPState& q) {
+  return static_cast<std::size_t>(2 - (p.M_TT() + q.M_TT()).AsInt() / 2);
+}
+
+}  // namespace detail
+
+ME2JFile ME2JFile::FromTextFile(std::string path_to_file, HOEnergy emax,
+                                HOEnergy e2max, OrbitalAngMom lmax,
+                                Hermiticity herm) {
+  std::ifstream file(path_to_file, std::ios::binary);
+  imsrg::CheckForError(
+      !file.is_open(),
+      fmt::format("Failed to open me2j text file at {}", path_to_file));
+  auto index_table =
+      imsrg::mexj::ME2JIndexTable::FromEMaxE2MaxAndLMax(emax, e2max, lmax);
+  auto mes = imsrg::detail::StreamME2JFile(
+      file, index_table.NumberOfMatrixElements());
+  return ME2JFile(herm, emax, e2max, lmax,
+                  imsrg::mexj::MEArray::FromVector(std::move(mes)),
+                  std::move(index_table));
+}
+
+ME2JFile ME2JFile::FromGZippedFile(std::string path_to_file, HOEnergy emax,
+                                   HOEnergy e2max, OrbitalAngMom lmax,
+                                   Hermiticity herm) {
+  imsrg::mexj::GZipStreamBuf buf(path_to_file);
+  imsrg::CheckForError(
+      !buf.is_open(),
+      fmt::format("Failed to open gzipped me2j file at {}", path_to_file));
+  auto index_table =
+      imsrg::mexj::ME2JIndexTable::FromEMaxE2MaxAndLMax(emax, e2max, lmax);
+  std::istream stream(&buf);
+  auto mes = imsrg::detail::StreamME2JFile(
+      stream, index_table.NumberOfMatrixElements());
+  const auto error = buf.Error();
+  imsrg::CheckForError(
+      !error.empty(),
+      fmt::format("Failed to read gzipped me2j file at {}: {}", path_to_file,
+                  error));
+  return ME2JFile(herm, emax, e2max, lmax,
+                  imsrg::mexj::MEArray::FromVector(std::move(mes)),
+                  std::move(index_table));
+}
+
+double ME2JFile::Get2BMatrixElement(const SPState& p, const SPState& q,
+                                    const SPState& r, const SPState& s,
+                                    TotalAngMom jj_2b) const {
+  using imsrg::mexj::NLJJ;
+  using std::swap;
+
+  if ((p.M_TT() + q.M_TT()) != (r.M_TT() + s.M_TT())) {
+    return 0.0;
+  }
+
+  NLJJ nljj_a(p);
+  NLJJ nljj_b(q);
+  NLJJ nljj_c(r);
+  NLJJ nljj_d(s);
+
+  auto coeffs_ab = imsrg::detail::IsospinCoefficients(
+      p, q, nljj_a.Index() == nljj_b.Index(), jj_2b);
+  auto coeffs_cd = imsrg::detail::IsospinCoefficients(
+      r, s, nljj_c.Index() == nljj_d.Index(), jj_2b);
+
+  // Exchanging the orbits of a pair gives -(-1)^(j_a + j_b - J) for T = 1
+  // and the opposite phase for T = 0.
+  if (nljj_b.Index() > nljj_a.Index()) {
+    const int phase = (imsrg::JJPhase::MinusOne() * nljj_a.JJ().Phase() *
+                       nljj_b.JJ().Phase() * jj_2b.Phase(-1))
+                          .AsInt();
+    coeffs_ab[0] *= -phase;
+    coeffs_ab[1] *= phase;
+    swap(nljj_a, nljj_b);
+  }
+  if (nljj_d.Index() > nljj_c.Index()) {
+    const int phase = (imsrg::JJPhase::MinusOne() * nljj_c.JJ().Phase() *
+                       nljj_d.JJ().Phase() * jj_2b.Phase(-1))
+                          .AsInt();
+    coeffs_cd[0] *= -phase;
+    coeffs_cd[1] *= phase;
+    swap(nljj_c, nljj_d);
+  }
+  int factor = 1;
+  if ((nljj_c.Index() > nljj_a.Index()) ||
+      ((nljj_c.Index() == nljj_a.Index()) &&
+       (nljj_d.Index() > nljj_b.Index()))) {
+    factor = herm_.Factor();
+    swap(nljj_a, nljj_c);
+    swap(nljj_b, nljj_d);
+  }
+
+  const std::size_t base_index =
+      index_table_.Offset(nljj_a, nljj_b, nljj_c, nljj_d);
+  if (base_index == imsrg::mexj::ME2JIndexTable::npos) {
+    return 0.0;
+  }
+
+  // Handle JJ coupling
+  const auto jj_min = std::max(
+      imsrg::CouplingMinimum<imsrg::TotalAngMom>(nljj_a.JJ(), nljj_b.JJ()),
+      imsrg::CouplingMinimum<imsrg::TotalAngMom>(nljj_c.JJ(), nljj_d.JJ()));
+  const auto jj_max = std::min(
+      imsrg::CouplingMaximum<imsrg::TotalAngMom>(nljj_a.JJ(), nljj_b.JJ()),
+      imsrg::CouplingMaximum<imsrg::TotalAngMom>(nljj_c.JJ(), nljj_d.JJ()));
+
+  if ((jj_2b < jj_min) || (jj_2b > jj_max)) {
+    return 0.0;
+  }
+
+  const std::size_t index =
+      base_index + imsrg::mexj::ME2JIndexTable::kNumIsospinMEs *
+                       static_cast<std::size_t>(
+                           (jj_2b.AsInt() - jj_min.AsInt()) / 2);
+
+  return factor *
+         (coeffs_ab[0] * coeffs_cd[0] * mes_[index] +
+          coeffs_ab[1] * coeffs_cd[1] *
+              mes_[index + imsrg::detail::IsospinSlot(p, q)]);
+}
+
+ME2JFile::ME2JFile(Hermiticity herm, HOEnergy emax, HOEnergy e2max,
+                   OrbitalAngMom lmax, imsrg::mexj::MEArray&& mes,
+                   imsrg::mexj::ME2JIndexTable&& index_table)
+    : herm_(herm),
+      emax_(emax),
+      e2max_(e2max),
+      lmax_(lmax),
+      mes_(std::move(mes)),
+      index_table_(std::move(index_table)) {
+  Expects(mes_.size() == index_table_.NumberOfMatrixElements());
+}
+
+namespace detail {
+
+std::vector<double> StreamME2JFile(std::istream& stream, std::size_t size) {
+  // The header line is not standardized, so it is skipped.
+  std::string header;
+  std::getline(stream, header);
+
+  std::vector<double> mes(size, 0.0);
+  std::size_t num_read = 0;
+  const auto consume = [&](const double* values, std::size_t num_values) {
+    std::copy(values, values + num_values, mes.data() + num_read);
+    num_read += num_values;
+  };
+  imsrg::mexj::StreamDoubles(stream, size, consume);
+  imsrg::CheckForError(
+      num_read < size,
+      fmt::format("Reached end of me2j file before two-body matrix element {} "
+                  "was read.",
+                  num_read));
+
+  return mes;
+}
+
+std::array<double, 2> IsospinCoefficients(const SPState& p, const SPState& q,
+                                          bool same_orbit, TotalAngMom jj_2b) {
+  std::array<double, 2> coeffs = {0.0, 1.0};
+  if (p.M_TT() != q.M_TT()) {
+    // <1/2 m_p 1/2 m_q|T 0>, the sign of the T = 0 coefficient only matters
+    // relative to other pairs. Orbit pairs (a, a) have norm sqrt(2) in the
+    // proton-neutron state.
+    const double norm = same_orbit ? 1.0 : 1.0 / std::sqrt(2.0);
+    coeffs[0] = (p.M_TT() == imsrg::IsospinProj::Proton()) ? norm : -norm;
+    coeffs[1] = norm;
+  }
+  if (same_orbit) {
+    // (a, a) is antisymmetric only for odd J + T.
+    const bool even_j = (jj_2b.AsInt() / 2) % 2 == 0;
+    coeffs[even_j ? 0 : 1] = 0.0;
+  }
+  return coeffs;
+}
+
+}  // namespace detail
+
+}  // namespace imsrg
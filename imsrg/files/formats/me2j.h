@@ -0,0 +1,76 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_FILES_FORMATS_ME2J_H_
+#define IMSRG_FILES_FORMATS_ME2J_H_
+
+#include <string>
+#include <utility>
+
+#include "imsrg/files/formats/helpers/binary.h"
+#include "imsrg/files/formats/helpers/me2j_index.h"
+#include "imsrg/model_space/single_particle/state.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/orbital_ang_mom.h"
+#include "imsrg/quantum_numbers/total_ang_mom.h"
+
+namespace imsrg {
+
+// Isospin-coupled two-body matrix elements in the (Darmstadt) me2j format.
+//
+// The matrix elements are kept isospin-coupled (4x fewer than proton-neutron
+// matrix elements) and converted to proton-neutron matrix elements in
+// Get2BMatrixElement, so no converted copy of the file is needed. Matrix
+// elements are between normalized antisymmetrized states, as in ME2JP.
+//
+// me2j files use T_z = -1 for two protons.
+class ME2JFile {
+ public:
+  // e2max and lmax are the truncations of the file. emax may be below the
+  // emax of the file: files for a larger emax start with the file for a
+  // smaller emax (at the same e2max and lmax).
+  static ME2JFile FromTextFile(std::string path_to_file, HOEnergy emax,
+                               HOEnergy e2max, OrbitalAngMom lmax,
+                               Hermiticity herm);
+
+  // Decompresses on a background thread while parsing.
+  static ME2JFile FromGZippedFile(std::string path_to_file, HOEnergy emax,
+                                  HOEnergy e2max, OrbitalAngMom lmax,
+                                  Hermiticity herm);
+
+  // Proton-neutron matrix element, 0 for states above emax or lmax, pairs
+  // above e2max, or J not allowed for both pairs.
+  double Get2BMatrixElement(const SPState& p, const SPState& q,
+                            const SPState& r, const SPState& s,
+                            TotalAngMom jj_2b) const;
+  Hermiticity Herm() const { return herm_; }
+  HOEnergy EMax() const { return emax_; }
+  HOEnergy E2Max() const { return e2max_; }
+  OrbitalAngMom LMax() const { return lmax_; }
+
+  void swap(ME2JFile& other) noexcept {
+    using std::swap;
+    swap(herm_, other.herm_);
+    swap(emax_, other.emax_);
+    swap(e2max_, other.e2max_);
+    swap(lmax_, other.lmax_);
+    swap(mes_, other.mes_);
+    swap(index_table_, other.index_table_);
+  }
+
+ private:
+  Hermiticity herm_;
+  HOEnergy emax_;
+  HOEnergy e2max_;
+  OrbitalAngMom lmax_;
+  imsrg::mexj::MEArray mes_;
+  imsrg::mexj::ME2JIndexTable index_table_;
+
+  explicit ME2JFile(Hermiticity herm, HOEnergy emax, HOEnergy e2max,
+                    OrbitalAngMom lmax, imsrg::mexj::MEArray&& mes,
+                    imsrg::mexj::ME2JIndexTable&& index_table);
+};
+
+inline void swap(ME2JFile& a, ME2JFile& b) noexcept { a.swap(b); }
+
+}  // namespace imsrg
+#endif  // IMSRG_FILES_FORMATS_ME2J_H_
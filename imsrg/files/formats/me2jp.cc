@@ -2,15 +2,23 @@
 #include "imsrg/files/formats/me2jp.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
+#include <istream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
-#include "absl/container/flat_hash_map.h"
+#include "fmt/core.h"
 
+#include "imsrg/assert.h"
 #include "imsrg/error.h"
+#include "imsrg/files/formats/helpers/binary.h"
+#include "imsrg/files/formats/helpers/gzip.h"
+#include "imsrg/files/formats/helpers/me2jp_index.h"
 #include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/files/formats/helpers/text.h"
 #include "imsrg/model_space/single_particle/state.h"
 #include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
 #include "imsrg/quantum_numbers/coupling/phases.h"
@@ -22,44 +30,172 @@ namespace imsrg {
 
 namespace detail {
 
-static std::size_t GetME2JPSize(imsrg::HOEnergy emax);
-
-static std::size_t GetME2JPSize_NoJJ(imsrg::HOEnergy emax);
+template <typename S>
+static std::vector<double> ReadFile(S&& stream, std::size_t size);
 
-static absl::flat_hash_map<imsrg::mexj::NLJJTIndex4, std::size_t>
-MakeME2JPIndexLookup(imsrg::HOEnergy emax);
+// Parses the file block by block, keeping only matrix elements in the
+// truncation to e2max (see ME2JPTruncationRuns).
+static std::vector<double> StreamFile(std::istream& stream, HOEnergy emax,
+                                      HOEnergy e2max, std::size_t size);
 
-template <typename S>
-static std::vector<double> ReadFile(S&& stream, HOEnergy emax);
+// e2max above 2 * emax keeps all matrix elements up to emax.
+static HOEnergy ClampE2Max(HOEnergy emax, HOEnergy e2max) {
+  return std::min(e2max, HOEnergy(2 * emax.AsInt()));
+}
 
 template <typename S>
-static imsrg::ValidationResult ValidateFile(S&& stream, HOEnergy emax);
+static imsrg::ValidationResult ValidateFile(S&& stream, std::size_t size);
 
 static imsrg::ValidationResult ValidateHeader(std::string_view header);
 
+constexpr std::string_view kME2JPTextHeader =
+    "    me2jp-f2 -- written by imsrg-ntcl\n";
+
 }  // namespace detail
 
 ME2JPFile ME2JPFile::FromTextFile(std::string path_to_file, HOEnergy emax,
                                   Hermiticity herm) {
-  std::ifstream file(path_to_file);
+  std::ifstream file(path_to_file, std::ios::binary);
+  imsrg::CheckForError(
+      !file.is_open(),
+      fmt::format("Failed to open ME2JP text file at {}", path_to_file));
+  auto index_table = imsrg::mexj::ME2JPIndexTable::FromEMax(emax);
+  // Without truncation StreamFile keeps every matrix element.
+  auto mes = imsrg::detail::StreamFile(file, emax, HOEnergy(2 * emax.AsInt()),
+                                       index_table.NumberOfMatrixElements());
+  return ME2JPFile(herm, emax, HOEnergy(2 * emax.AsInt()),
+                   imsrg::mexj::MEArray::FromVector(std::move(mes)),
+                   std::move(index_table));
+}
+
+ME2JPFile ME2JPFile::FromGZippedFile(std::string path_to_file, HOEnergy emax,
+                                     Hermiticity herm) {
+  imsrg::mexj::GZipStreamBuf buf(path_to_file);
+  imsrg::CheckForError(
+      !buf.is_open(),
+      fmt::format("Failed to open gzipped ME2JP file at {}", path_to_file));
+  auto index_table = imsrg::mexj::ME2JPIndexTable::FromEMax(emax);
+  auto mes = imsrg::detail::ReadFile(std::istream(&buf),
+                                     index_table.NumberOfMatrixElements());
+  const auto error = buf.Error();
+  imsrg::CheckForError(
+      !error.empty(),
+      fmt::format("Failed to read gzipped ME2JP file at {}: {}", path_to_file,
+                  error));
+  return ME2JPFile(herm, emax, HOEnergy(2 * emax.AsInt()),
+                   imsrg::mexj::MEArray::FromVector(std::move(mes)),
+                   std::move(index_table));
+}
+
+ME2JPFile ME2JPFile::FromTextFile(std::string path_to_file,
+                                  HOEnergy file_emax, HOEnergy emax,
+                                  HOEnergy e2max, Hermiticity herm) {
+  imsrg::CheckForError(
+      emax > file_emax,
+      fmt::format("Cannot read emax={} from ME2JP file for emax={}.",
+                  emax.AsInt(), file_emax.AsInt()));
+  e2max = imsrg::detail::ClampE2Max(emax, e2max);
+
+  std::ifstream file(path_to_file, std::ios::binary);
   imsrg::CheckForError(
       !file.is_open(),
       fmt::format("Failed to open ME2JP text file at {}", path_to_file));
-  auto mes = imsrg::detail::ReadFile(std::move(file), emax);
-  return ME2JPFile(herm, std::move(mes),
-                   imsrg::detail::MakeME2JPIndexLookup(emax));
+  auto index_table =
+      imsrg::mexj::ME2JPIndexTable::FromEMaxAndE2Max(emax, e2max);
+  auto mes = imsrg::detail::StreamFile(file, emax, e2max,
+                                       index_table.NumberOfMatrixElements());
+  return ME2JPFile(herm, emax, e2max,
+                   imsrg::mexj::MEArray::FromVector(std::move(mes)),
+                   std::move(index_table));
+}
+
+ME2JPFile ME2JPFile::FromGZippedFile(std::string path_to_file,
+                                     HOEnergy file_emax, HOEnergy emax,
+                                     HOEnergy e2max, Hermiticity herm) {
+  imsrg::CheckForError(
+      emax > file_emax,
+      fmt::format("Cannot read emax={} from ME2JP file for emax={}.",
+                  emax.AsInt(), file_emax.AsInt()));
+  e2max = imsrg::detail::ClampE2Max(emax, e2max);
+
+  imsrg::mexj::GZipStreamBuf buf(path_to_file);
+  imsrg::CheckForError(
+      !buf.is_open(),
+      fmt::format("Failed to open gzipped ME2JP file at {}", path_to_file));
+  auto index_table =
+      imsrg::mexj::ME2JPIndexTable::FromEMaxAndE2Max(emax, e2max);
+  std::istream stream(&buf);
+  auto mes = imsrg::detail::StreamFile(stream, emax, e2max,
+                                       index_table.NumberOfMatrixElements());
+  const auto error = buf.Error();
+  imsrg::CheckForError(
+      !error.empty(),
+      fmt::format("Failed to read gzipped ME2JP file at {}: {}", path_to_file,
+                  error));
+  return ME2JPFile(herm, emax, e2max,
+                   imsrg::mexj::MEArray::FromVector(std::move(mes)),
+                   std::move(index_table));
+}
+
+ME2JPFile ME2JPFile::FromMatrixElements(std::vector<double>&& mes,
+                                        HOEnergy emax, Hermiticity herm) {
+  return ME2JPFile(herm, emax, HOEnergy(2 * emax.AsInt()),
+                   imsrg::mexj::MEArray::FromVector(std::move(mes)),
+                   imsrg::mexj::ME2JPIndexTable::FromEMax(emax));
+}
+
+ME2JPFile ME2JPFile::FromBinary(std::string path_to_file, HOEnergy emax,
+                                Hermiticity herm) {
+  auto index_table = imsrg::mexj::ME2JPIndexTable::FromEMax(emax);
+  auto contents = imsrg::mexj::ReadMEXJBinaryFile(
+      path_to_file, imsrg::mexj::MEXJBinaryFormat::kME2JP, emax, herm,
+      index_table.NumberOfMatrixElements());
+  return ME2JPFile(herm, emax, HOEnergy(2 * emax.AsInt()),
+                   std::move(contents.mes), std::move(index_table));
+}
+
+void ME2JPFile::WriteTextFile(const std::string& path_to_file) const {
+  Expects(e2max_ == HOEnergy(2 * emax_.AsInt()));
+  std::ofstream file(path_to_file, std::ios::trunc);
+  imsrg::CheckForError(
+      !file.is_open(),
+      fmt::format("Failed to open ME2JP text file at {}", path_to_file));
+  const auto write = [&file](std::string_view text) {
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+  };
+  file << imsrg::detail::kME2JPTextHeader;
+  imsrg::mexj::FormatDoubles(mes_.data(), mes_.size(), write);
+  imsrg::CheckForError(
+      !file.good(),
+      fmt::format("Failed to write ME2JP text file at {}", path_to_file));
+}
+
+void ME2JPFile::WriteGZippedFile(const std::string& path_to_file) const {
+  Expects(e2max_ == HOEnergy(2 * emax_.AsInt()));
+  imsrg::mexj::GZipFileWriter file(path_to_file);
+  const auto write = [&file](std::string_view text) { file.Write(text); };
+  file.Write(imsrg::detail::kME2JPTextHeader);
+  imsrg::mexj::FormatDoubles(mes_.data(), mes_.size(), write);
+  file.Close();
+}
+
+void ME2JPFile::WriteBinaryFile(const std::string& path_to_file) const {
+  Expects(e2max_ == HOEnergy(2 * emax_.AsInt()));
+  imsrg::mexj::WriteMEXJBinaryFile(path_to_file,
+                                   imsrg::mexj::MEXJBinaryFormat::kME2JP,
+                                   emax_, herm_, 0.0, mes_.data(), mes_.size());
 }
-// ME2JPFile  ME2JPFile::FromGZippedFile(std::string path_to_file, HOEnergy
-// emax,
-//                                  Hermiticity herm) = delete;
-// ME2JPFile  ME2JPFile::FromBinary(std::string path_to_file, HOEnergy emax,
-//                             Hermiticity herm) = delete;
 
 double ME2JPFile::Get2BMatrixElement(const SPState& p, const SPState& q,
                                      const SPState& r, const SPState& s,
                                      TotalAngMom jj_2b) const {
+  return MatrixElementAtLocation(Locate2BMatrixElement(p, q, r, s, jj_2b));
+}
+
+ME2JPElementLocation ME2JPFile::Locate2BMatrixElement(
+    const imsrg::mexj::ME2JPIndexTable& index_table, const SPState& p,
+    const SPState& q, const SPState& r, const SPState& s, TotalAngMom jj_2b) {
   using imsrg::mexj::NLJJT;
-  using imsrg::mexj::NLJJTIndex4;
   using std::swap;
 
   NLJJT nljjt_p(p);
@@ -68,6 +204,7 @@ double ME2JPFile::Get2BMatrixElement(const SPState& p, const SPState& q,
   NLJJT nljjt_s(s);
 
   int factor = 1;
+  bool herm_swapped = false;
   if (nljjt_q.Index() > nljjt_p.Index()) {
     factor *= (imsrg::JJPhase::MinusOne() * nljjt_p.JJ().Phase() *
                nljjt_q.JJ().Phase() * jj_2b.Phase(-1))
@@ -83,21 +220,17 @@ double ME2JPFile::Get2BMatrixElement(const SPState& p, const SPState& q,
   if ((nljjt_r.Index() > nljjt_p.Index()) ||
       ((nljjt_r.Index() == nljjt_p.Index()) &&
        (nljjt_s.Index() > nljjt_q.Index()))) {
-    factor *= herm_.Factor();
+    herm_swapped = true;
     swap(nljjt_r, nljjt_p);
     swap(nljjt_s, nljjt_q);
   }
 
-  NLJJTIndex4 lookup_key(nljjt_p.Index(), nljjt_q.Index(), nljjt_r.Index(),
-                         nljjt_s.Index());
-
-  const auto search = me_lookup_.find(lookup_key);
-  if (search == me_lookup_.end()) {
-    return 0.0;
+  const std::size_t base_index =
+      index_table.Offset(nljjt_p, nljjt_q, nljjt_r, nljjt_s);
+  if (base_index == imsrg::mexj::ME2JPIndexTable::npos) {
+    return {};
   }
 
-  const std::size_t base_index = search->second;
-
   // Handle JJ coupling
   const auto jj_min = std::max(
       imsrg::CouplingMinimum<imsrg::TotalAngMom>(nljjt_p.JJ(), nljjt_q.JJ()),
@@ -107,209 +240,79 @@ double ME2JPFile::Get2BMatrixElement(const SPState& p, const SPState& q,
       imsrg::CouplingMaximum<imsrg::TotalAngMom>(nljjt_r.JJ(), nljjt_s.JJ()));
 
   if ((jj_2b < jj_min) || (jj_2b > jj_max)) {
-    return 0.0;
+    return {};
   }
 
   const std::size_t jj_offset = (jj_2b.AsInt() - jj_min.AsInt()) / 2;
 
-  return factor * mes_[base_index + jj_offset];
+  return ME2JPElementLocation(base_index + jj_offset, factor, herm_swapped);
 }
 
-ME2JPFile::ME2JPFile(
-    Hermiticity herm, std::vector<double>&& mes,
-    absl::flat_hash_map<imsrg::mexj::NLJJTIndex4, std::size_t>&& me_lookup)
-    : herm_(herm), mes_(std::move(mes)), me_lookup_(std::move(me_lookup)) {}
+ME2JPFile::ME2JPFile(Hermiticity herm, HOEnergy emax, HOEnergy e2max,
+                     imsrg::mexj::MEArray&& mes,
+                     imsrg::mexj::ME2JPIndexTable&& index_table)
+    : herm_(herm),
+      emax_(emax),
+      e2max_(e2max),
+      mes_(std::move(mes)),
+      index_table_(std::move(index_table)) {
+  Expects(mes_.size() == index_table_.NumberOfMatrixElements());
+}
 
 namespace detail {
 
-std::size_t GetME2JPSize(imsrg::HOEnergy emax) {
-  const auto basis = imsrg::mexj::GetNLJJTs(emax);
-
-  std::size_t counter = 0;
-
-  for (const auto& nljjt_p : basis) {
-    for (const auto& nljjt_q : basis) {
-      // q <= p
-      if (nljjt_q.Index() > nljjt_p.Index()) {
-        continue;
-      }
-      for (const auto& nljjt_r : basis) {
-        // r, s <= p, q (part 1)
-        if (nljjt_r.Index() > nljjt_p.Index()) {
-          continue;
-        }
-        for (const auto& nljjt_s : basis) {
-          // s <= r
-          if (nljjt_s.Index() > nljjt_r.Index()) {
-            continue;
-          }
-          // r, s <= p, q (part 2)
-          if ((nljjt_r.Index() == nljjt_p.Index()) &&
-              (nljjt_s.Index() > nljjt_q.Index())) {
-            continue;
-          }
-          // parity
-          if (nljjt_p.P() + nljjt_q.P() != nljjt_r.P() + nljjt_s.P()) {
-            continue;
-          }
-          // isospin
-          if (nljjt_p.M_TT() + nljjt_q.M_TT() !=
-              nljjt_r.M_TT() + nljjt_s.M_TT()) {
-            continue;
-          }
-          const auto jj_pq_min = imsrg::CouplingMinimum<imsrg::TotalAngMom>(
-              nljjt_p.JJ(), nljjt_q.JJ());
-          const auto jj_pq_max = imsrg::CouplingMaximum<imsrg::TotalAngMom>(
-              nljjt_p.JJ(), nljjt_q.JJ());
-          const auto jj_rs_min = imsrg::CouplingMinimum<imsrg::TotalAngMom>(
-              nljjt_r.JJ(), nljjt_s.JJ());
-          const auto jj_rs_max = imsrg::CouplingMaximum<imsrg::TotalAngMom>(
-              nljjt_r.JJ(), nljjt_s.JJ());
-          const auto jj_2_min = std::max(jj_pq_min, jj_rs_min);
-          const auto jj_2_max = std::min(jj_pq_max, jj_rs_max);
-
-          const auto range_size =
-              imsrg::CouplingRangeFromMinAndMax<imsrg::TotalAngMom>(jj_2_min,
-                                                                    jj_2_max)
-                  .size();
-
-          counter += range_size;
-        }
-      }
-    }
+std::vector<double> StreamFile(std::istream& stream, HOEnergy emax,
+                               HOEnergy e2max, std::size_t size) {
+  // Process header
+  std::string header;
+  std::getline(stream, header);
+  {
+    const auto [valid_header, msg] = ValidateHeader(header);
+    imsrg::CheckForError(!valid_header, msg);
   }
 
-  return counter;
-}
-
-std::size_t GetME2JPSize_NoJJ(imsrg::HOEnergy emax) {
-  const auto basis = imsrg::mexj::GetNLJJTs(emax);
-
-  std::size_t counter = 0;
-
-  for (const auto& nljjt_p : basis) {
-    for (const auto& nljjt_q : basis) {
-      // q <= p
-      if (nljjt_q.Index() > nljjt_p.Index()) {
-        continue;
-      }
-      for (const auto& nljjt_r : basis) {
-        // r, s <= p, q (part 1)
-        if (nljjt_r.Index() > nljjt_p.Index()) {
-          continue;
-        }
-        for (const auto& nljjt_s : basis) {
-          // s <= r
-          if (nljjt_s.Index() > nljjt_r.Index()) {
-            continue;
-          }
-          // r, s <= p, q (part 2)
-          if ((nljjt_r.Index() == nljjt_p.Index()) &&
-              (nljjt_s.Index() > nljjt_q.Index())) {
-            continue;
-          }
-          // parity
-          if (nljjt_p.P() + nljjt_q.P() != nljjt_r.P() + nljjt_s.P()) {
-            continue;
-          }
-          // isospin
-          if (nljjt_p.M_TT() + nljjt_q.M_TT() !=
-              nljjt_r.M_TT() + nljjt_s.M_TT()) {
-            continue;
-          }
-          const auto jj_pq_min = imsrg::CouplingMinimum<imsrg::TotalAngMom>(
-              nljjt_p.JJ(), nljjt_q.JJ());
-          const auto jj_pq_max = imsrg::CouplingMaximum<imsrg::TotalAngMom>(
-              nljjt_p.JJ(), nljjt_q.JJ());
-          const auto jj_rs_min = imsrg::CouplingMinimum<imsrg::TotalAngMom>(
-              nljjt_r.JJ(), nljjt_s.JJ());
-          const auto jj_rs_max = imsrg::CouplingMaximum<imsrg::TotalAngMom>(
-              nljjt_r.JJ(), nljjt_s.JJ());
-          const auto jj_2_min = std::max(jj_pq_min, jj_rs_min);
-          const auto jj_2_max = std::min(jj_pq_max, jj_rs_max);
-
-          if (jj_2_min <= jj_2_max) {
-            counter += 1;
-          }
-        }
-      }
-    }
+  const auto runs = imsrg::mexj::ME2JPTruncationRuns(emax, e2max);
+  std::size_t num_in_file = 0;
+  for (const auto run : runs) {
+    num_in_file += run;
   }
 
-  return counter;
-}
-
-absl::flat_hash_map<imsrg::mexj::NLJJTIndex4, std::size_t> MakeME2JPIndexLookup(
-    imsrg::HOEnergy emax) {
-  absl::flat_hash_map<imsrg::mexj::NLJJTIndex4, std::size_t> me_lookup;
-  me_lookup.reserve(GetME2JPSize_NoJJ(emax));
-
-  const auto basis = imsrg::mexj::GetNLJJTs(emax);
-
-  std::size_t index = 0;
-  for (const auto& nljjt_p : basis) {
-    for (const auto& nljjt_q : basis) {
-      // q <= p
-      if (nljjt_q.Index() > nljjt_p.Index()) {
-        continue;
+  // Runs alternate between kept (even run index) and dropped.
+  std::vector<double> mes(size, 0.0);
+  std::size_t run_index = 0;
+  std::size_t run_left = runs[0];
+  std::size_t num_kept = 0;
+  const auto consume = [&](const double* values, std::size_t num_values) {
+    while (num_values > 0) {
+      while (run_left == 0) {
+        run_index += 1;
+        run_left = runs[run_index];
       }
-      for (const auto& nljjt_r : basis) {
-        // r, s <= p, q (part 1)
-        if (nljjt_r.Index() > nljjt_p.Index()) {
-          continue;
-        }
-        for (const auto& nljjt_s : basis) {
-          // s <= r
-          if (nljjt_s.Index() > nljjt_r.Index()) {
-            continue;
-          }
-          // r, s <= p, q (part 2)
-          if ((nljjt_r.Index() == nljjt_p.Index()) &&
-              (nljjt_s.Index() > nljjt_q.Index())) {
-            continue;
-          }
-          // parity
-          if (nljjt_p.P() + nljjt_q.P() != nljjt_r.P() + nljjt_s.P()) {
-            continue;
-          }
-          // isospin
-          if (nljjt_p.M_TT() + nljjt_q.M_TT() !=
-              nljjt_r.M_TT() + nljjt_s.M_TT()) {
-            continue;
-          }
-          const auto jj_pq_min = imsrg::CouplingMinimum<imsrg::TotalAngMom>(
-              nljjt_p.JJ(), nljjt_q.JJ());
-          const auto jj_pq_max = imsrg::CouplingMaximum<imsrg::TotalAngMom>(
-              nljjt_p.JJ(), nljjt_q.JJ());
-          const auto jj_rs_min = imsrg::CouplingMinimum<imsrg::TotalAngMom>(
-              nljjt_r.JJ(), nljjt_s.JJ());
-          const auto jj_rs_max = imsrg::CouplingMaximum<imsrg::TotalAngMom>(
-              nljjt_r.JJ(), nljjt_s.JJ());
-          const auto jj_2_min = std::max(jj_pq_min, jj_rs_min);
-          const auto jj_2_max = std::min(jj_pq_max, jj_rs_max);
-
-          const auto range_size =
-              imsrg::CouplingRangeFromMinAndMax<imsrg::TotalAngMom>(jj_2_min,
-                                                                    jj_2_max)
-                  .size();
-
-          if (range_size > 0) {
-            imsrg::mexj::NLJJTIndex4 lookup_key(
-                nljjt_p.Index(), nljjt_q.Index(), nljjt_r.Index(),
-                nljjt_s.Index());
-            me_lookup[lookup_key] = index;
-            index += range_size;
-          }
-        }
+      const auto num = std::min(run_left, num_values);
+      if (run_index % 2 == 0) {
+        std::copy(values, values + num, mes.data() + num_kept);
+        num_kept += num;
       }
+      values += num;
+      num_values -= num;
+      run_left -= num;
     }
-  }
+  };
 
-  return me_lookup;
+  const auto num_read =
+      imsrg::mexj::StreamDoubles(stream, num_in_file, consume);
+  imsrg::CheckForError(
+      num_read < num_in_file,
+      fmt::format("Reached end of ME2JP file before two-body matrix element {} "
+                  "was read.",
+                  num_read));
+  Ensures(num_kept == size);
+
+  return mes;
 }
 
 template <typename S>
-std::vector<double> ReadFile(S&& stream, HOEnergy emax) {
+std::vector<double> ReadFile(S&& stream, std::size_t size) {
   // Process header
   std::string header;
   std::getline(stream, header);
@@ -319,7 +322,6 @@ std::vector<double> ReadFile(S&& stream, HOEnergy emax) {
   }
 
   // Read 2B MEs
-  const auto size = GetME2JPSize(emax);
   std::vector<double> mes(size, 0.0);
   for (std::size_t i = 0; i < size; i += 1) {
     stream >> mes[i];
@@ -329,7 +331,7 @@ std::vector<double> ReadFile(S&& stream, HOEnergy emax) {
 }
 
 template <typename S>
-imsrg::ValidationResult ValidateFile(S&& stream, HOEnergy emax) {
+imsrg::ValidationResult ValidateFile(S&& stream, std::size_t size) {
   // Process header
   std::string header;
   std::getline(stream, header);
@@ -339,7 +341,6 @@ imsrg::ValidationResult ValidateFile(S&& stream, HOEnergy emax) {
   }
 
   double me_2b;
-  const auto size = GetME2JPSize(emax);
   for (std::size_t i = 0; i < size; i += 1) {
     stream >> me_2b;
     if (!stream) {
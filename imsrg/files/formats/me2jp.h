@@ -2,12 +2,14 @@
 #ifndef IMSRG_FILES_FORMATS_ME2JP_H_
 #define IMSRG_FILES_FORMATS_ME2JP_H_
 
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
-#include "absl/container/flat_hash_map.h"
-
+#include "imsrg/assert.h"
+#include "imsrg/files/formats/helpers/binary.h"
+#include "imsrg/files/formats/helpers/me2jp_index.h"
 #include "imsrg/files/formats/helpers/mexj.h"
 #include "imsrg/model_space/single_particle/state.h"
 #include "imsrg/quantum_numbers/hermiticity.h"
@@ -15,35 +17,130 @@
 #include "imsrg/quantum_numbers/total_ang_mom.h"
 
 namespace imsrg {
+
+// Where a matrix element is stored among the matrix elements of an ME2JP
+// file. The matrix element is
+//   Phase() * (HermSwapped() ? herm : 1) * mes[Offset()],
+// and zero if !IsStored() (not stored due to symmetries).
+// This only depends on emax, not on the file contents.
+//
+// Offset, phase, and Hermitian swap are packed into 64 bits, with 0 for
+// matrix elements that are not stored.
+class ME2JPElementLocation {
+ public:
+  // Not stored
+  ME2JPElementLocation() = default;
+
+  // phase = +1 or -1
+  ME2JPElementLocation(std::size_t offset, int phase, bool herm_swapped)
+      : bits_(kStoredBit | (phase < 0 ? kNegativeBit : 0) |
+              (herm_swapped ? kHermSwappedBit : 0) | offset) {
+    Expects((phase == 1) || (phase == -1));
+    Expects(offset <= kOffsetMask);
+  }
+
+  bool IsStored() const { return (bits_ & kStoredBit) != 0; }
+  std::size_t Offset() const { return bits_ & kOffsetMask; }
+  int Phase() const { return (bits_ & kNegativeBit) != 0 ? -1 : 1; }
+  bool HermSwapped() const { return (bits_ & kHermSwappedBit) != 0; }
+
+ private:
+  static constexpr std::uint64_t kStoredBit = std::uint64_t{1} << 63;
+  static constexpr std::uint64_t kNegativeBit = std::uint64_t{1} << 62;
+  static constexpr std::uint64_t kHermSwappedBit = std::uint64_t{1} << 61;
+  static constexpr std::uint64_t kOffsetMask = kHermSwappedBit - 1;
+
+  std::uint64_t bits_ = 0;
+};
+
+static_assert(sizeof(ME2JPElementLocation) == sizeof(std::uint64_t));
+
 class ME2JPFile {
  public:
   static ME2JPFile FromTextFile(std::string path_to_file, HOEnergy emax,
                                 Hermiticity herm);
+
+  // Decompresses on a background thread while parsing.
   static ME2JPFile FromGZippedFile(std::string path_to_file, HOEnergy emax,
-                                   Hermiticity herm) = delete;
+                                   Hermiticity herm);
+
+  // Read a file written for file_emax, keeping only matrix elements up to
+  // emax with e_p + e_q <= e2max and e_r + e_s <= e2max (e.g., the
+  // truncation of a smaller model space). The file is parsed block by block,
+  // so memory scales with the kept matrix elements, not with the file.
+  static ME2JPFile FromTextFile(std::string path_to_file, HOEnergy file_emax,
+                                HOEnergy emax, HOEnergy e2max,
+                                Hermiticity herm);
+  static ME2JPFile FromGZippedFile(std::string path_to_file,
+                                   HOEnergy file_emax, HOEnergy emax,
+                                   HOEnergy e2max, Hermiticity herm);
+
+  // Matrix elements in file order (e.g., from WriteOperatorToME2JP)
+  static ME2JPFile FromMatrixElements(std::vector<double>&& mes, HOEnergy emax,
+                                      Hermiticity herm);
+
+  // Maps a binary file (see helpers/binary.h) and uses the matrix elements
+  // in place, without parsing.
   static ME2JPFile FromBinary(std::string path_to_file, HOEnergy emax,
-                              Hermiticity herm) = delete;
+                              Hermiticity herm);
+
+  // Writers, text is formatted in parallel.
+  // Binary files round-trip bit-exactly. Files truncated to e2max < 2 * emax
+  // cannot be written.
+  void WriteTextFile(const std::string& path_to_file) const;
+  void WriteGZippedFile(const std::string& path_to_file) const;
+  void WriteBinaryFile(const std::string& path_to_file) const;
 
   double Get2BMatrixElement(const SPState& p, const SPState& q,
                             const SPState& r, const SPState& s,
                             TotalAngMom jj_2b) const;
   Hermiticity Herm() const { return herm_; }
+  HOEnergy EMax() const { return emax_; }
+  HOEnergy E2Max() const { return e2max_; }
+
+  // Split Get2BMatrixElement, so locations can be reused across files with
+  // the same emax.
+  ME2JPElementLocation Locate2BMatrixElement(const SPState& p,
+                                             const SPState& q,
+                                             const SPState& r,
+                                             const SPState& s,
+                                             TotalAngMom jj_2b) const {
+    return Locate2BMatrixElement(index_table_, p, q, r, s, jj_2b);
+  }
+
+  // Same for files with the layout of index_table, without a file (e.g.,
+  // while the file is still being read).
+  static ME2JPElementLocation Locate2BMatrixElement(
+      const imsrg::mexj::ME2JPIndexTable& index_table, const SPState& p,
+      const SPState& q, const SPState& r, const SPState& s,
+      TotalAngMom jj_2b);
+  double MatrixElementAtLocation(const ME2JPElementLocation& loc) const {
+    if (!loc.IsStored()) {
+      return 0.0;
+    }
+    return loc.Phase() * (loc.HermSwapped() ? herm_.Factor() : 1) *
+           mes_[loc.Offset()];
+  }
 
   void swap(ME2JPFile& other) noexcept {
     using std::swap;
     swap(herm_, other.herm_);
+    swap(emax_, other.emax_);
+    swap(e2max_, other.e2max_);
     swap(mes_, other.mes_);
-    swap(me_lookup_, other.me_lookup_);
+    swap(index_table_, other.index_table_);
   }
 
  private:
   Hermiticity herm_;
-  std::vector<double> mes_;
-  absl::flat_hash_map<imsrg::mexj::NLJJTIndex4, std::size_t> me_lookup_;
+  HOEnergy emax_;
+  HOEnergy e2max_;
+  imsrg::mexj::MEArray mes_;
+  imsrg::mexj::ME2JPIndexTable index_table_;
 
-  explicit ME2JPFile(
-      Hermiticity herm, std::vector<double>&& mes,
-      absl::flat_hash_map<imsrg::mexj::NLJJTIndex4, std::size_t>&& me_lookup);
+  explicit ME2JPFile(Hermiticity herm, HOEnergy emax, HOEnergy e2max,
+                     imsrg::mexj::MEArray&& mes,
+                     imsrg::mexj::ME2JPIndexTable&& index_table);
 };
 
 inline void swap(ME2JPFile& a, ME2JPFile& b) noexcept { a.swap(b); }
@@ -0,0 +1,71 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/temporary_file.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "fmt/core.h"
+
+#include "imsrg/error.h"
+
+namespace imsrg {
+
+namespace detail {
+static std::string DirectoryOf(const std::string& path_to_file);
+}  // namespace detail
+
+std::string CreateTemporaryFileNextTo(const std::string& path_to_file) {
+  std::string tmp_path = path_to_file + ".tmp.XXXXXX";
+  const int fd = mkstemp(tmp_path.data());
+  imsrg::CheckForError(
+      fd < 0, fmt::format("Failed to create temporary file next to {}: {}",
+                          path_to_file, std::strerror(errno)));
+  // mkstemp creates the file readable by the owner only.
+  fchmod(fd, 0644);
+  close(fd);
+  return tmp_path;
+}
+
+bool MoveTemporaryFileIntoPlace(const std::string& tmp_path,
+                                const std::string& path_to_file) {
+  if (std::rename(tmp_path.c_str(), path_to_file.c_str()) != 0) {
+    RemoveTemporaryFile(tmp_path);
+    return false;
+  }
+
+  // Not all file systems support syncing directories, the move itself
+  // succeeded either way.
+  const int dir_fd = open(imsrg::detail::DirectoryOf(path_to_file).c_str(),
+                          O_RDONLY | O_DIRECTORY);
+  if (dir_fd >= 0) {
+    fsync(dir_fd);
+    close(dir_fd);
+  }
+  return true;
+}
+
+void RemoveTemporaryFile(const std::string& tmp_path) {
+  std::remove(tmp_path.c_str());
+}
+
+namespace detail {
+std::string DirectoryOf(const std::string& path_to_file) {
+  const auto pos = path_to_file.find_last_of('/');
+  if (pos == std::string::npos) {
+    return ".";
+  }
+  if (pos == 0) {
+    return "/";
+  }
+  return path_to_file.substr(0, pos);
+}
+}  // namespace detail
+
+}  // namespace imsrg
@@ -0,0 +1,27 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_FILES_TEMPORARY_FILE_H_
+#define IMSRG_FILES_TEMPORARY_FILE_H_
+
+#include <string>
+
+namespace imsrg {
+
+// Files are written to a uniquely named temporary file next to their final
+// path and then moved into place, so readers never see a partial file and
+// concurrent writers of the same path (e.g., several processes filling a
+// shared cache) never write to the same temporary file. The last move wins.
+
+// Creates an empty temporary file next to path_to_file and returns its path.
+std::string CreateTemporaryFileNextTo(const std::string& path_to_file);
+
+// Moves tmp_path to path_to_file and syncs the directory, so the move
+// survives a crash. Returns false and removes tmp_path if the move fails.
+bool MoveTemporaryFileIntoPlace(const std::string& tmp_path,
+                                const std::string& path_to_file);
+
+// Removes tmp_path after a failed write.
+void RemoveTemporaryFile(const std::string& tmp_path);
+
+}  // namespace imsrg
+
+#endif  // IMSRG_FILES_TEMPORARY_FILE_H_
@@ -0,0 +1,28 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/model_space/scalar/model_space.h"
+
+#include <memory>
+
+#include "imsrg/assert.h"
+#include "imsrg/model_space/scalar/one_body/model_space.h"
+#include "imsrg/model_space/scalar/two_body/model_space.h"
+#include "imsrg/model_space/single_particle/model_space.h"
+
+namespace imsrg {
+
+std::shared_ptr<const ScalarModelSpace> ScalarModelSpace::FromSPModelSpace(
+    const std::shared_ptr<const SPModelSpace>& sp_ms) {
+  return std::make_shared<const ScalarModelSpace>(
+      sp_ms, Scalar1BModelSpace::FromSPModelSpace(sp_ms),
+      Scalar2BModelSpace::FromSPModelSpace(sp_ms));
+}
+
+ScalarModelSpace::ScalarModelSpace(
+    const std::shared_ptr<const SPModelSpace>& sp_ms,
+    const std::shared_ptr<const Scalar1BModelSpace>& ms_1b,
+    const std::shared_ptr<const Scalar2BModelSpace>& ms_2b)
+    : sp_ms_(sp_ms), ms_1b_(ms_1b), ms_2b_(ms_2b) {
+  Expects(ms_2b_->SingleParticleModelSpacePtr() == sp_ms_);
+}
+
+}  // namespace imsrg
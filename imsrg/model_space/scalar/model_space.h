@@ -0,0 +1,71 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_MODEL_SPACE_SCALAR_MODEL_SPACE_H_
+#define IMSRG_MODEL_SPACE_SCALAR_MODEL_SPACE_H_
+
+#include <memory>
+#include <utility>
+
+#include "imsrg/model_space/scalar/one_body/model_space.h"
+#include "imsrg/model_space/scalar/two_body/model_space.h"
+#include "imsrg/model_space/single_particle/model_space.h"
+
+namespace imsrg {
+// One- and two-body scalar model spaces built on the same single-particle
+// model space.
+class ScalarModelSpace {
+ public:
+  static std::shared_ptr<const ScalarModelSpace> FromSPModelSpace(
+      const std::shared_ptr<const SPModelSpace>& sp_ms);
+
+  // Ctor from 1B and 2B model spaces
+  // YOU SHOULD NOT CALL THIS DIRECTLY.
+  explicit ScalarModelSpace(
+      const std::shared_ptr<const SPModelSpace>& sp_ms,
+      const std::shared_ptr<const Scalar1BModelSpace>& ms_1b,
+      const std::shared_ptr<const Scalar2BModelSpace>& ms_2b);
+
+  // Not copyable or movable (only pointers)
+  ScalarModelSpace(const ScalarModelSpace&) = delete;
+  ScalarModelSpace& operator=(const ScalarModelSpace&) = delete;
+  ScalarModelSpace(ScalarModelSpace&&) = delete;
+  ScalarModelSpace& operator=(ScalarModelSpace&&) = delete;
+
+  // Default dtor
+
+  const std::shared_ptr<const SPModelSpace>& SingleParticleModelSpacePtr()
+      const {
+    return sp_ms_;
+  }
+  const SPModelSpace& SingleParticleModelSpace() const { return *sp_ms_; }
+
+  const std::shared_ptr<const Scalar1BModelSpace>& OneBodyModelSpacePtr()
+      const {
+    return ms_1b_;
+  }
+  const Scalar1BModelSpace& OneBodyModelSpace() const { return *ms_1b_; }
+
+  const std::shared_ptr<const Scalar2BModelSpace>& TwoBodyModelSpacePtr()
+      const {
+    return ms_2b_;
+  }
+  const Scalar2BModelSpace& TwoBodyModelSpace() const { return *ms_2b_; }
+
+  void swap(ScalarModelSpace& other) noexcept {
+    using std::swap;
+    swap(sp_ms_, other.sp_ms_);
+    swap(ms_1b_, other.ms_1b_);
+    swap(ms_2b_, other.ms_2b_);
+  }
+
+ private:
+  std::shared_ptr<const SPModelSpace> sp_ms_;
+  std::shared_ptr<const Scalar1BModelSpace> ms_1b_;
+  std::shared_ptr<const Scalar2BModelSpace> ms_2b_;
+};
+
+inline void swap(ScalarModelSpace& a, ScalarModelSpace& b) noexcept {
+  a.swap(b);
+}
+}  // namespace imsrg
+
+#endif  // IMSRG_MODEL_SPACE_SCALAR_MODEL_SPACE_H_
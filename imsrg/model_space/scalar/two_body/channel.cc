@@ -1,22 +1,37 @@
 // Copyright 2022 Matthias Heinz
 #include "imsrg/model_space/scalar/two_body/channel.h"
 
+#include <array>
+#include <cstdint>
 #include <utility>
 
+#include "imsrg/assert.h"
 #include "imsrg/model_space/scalar/two_body/channel_key.h"
-#include "imsrg/model_space/scalar/two_body/state_channel.h"
-#include "imsrg/quantum_numbers/total_ang_mom.h"
+#include "imsrg/model_space/single_particle/model_space.h"
 
 namespace imsrg {
 
-Scalar2BChannel::Scalar2BChannel(const Scalar2BStateChannel& bra_chan,
-                                 const Scalar2BStateChannel& ket_chan,
-                                 TotalAngMom jj_2b)
-    : bra_chan_(bra_chan),
-      ket_chan_(ket_chan),
-      full_chan_key_(
-          {bra_chan_.p_chan.ChannelKey(), bra_chan_.q_chan.ChannelKey()},
-          {ket_chan_.p_chan.ChannelKey(), ket_chan_.q_chan.ChannelKey()},
-          jj_2b) {}
+Scalar2BChannel::Scalar2BChannel(const SPModelSpace& sp_ms,
+                                 Scalar2BChannelKey chankey)
+    : sp_ms_(&sp_ms),
+      full_chan_key_(chankey),
+      dims_({static_cast<std::uint32_t>(
+                 sp_ms.ChannelDim(chankey.BraChannelKey().p_chan_key)),
+             static_cast<std::uint32_t>(
+                 sp_ms.ChannelDim(chankey.BraChannelKey().q_chan_key)),
+             static_cast<std::uint32_t>(
+                 sp_ms.ChannelDim(chankey.KetChannelKey().p_chan_key)),
+             static_cast<std::uint32_t>(
+                 sp_ms.ChannelDim(chankey.KetChannelKey().q_chan_key))}) {}
+
+Scalar2BChannel::Scalar2BChannel(const SPModelSpace& sp_ms,
+                                 Scalar2BChannelKey chankey,
+                                 const std::array<std::uint32_t, 4>& dims)
+    : sp_ms_(&sp_ms), full_chan_key_(chankey), dims_(dims) {
+  Expects(dims_[0] <= sp_ms.ChannelDim(chankey.BraChannelKey().p_chan_key));
+  Expects(dims_[1] <= sp_ms.ChannelDim(chankey.BraChannelKey().q_chan_key));
+  Expects(dims_[2] <= sp_ms.ChannelDim(chankey.KetChannelKey().p_chan_key));
+  Expects(dims_[3] <= sp_ms.ChannelDim(chankey.KetChannelKey().q_chan_key));
+}
 
 }  // namespace imsrg
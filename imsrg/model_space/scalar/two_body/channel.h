@@ -2,42 +2,65 @@
 #ifndef IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_CHANNEL_H_
 #define IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_CHANNEL_H_
 
+#include <array>
+#include <cstdint>
 #include <utility>
 
 #include "imsrg/model_space/scalar/two_body/channel_key.h"
-#include "imsrg/model_space/scalar/two_body/state_channel.h"
 #include "imsrg/model_space/single_particle/channel.h"
-#include "imsrg/quantum_numbers/total_ang_mom.h"
+#include "imsrg/model_space/single_particle/model_space.h"
 
 namespace imsrg {
 
+// Compact channel record: the channel key and SP channel dims. SP channels
+// are resolved through the SPModelSpace, which must outlive the channel (the
+// owning Scalar2BModelSpace keeps it alive).
+//
+// Dims may be smaller than the SP channel sizes (e2max truncation). They
+// always cover the leading states of each SP channel.
 class Scalar2BChannel {
  public:
-  explicit Scalar2BChannel(const Scalar2BStateChannel& bra_chan,
-                           const Scalar2BStateChannel& ket_chan,
-                           TotalAngMom jj_2b);
-
-  const Scalar2BStateChannel& BraStateChannel() const { return bra_chan_; }
-  const Scalar2BStateChannel& KetStateChannel() const { return ket_chan_; }
-  const SPChannel& BraChannel1() const { return bra_chan_.p_chan; }
-  const SPChannel& BraChannel2() const { return bra_chan_.q_chan; }
-  const SPChannel& KetChannel1() const { return ket_chan_.p_chan; }
-  const SPChannel& KetChannel2() const { return ket_chan_.q_chan; }
+  // Full SP channel dims
+  explicit Scalar2BChannel(const SPModelSpace& sp_ms,
+                           Scalar2BChannelKey chankey);
+
+  explicit Scalar2BChannel(const SPModelSpace& sp_ms,
+                           Scalar2BChannelKey chankey,
+                           const std::array<std::uint32_t, 4>& dims);
+
+  // Default copy, move, and dtor
+
+  const SPChannel& BraChannel1() const {
+    return sp_ms_->Channel(full_chan_key_.BraChannelKey().p_chan_key);
+  }
+  const SPChannel& BraChannel2() const {
+    return sp_ms_->Channel(full_chan_key_.BraChannelKey().q_chan_key);
+  }
+  const SPChannel& KetChannel1() const {
+    return sp_ms_->Channel(full_chan_key_.KetChannelKey().p_chan_key);
+  }
+  const SPChannel& KetChannel2() const {
+    return sp_ms_->Channel(full_chan_key_.KetChannelKey().q_chan_key);
+  }
+
+  std::size_t BraDim1() const { return dims_[0]; }
+  std::size_t BraDim2() const { return dims_[1]; }
+  std::size_t KetDim1() const { return dims_[2]; }
+  std::size_t KetDim2() const { return dims_[3]; }
+
   Scalar2BChannelKey ChannelKey() const { return full_chan_key_; }
 
   void swap(Scalar2BChannel& other) noexcept {
     using std::swap;
-    swap(bra_chan_, other.bra_chan_);
-    swap(ket_chan_, other.ket_chan_);
+    swap(sp_ms_, other.sp_ms_);
     swap(full_chan_key_, other.full_chan_key_);
+    swap(dims_, other.dims_);
   }
 
  private:
-  // TODO(mheinz): consider reimplementing with pointer to SPModelSpace to save
-  // memory
-  Scalar2BStateChannel bra_chan_;
-  Scalar2BStateChannel ket_chan_;
+  const SPModelSpace* sp_ms_;
   Scalar2BChannelKey full_chan_key_;
+  std::array<std::uint32_t, 4> dims_;
 };
 
 inline void swap(Scalar2BChannel& a, Scalar2BChannel& b) noexcept { a.swap(b); }
@@ -0,0 +1,115 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/model_space/scalar/two_body/channel_index_lookup.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+#include "imsrg/assert.h"
+#include "imsrg/model_space/scalar/two_body/channel.h"
+#include "imsrg/model_space/single_particle/model_space.h"
+#include "imsrg/quantum_numbers/isospin_projection.h"
+#include "imsrg/quantum_numbers/parity.h"
+
+namespace imsrg {
+
+Scalar2BChannelIndexLookup Scalar2BChannelIndexLookup::FromChannels(
+    const SPModelSpace& sp_ms, const std::vector<Scalar2BChannel>& chans) {
+  Expects(chans.size() < kAbsent);
+  const auto& sp_chans = sp_ms.Channels();
+  const auto num_sp_chans = sp_chans.size();
+
+  std::size_t max_sp_index = 0;
+  for (const auto& chan : sp_chans) {
+    max_sp_index = std::max(max_sp_index, chan.Index());
+  }
+  std::vector<std::uint32_t> sp_positions(max_sp_index + 1, kAbsent);
+  for (std::size_t pos = 0; pos < num_sp_chans; pos += 1) {
+    sp_positions[sp_chans[pos].Index()] = static_cast<std::uint32_t>(pos);
+  }
+
+  // Blocks of pairs with equal total parity and isospin projection
+  absl::flat_hash_map<std::pair<Parity, IsospinProj>, std::uint32_t> block_ids;
+  std::vector<std::uint32_t> block_sizes;
+  std::vector<PairEntry> pairs(num_sp_chans * num_sp_chans);
+  for (std::size_t pos_p = 0; pos_p < num_sp_chans; pos_p += 1) {
+    for (std::size_t pos_q = 0; pos_q < num_sp_chans; pos_q += 1) {
+      const auto& chan_p = sp_chans[pos_p];
+      const auto& chan_q = sp_chans[pos_q];
+      const auto [it, inserted] = block_ids.try_emplace(
+          {chan_p.P() + chan_q.P(), chan_p.M_TT() + chan_q.M_TT()},
+          static_cast<std::uint32_t>(block_sizes.size()));
+      if (inserted) {
+        block_sizes.push_back(0);
+      }
+      auto& pair = pairs[pos_p * num_sp_chans + pos_q];
+      pair.block = it->second;
+      pair.column = block_sizes[pair.block];
+      block_sizes[pair.block] += 1;
+    }
+  }
+
+  std::vector<std::size_t> block_offsets(block_sizes.size(), 0);
+  std::size_t num_ranges = 0;
+  for (std::size_t block = 0; block < block_sizes.size(); block += 1) {
+    block_offsets[block] = num_ranges;
+    num_ranges += static_cast<std::size_t>(block_sizes[block]) *
+                  static_cast<std::size_t>(block_sizes[block]);
+  }
+  Expects(num_ranges < kAbsent);
+  for (auto& pair : pairs) {
+    pair.row_offset = static_cast<std::uint32_t>(
+        block_offsets[pair.block] + pair.column * block_sizes[pair.block]);
+  }
+
+  std::vector<ChannelRange> ranges(num_ranges, {kAbsent, 0, 0});
+  for (std::size_t index = 0; index < chans.size(); index += 1) {
+    const auto chankey = chans[index].ChannelKey();
+    const auto bra = chankey.BraChannelKey();
+    const auto ket = chankey.KetChannelKey();
+    const auto pos_p = sp_positions[bra.p_chan_key.Index()];
+    const auto pos_q = sp_positions[bra.q_chan_key.Index()];
+    const auto pos_r = sp_positions[ket.p_chan_key.Index()];
+    const auto pos_s = sp_positions[ket.q_chan_key.Index()];
+    const auto& pair_pq = pairs[pos_p * num_sp_chans + pos_q];
+    const auto& pair_rs = pairs[pos_r * num_sp_chans + pos_s];
+    Expects(pair_pq.block == pair_rs.block);
+
+    const auto jj = chankey.OpChannel().JJ().AsInt();
+    auto& range = ranges[pair_pq.row_offset + pair_rs.column];
+    if (range.first_index == kAbsent) {
+      range.first_index = static_cast<std::uint32_t>(index);
+      range.jj_min = static_cast<std::int8_t>(jj);
+      range.num_jj = 1;
+    } else {
+      // J values of one (p, q, r, s) must be contiguous and increasing
+      Expects(index == range.first_index + range.num_jj);
+      Expects(jj == range.jj_min + 2 * range.num_jj);
+      range.num_jj += 1;
+    }
+  }
+
+  return Scalar2BChannelIndexLookup(std::move(sp_positions), num_sp_chans,
+                                    std::move(pairs), std::move(ranges));
+}
+
+Scalar2BChannelIndexLookup::Scalar2BChannelIndexLookup(
+    std::vector<std::uint32_t>&& sp_positions, std::size_t num_sp_chans,
+    std::vector<PairEntry>&& pairs, std::vector<ChannelRange>&& ranges)
+    : sp_positions_(std::move(sp_positions)),
+      num_sp_chans_(num_sp_chans),
+      pairs_(std::move(pairs)),
+      ranges_(std::move(ranges)) {
+  Expects(num_sp_chans_ * num_sp_chans_ == pairs_.size());
+}
+
+std::size_t Scalar2BChannelIndexLookup::SizeInBytes() const {
+  return sp_positions_.size() * sizeof(std::uint32_t) +
+         pairs_.size() * sizeof(PairEntry) +
+         ranges_.size() * sizeof(ChannelRange);
+}
+
+}  // namespace imsrg
@@ -0,0 +1,125 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_CHANNEL_INDEX_LOOKUP_H_
+#define IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_CHANNEL_INDEX_LOOKUP_H_
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "imsrg/model_space/scalar/two_body/bare_channel_key.h"
+#include "imsrg/model_space/scalar/two_body/channel.h"
+#include "imsrg/model_space/scalar/two_body/channel_key.h"
+#include "imsrg/model_space/single_particle/channel_key.h"
+#include "imsrg/model_space/single_particle/model_space.h"
+
+namespace imsrg {
+
+// Direct-indexed map from Scalar2BChannelKey to channel index.
+//
+// SP channels are numbered by their position in the SPModelSpace. Ordered
+// pairs (p, q) of SP channels with the same total parity and isospin
+// projection form a block, and for each (bra pair, ket pair) in a block the
+// table holds the index of the first channel and its J range. Channels of one
+// (p, q, r, s) must be contiguous and in increasing J, so the channel index is
+// first index + (J - Jmin) / 2. A lookup is a few array loads, no hashing.
+class Scalar2BChannelIndexLookup {
+ public:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  static Scalar2BChannelIndexLookup FromChannels(
+      const SPModelSpace& sp_ms, const std::vector<Scalar2BChannel>& chans);
+
+  // Default copy, move, and dtor
+
+  // Channels of one (p, q, r, s) are first_index + i for i < num_jj, with
+  // 2 * J = jj_min + 2 * i.
+  struct ChannelRange {
+    std::uint32_t first_index;
+    std::int8_t jj_min;
+    std::uint8_t num_jj;
+  };
+
+  // Index of chankey, npos if it is not in the lookup.
+  std::size_t Find(Scalar2BChannelKey chankey) const {
+    const auto bra = chankey.BraChannelKey();
+    const auto ket = chankey.KetChannelKey();
+    const auto range = FindRange(
+        {bra.p_chan_key, bra.q_chan_key, ket.p_chan_key, ket.q_chan_key});
+    const int jj_diff = chankey.OpChannel().JJ().AsInt() - range.jj_min;
+    if ((range.num_jj == 0) || (jj_diff < 0) || (jj_diff % 2 != 0) ||
+        (jj_diff / 2 >= range.num_jj)) {
+      return npos;
+    }
+    return range.first_index + jj_diff / 2;
+  }
+
+  // Range of all channels of (p, q, r, s), num_jj = 0 if there are none.
+  ChannelRange FindRange(Scalar2BBareChannelKey sp_chankeys) const {
+    const auto pos_p = SPChannelPosition(sp_chankeys.chankey_1);
+    const auto pos_q = SPChannelPosition(sp_chankeys.chankey_2);
+    const auto pos_r = SPChannelPosition(sp_chankeys.chankey_3);
+    const auto pos_s = SPChannelPosition(sp_chankeys.chankey_4);
+    if ((pos_p == kAbsent) || (pos_q == kAbsent) || (pos_r == kAbsent) ||
+        (pos_s == kAbsent)) {
+      return {kAbsent, 0, 0};
+    }
+
+    const auto& pair_pq = pairs_[pos_p * num_sp_chans_ + pos_q];
+    const auto& pair_rs = pairs_[pos_r * num_sp_chans_ + pos_s];
+    if (pair_pq.block != pair_rs.block) {
+      return {kAbsent, 0, 0};
+    }
+    return ranges_[pair_pq.row_offset + pair_rs.column];
+  }
+
+  std::size_t SizeInBytes() const;
+
+  void swap(Scalar2BChannelIndexLookup& other) noexcept {
+    using std::swap;
+    swap(sp_positions_, other.sp_positions_);
+    swap(num_sp_chans_, other.num_sp_chans_);
+    swap(pairs_, other.pairs_);
+    swap(ranges_, other.ranges_);
+  }
+
+ private:
+  static constexpr std::uint32_t kAbsent =
+      std::numeric_limits<std::uint32_t>::max();
+
+  struct PairEntry {
+    std::uint32_t block;
+    // Start of this pair's row in ranges_ when it is the bra pair
+    std::uint32_t row_offset;
+    // Position of this pair in its block when it is the ket pair
+    std::uint32_t column;
+  };
+
+  // Indexed by SPChannelKey::Index()
+  std::vector<std::uint32_t> sp_positions_;
+  std::size_t num_sp_chans_;
+  std::vector<PairEntry> pairs_;
+  std::vector<ChannelRange> ranges_;
+
+  explicit Scalar2BChannelIndexLookup(std::vector<std::uint32_t>&& sp_positions,
+                                      std::size_t num_sp_chans,
+                                      std::vector<PairEntry>&& pairs,
+                                      std::vector<ChannelRange>&& ranges);
+
+  std::uint32_t SPChannelPosition(SPChannelKey chankey) const {
+    const auto index = chankey.Index();
+    if (index >= sp_positions_.size()) {
+      return kAbsent;
+    }
+    return sp_positions_[index];
+  }
+};
+
+inline void swap(Scalar2BChannelIndexLookup& a,
+                 Scalar2BChannelIndexLookup& b) noexcept {
+  a.swap(b);
+}
+
+}  // namespace imsrg
+
+#endif  // IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_CHANNEL_INDEX_LOOKUP_H_
@@ -0,0 +1,40 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/model_space/scalar/two_body/channel_layout.h"
+
+#include <utility>
+#include <vector>
+
+#include "imsrg/assert.h"
+#include "imsrg/model_space/scalar/two_body/channel.h"
+
+namespace imsrg {
+
+Scalar2BChannelLayout Scalar2BChannelLayout::FromChannels(
+    const std::vector<Scalar2BChannel>& chans) {
+  std::vector<Dims> dims;
+  std::vector<std::size_t> offsets;
+  dims.reserve(chans.size());
+  offsets.reserve(chans.size() + 1);
+
+  offsets.push_back(0);
+  for (const auto& chan : chans) {
+    dims.push_back(
+        {chan.BraDim1(), chan.BraDim2(), chan.KetDim1(), chan.KetDim2()});
+    offsets.push_back(offsets.back() + chan.BraDim1() * chan.BraDim2() *
+                                           chan.KetDim1() * chan.KetDim2());
+  }
+
+  return Scalar2BChannelLayout(std::move(dims), std::move(offsets));
+}
+
+Scalar2BChannelLayout::Scalar2BChannelLayout(std::vector<Dims>&& dims,
+                                             std::vector<std::size_t>&& offsets)
+    : dims_(std::move(dims)), offsets_(std::move(offsets)) {
+  Expects(offsets_.size() == dims_.size() + 1);
+}
+
+std::size_t Scalar2BChannelLayout::SizeInBytes() const {
+  return dims_.size() * sizeof(Dims) + offsets_.size() * sizeof(std::size_t);
+}
+
+}  // namespace imsrg
@@ -0,0 +1,69 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_CHANNEL_LAYOUT_H_
+#define IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_CHANNEL_LAYOUT_H_
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "imsrg/model_space/scalar/two_body/channel.h"
+
+namespace imsrg {
+
+// Tensor shapes of the channels of a two-body model space and their offsets
+// in one contiguous (column-major) buffer of all matrix elements.
+//
+// Built once with the model space and shared by all operators on it, so
+// operators only hold matrix elements and creating one does not rebuild any
+// per-channel metadata.
+class Scalar2BChannelLayout {
+ public:
+  using Dims = std::array<std::size_t, 4>;
+
+  static Scalar2BChannelLayout FromChannels(
+      const std::vector<Scalar2BChannel>& chans);
+
+  // Default copy, move, and dtor
+
+  std::size_t NumberOfChannels() const { return dims_.size(); }
+
+  const Dims& ChannelDims(std::size_t index) const { return dims_[index]; }
+
+  // Dims of all channels, indexed by channel index
+  const std::vector<Dims>& AllChannelDims() const { return dims_; }
+
+  // Offset of the first element of channel index
+  std::size_t Offset(std::size_t index) const { return offsets_[index]; }
+
+  // Number of elements in channel index
+  std::size_t ChannelSize(std::size_t index) const {
+    return offsets_[index + 1] - offsets_[index];
+  }
+
+  // Number of elements in all channels
+  std::size_t TotalSize() const { return offsets_.back(); }
+
+  std::size_t SizeInBytes() const;
+
+  void swap(Scalar2BChannelLayout& other) noexcept {
+    using std::swap;
+    swap(dims_, other.dims_);
+    swap(offsets_, other.offsets_);
+  }
+
+ private:
+  std::vector<Dims> dims_;
+  // NumberOfChannels() + 1 entries
+  std::vector<std::size_t> offsets_;
+
+  explicit Scalar2BChannelLayout(std::vector<Dims>&& dims,
+                                 std::vector<std::size_t>&& offsets);
+};
+
+inline void swap(Scalar2BChannelLayout& a, Scalar2BChannelLayout& b) noexcept {
+  a.swap(b);
+}
+
+}  // namespace imsrg
+
+#endif  // IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_CHANNEL_LAYOUT_H_
@@ -1,56 +1,144 @@
 // Copyright 2022 Matthias Heinz
 #include "imsrg/model_space/scalar/two_body/model_space.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "fmt/core.h"
+#include "spdlog/spdlog.h"
 
 #include "imsrg/assert.h"
+#include "imsrg/error.h"
 #include "imsrg/model_space/scalar/two_body/bare_channel_key.h"
 #include "imsrg/model_space/scalar/two_body/channel.h"
+#include "imsrg/model_space/scalar/two_body/channel_index_lookup.h"
 #include "imsrg/model_space/scalar/two_body/channel_key.h"
+#include "imsrg/model_space/scalar/two_body/channel_layout.h"
+#include "imsrg/model_space/scalar/two_body/pandya_channel_table.h"
 #include "imsrg/model_space/scalar/two_body/pandya_operator_channel.h"
+#include "imsrg/model_space/scalar/two_body/pandya_recoupling_table.h"
 #include "imsrg/model_space/scalar/two_body/state_channel_key.h"
 #include "imsrg/model_space/single_particle/model_space.h"
+#include "imsrg/openmp_runtime.h"
 #include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/isospin_projection.h"
+#include "imsrg/quantum_numbers/parity.h"
 #include "imsrg/quantum_numbers/total_ang_mom.h"
 
 namespace imsrg {
 
 namespace detail {
-static absl::flat_hash_map<imsrg::Scalar2BChannelKey, std::size_t>
-GenerateChannelIndexLookup(const std::vector<imsrg::Scalar2BChannel>& chans);
+// Pair of SP channels (indices into SPModelSpace::Channels())
+// with the range of J they couple to and the number of leading states of
+// each channel kept in the pair.
+struct SPChannelPair {
+  std::size_t index_p;
+  std::size_t index_q;
+  imsrg::TotalAngMom jj_min;
+  imsrg::TotalAngMom jj_max;
+  std::uint32_t dim_p;
+  std::uint32_t dim_q;
+};
+
+static std::vector<SPChannelPair> GenerateSPChannelPairs(
+    const imsrg::SPModelSpace& sp_ms);
+
+// Drops pairs with no state below e2max and shrinks the dims of the others.
+static std::vector<SPChannelPair> TruncateSPChannelPairs(
+    const imsrg::SPModelSpace& sp_ms, const std::vector<SPChannelPair>& pairs,
+    imsrg::HOEnergy e2max);
+
+// e2max that keeps every two-body state
+static imsrg::HOEnergy UntruncatedE2Max(const imsrg::SPModelSpace& sp_ms);
+
+// Dims of kept pairs indexed by pos_p * num_sp_chans + pos_q ({0, 0} if the
+// pair was dropped)
+static std::vector<std::array<std::uint32_t, 2>> GeneratePairDimsLookup(
+    const imsrg::SPModelSpace& sp_ms, const std::vector<SPChannelPair>& pairs);
+
+static std::pair<std::vector<imsrg::Scalar2BChannel>,
+                 std::vector<imsrg::Scalar2BBareChannelKey>>
+GenerateChannelsAndBareChannels(const imsrg::SPModelSpace& sp_ms,
+                                const std::vector<SPChannelPair>& pairs);
 
 static absl::flat_hash_map<imsrg::Scalar2BOpChannel,
                            std::vector<imsrg::Scalar2BStateChannelKey>>
-Generate2BStateKeyLookup(const imsrg::SPModelSpace& sp_ms);
+Generate2BStateKeyLookup(const imsrg::SPModelSpace& sp_ms,
+                         const std::vector<SPChannelPair>& pairs);
 
 static absl::flat_hash_map<imsrg::Scalar2BPandyaOpChannel,
                            std::vector<imsrg::Scalar2BStateChannelKey>>
-Generate2BPandyaStateKeyLookup(const imsrg::SPModelSpace& sp_ms);
-
-static std::vector<imsrg::Scalar2BBareChannelKey> GenerateBareChannels(
+Generate2BPandyaStateKeyLookup(const imsrg::SPModelSpace& sp_ms,
+                               const std::vector<SPChannelPair>& pairs);
+
+// Cache file layout:
+// Scalar2BModelSpaceCacheHeader
+// SPChannelCacheRecord x num_sp_chans
+// ChannelCacheRecord x num_chans
+// BareChannelCacheRecord x num_bare_chans
+struct Scalar2BModelSpaceCacheHeader {
+  std::uint64_t magic;
+  std::uint64_t version;
+  std::uint64_t num_sp_chans;
+  std::uint64_t num_chans;
+  std::uint64_t num_bare_chans;
+  std::uint64_t e2max;
+};
+
+struct SPChannelCacheRecord {
+  std::uint32_t chankey_index;
+  std::uint32_t dim;
+};
+
+// SP channel positions of p, q, r, s and 2 * J
+using ChannelCacheRecord = std::array<std::uint16_t, 5>;
+
+// SP channel positions of p, q, r, s
+using BareChannelCacheRecord = std::array<std::uint16_t, 4>;
+
+// "IMSRG2BM"
+constexpr std::uint64_t kCacheMagic = 0x4D42324753524D49;
+// Bump whenever the layout or the channel ordering changes.
+constexpr std::uint64_t kCacheVersion = 2;
+
+static std::vector<SPChannelCacheRecord> MakeSPChannelCacheRecords(
     const imsrg::SPModelSpace& sp_ms);
-}  // namespace detail
 
-bool Scalar2BModelSpace::IsChannelInModelSpace(
-    Scalar2BChannelKey chankey) const {
-  const auto search = chan_index_lookup_.find(chankey);
-  return search != chan_index_lookup_.end();
-}
+static std::size_t CacheFileSize(const Scalar2BModelSpaceCacheHeader& header);
 
-std::size_t Scalar2BModelSpace::IndexOfChannelInModelSpace(
-    Scalar2BChannelKey chankey) const {
-  // Expects(IsChannelInModelSpace(chankey));
-  // ^ We check this later
-  const auto search = chan_index_lookup_.find(chankey);
-  Expects(search != chan_index_lookup_.end());
+// Read-only private mapping of a whole file, unmapped on destruction.
+class MappedCacheFile {
+ public:
+  explicit MappedCacheFile(const std::string& path);
+  ~MappedCacheFile();
 
-  return search->second;
-}
+  MappedCacheFile(const MappedCacheFile&) = delete;
+  MappedCacheFile& operator=(const MappedCacheFile&) = delete;
+
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+}  // namespace detail
 
 const std::vector<Scalar2BStateChannelKey>&
 Scalar2BModelSpace::GetStateChannelsInOperatorChannel(
@@ -70,58 +158,251 @@ Scalar2BModelSpace::GetStateChannelsInPandyaOperatorChannel(
 
 std::shared_ptr<const Scalar2BModelSpace> Scalar2BModelSpace::FromSPModelSpace(
     const std::shared_ptr<const SPModelSpace>& sp_ms) {
-  const auto& sp_chans = sp_ms->Channels();
-  std::vector<Scalar2BChannel> chans;
+  return FromSPModelSpaceAndE2Max(sp_ms,
+                                  imsrg::detail::UntruncatedE2Max(*sp_ms));
+}
+
+std::shared_ptr<const Scalar2BModelSpace>
+Scalar2BModelSpace::FromSPModelSpaceAndE2Max(
+    const std::shared_ptr<const SPModelSpace>& sp_ms, HOEnergy e2max) {
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const auto all_pairs = imsrg::detail::GenerateSPChannelPairs(*sp_ms);
+  const auto pairs =
+      imsrg::detail::TruncateSPChannelPairs(*sp_ms, all_pairs, e2max);
+  auto [chans, bare_chans] =
+      imsrg::detail::GenerateChannelsAndBareChannels(*sp_ms, pairs);
 
-  for (const auto& chan_p : sp_chans) {
-    for (const auto& chan_q : sp_chans) {
-      // if (chan_q.Index() > chan_p.Index()) {
-      //   continue;
-      // }
-      // p, q coupling range
-      const auto jj_pq_min =
-          CouplingMinimum<TotalAngMom>(chan_p.JJ(), chan_q.JJ());
-      const auto jj_pq_max =
-          CouplingMaximum<TotalAngMom>(chan_p.JJ(), chan_q.JJ());
-      for (const auto& chan_r : sp_chans) {
-        for (const auto& chan_s : sp_chans) {
-          // if (chan_s.Index() > chan_r.Index()) {
-          //   continue;
-          // }
-          // Parity conservation
-          if (chan_p.P() + chan_q.P() != chan_r.P() + chan_s.P()) {
-            continue;
-          }
-          // Isospin conservation
-          if (chan_p.M_TT() + chan_q.M_TT() != chan_r.M_TT() + chan_s.M_TT()) {
-            continue;
-          }
-
-          // r, s coupling range
-          const auto jj_rs_min =
-              CouplingMinimum<TotalAngMom>(chan_r.JJ(), chan_s.JJ());
-          const auto jj_rs_max =
-              CouplingMaximum<TotalAngMom>(chan_r.JJ(), chan_s.JJ());
-
-          // Overlapping coupling range
-          const auto jj_min = std::max(jj_pq_min, jj_rs_min);
-          const auto jj_max = std::min(jj_pq_max, jj_rs_max);
-          if (jj_max < jj_min) {
-            continue;
-          }
-
-          for (const auto jj_2b : CouplingRangeFromMinAndMax(jj_min, jj_max)) {
-            chans.push_back(
-                Scalar2BChannel({chan_p, chan_q}, {chan_r, chan_s}, jj_2b));
-          }
-        }
+  // Pandya (particle-hole) pairs are not subject to the e2max cut.
+  return std::make_shared<const Scalar2BModelSpace>(
+      sp_ms, std::move(chans),
+      imsrg::detail::Generate2BStateKeyLookup(*sp_ms, pairs),
+      imsrg::detail::Generate2BPandyaStateKeyLookup(*sp_ms, all_pairs),
+      std::move(bare_chans), e2max);
+}
+
+std::shared_ptr<const Scalar2BModelSpace>
+Scalar2BModelSpace::FromSPModelSpaceWithCache(
+    const std::shared_ptr<const SPModelSpace>& sp_ms,
+    const std::string& path_to_cache_file) {
+  return FromSPModelSpaceWithCache(
+      sp_ms, imsrg::detail::UntruncatedE2Max(*sp_ms), path_to_cache_file);
+}
+
+std::shared_ptr<const Scalar2BModelSpace>
+Scalar2BModelSpace::FromSPModelSpaceWithCache(
+    const std::shared_ptr<const SPModelSpace>& sp_ms, HOEnergy e2max,
+    const std::string& path_to_cache_file) {
+  auto ms = FromCacheFile(sp_ms, e2max, path_to_cache_file);
+  if (ms != nullptr) {
+    return ms;
+  }
+
+  spdlog::info("No usable model space cache at {}, building model space.",
+               path_to_cache_file);
+  ms = FromSPModelSpaceAndE2Max(sp_ms, e2max);
+  ms->WriteToCacheFile(path_to_cache_file);
+  return ms;
+}
+
+std::shared_ptr<const Scalar2BModelSpace> Scalar2BModelSpace::FromCacheFile(
+    const std::shared_ptr<const SPModelSpace>& sp_ms,
+    const std::string& path_to_cache_file) {
+  return FromCacheFile(sp_ms, imsrg::detail::UntruncatedE2Max(*sp_ms),
+                       path_to_cache_file);
+}
+
+std::shared_ptr<const Scalar2BModelSpace> Scalar2BModelSpace::FromCacheFile(
+    const std::shared_ptr<const SPModelSpace>& sp_ms, HOEnergy e2max,
+    const std::string& path_to_cache_file) {
+  using imsrg::detail::BareChannelCacheRecord;
+  using imsrg::detail::ChannelCacheRecord;
+  using imsrg::detail::Scalar2BModelSpaceCacheHeader;
+  using imsrg::detail::SPChannelCacheRecord;
+
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const imsrg::detail::MappedCacheFile file(path_to_cache_file);
+  if (file.size() < sizeof(Scalar2BModelSpaceCacheHeader)) {
+    return nullptr;
+  }
+
+  Scalar2BModelSpaceCacheHeader header;
+  std::memcpy(&header, file.data(), sizeof(header));
+  if ((header.magic != imsrg::detail::kCacheMagic) ||
+      (header.version != imsrg::detail::kCacheVersion) ||
+      (header.num_sp_chans != sp_ms->Channels().size()) ||
+      (header.e2max != static_cast<std::uint64_t>(e2max.AsInt())) ||
+      (imsrg::detail::CacheFileSize(header) != file.size())) {
+    return nullptr;
+  }
+
+  const auto sp_records = imsrg::detail::MakeSPChannelCacheRecords(*sp_ms);
+  const char* sp_records_begin = file.data() + sizeof(header);
+  if (std::memcmp(sp_records_begin, sp_records.data(),
+                  sp_records.size() * sizeof(SPChannelCacheRecord)) != 0) {
+    return nullptr;
+  }
+
+  const char* chan_records_begin =
+      sp_records_begin + sp_records.size() * sizeof(SPChannelCacheRecord);
+  const char* bare_records_begin =
+      chan_records_begin + header.num_chans * sizeof(ChannelCacheRecord);
+
+  const auto& sp_chans = sp_ms->Channels();
+  const auto num_sp_chans = sp_chans.size();
+
+  std::vector<ChannelCacheRecord> chan_records(header.num_chans);
+  std::memcpy(chan_records.data(), chan_records_begin,
+              header.num_chans * sizeof(ChannelCacheRecord));
+  std::vector<BareChannelCacheRecord> bare_records(header.num_bare_chans);
+  std::memcpy(bare_records.data(), bare_records_begin,
+              header.num_bare_chans * sizeof(BareChannelCacheRecord));
+
+  const auto all_pairs = imsrg::detail::GenerateSPChannelPairs(*sp_ms);
+  const auto pairs =
+      imsrg::detail::TruncateSPChannelPairs(*sp_ms, all_pairs, e2max);
+  const auto pair_dims = imsrg::detail::GeneratePairDimsLookup(*sp_ms, pairs);
+
+  for (const auto& record : chan_records) {
+    for (std::size_t i = 0; i < 4; i += 1) {
+      if (record[i] >= num_sp_chans) {
+        return nullptr;
+      }
+    }
+    if ((pair_dims[record[0] * num_sp_chans + record[1]][0] == 0) ||
+        (pair_dims[record[2] * num_sp_chans + record[3]][0] == 0)) {
+      return nullptr;
+    }
+  }
+  for (const auto& record : bare_records) {
+    for (const auto pos : record) {
+      if (pos >= num_sp_chans) {
+        return nullptr;
       }
     }
   }
+
+  // Channels are built in contiguous chunks (one per thread) and concatenated
+  // in order.
+  const std::size_t num_chunks = static_cast<std::size_t>(
+      imsrg::OpenMPRuntime::GetInstance().MaxNumberOfThreads());
+  std::vector<std::vector<Scalar2BChannel>> chans_per_chunk(num_chunks);
+
+#pragma omp parallel for schedule(static, 1)
+  for (std::size_t chunk = 0; chunk < num_chunks; chunk += 1) {
+    const std::size_t begin = chan_records.size() * chunk / num_chunks;
+    const std::size_t end = chan_records.size() * (chunk + 1) / num_chunks;
+    auto& chunk_chans = chans_per_chunk[chunk];
+    chunk_chans.reserve(end - begin);
+    for (std::size_t i = begin; i < end; i += 1) {
+      const auto& record = chan_records[i];
+      const Scalar2BChannelKey chankey(
+          {sp_chans[record[0]].ChannelKey(), sp_chans[record[1]].ChannelKey()},
+          {sp_chans[record[2]].ChannelKey(), sp_chans[record[3]].ChannelKey()},
+          TotalAngMom(record[4]));
+      const auto& dims_pq = pair_dims[record[0] * num_sp_chans + record[1]];
+      const auto& dims_rs = pair_dims[record[2] * num_sp_chans + record[3]];
+      chunk_chans.push_back(Scalar2BChannel(
+          *sp_ms, chankey, {dims_pq[0], dims_pq[1], dims_rs[0], dims_rs[1]}));
+    }
+  }
+
+  std::vector<Scalar2BChannel> chans;
+  chans.reserve(chan_records.size());
+  for (auto& chunk_chans : chans_per_chunk) {
+    std::move(chunk_chans.begin(), chunk_chans.end(),
+              std::back_inserter(chans));
+  }
+
+  std::vector<Scalar2BBareChannelKey> bare_chans;
+  bare_chans.reserve(bare_records.size());
+  for (const auto& record : bare_records) {
+    bare_chans.push_back(Scalar2BBareChannelKey{
+        sp_chans[record[0]].ChannelKey(), sp_chans[record[1]].ChannelKey(),
+        sp_chans[record[2]].ChannelKey(), sp_chans[record[3]].ChannelKey()});
+  }
+
   return std::make_shared<const Scalar2BModelSpace>(
-      sp_ms, std::move(chans), imsrg::detail::Generate2BStateKeyLookup(*sp_ms),
-      imsrg::detail::Generate2BPandyaStateKeyLookup(*sp_ms),
-      imsrg::detail::GenerateBareChannels(*sp_ms));
+      sp_ms, std::move(chans),
+      imsrg::detail::Generate2BStateKeyLookup(*sp_ms, pairs),
+      imsrg::detail::Generate2BPandyaStateKeyLookup(*sp_ms, all_pairs),
+      std::move(bare_chans), e2max);
+}
+
+void Scalar2BModelSpace::WriteToCacheFile(
+    const std::string& path_to_cache_file) const {
+  using imsrg::detail::BareChannelCacheRecord;
+  using imsrg::detail::ChannelCacheRecord;
+  using imsrg::detail::SPChannelCacheRecord;
+
+  const auto& sp_chans = sp_ms_->Channels();
+  imsrg::CheckForError(sp_chans.size() > UINT16_MAX,
+                       "Too many SP channels for model space cache.");
+
+  std::size_t max_sp_index = 0;
+  for (const auto& chan : sp_chans) {
+    max_sp_index = std::max(max_sp_index, chan.Index());
+  }
+  std::vector<std::uint16_t> sp_positions(max_sp_index + 1, 0);
+  for (std::size_t pos = 0; pos < sp_chans.size(); pos += 1) {
+    sp_positions[sp_chans[pos].Index()] = static_cast<std::uint16_t>(pos);
+  }
+
+  const imsrg::detail::Scalar2BModelSpaceCacheHeader header = {
+      imsrg::detail::kCacheMagic, imsrg::detail::kCacheVersion,
+      sp_chans.size(), chans_.size(), sp_chans_.size(),
+      static_cast<std::uint64_t>(e2max_.AsInt())};
+  const auto sp_records = imsrg::detail::MakeSPChannelCacheRecords(*sp_ms_);
+
+  std::vector<ChannelCacheRecord> chan_records;
+  chan_records.reserve(chans_.size());
+  for (const auto& chan : chans_) {
+    const auto chankey = chan.ChannelKey();
+    chan_records.push_back(
+        {sp_positions[chankey.BraChannelKey().p_chan_key.Index()],
+         sp_positions[chankey.BraChannelKey().q_chan_key.Index()],
+         sp_positions[chankey.KetChannelKey().p_chan_key.Index()],
+         sp_positions[chankey.KetChannelKey().q_chan_key.Index()],
+         static_cast<std::uint16_t>(chankey.OpChannel().JJ().AsInt())});
+  }
+
+  std::vector<BareChannelCacheRecord> bare_records;
+  bare_records.reserve(sp_chans_.size());
+  for (const auto& bare_chan : sp_chans_) {
+    bare_records.push_back({sp_positions[bare_chan.chankey_1.Index()],
+                            sp_positions[bare_chan.chankey_2.Index()],
+                            sp_positions[bare_chan.chankey_3.Index()],
+                            sp_positions[bare_chan.chankey_4.Index()]});
+  }
+
+  // Write to a temporary file first so a concurrent reader never sees a
+  // partial cache.
+  const std::string tmp_path = path_to_cache_file + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    imsrg::CheckForError(
+        !file.is_open(),
+        fmt::format("Failed to open model space cache file at {}", tmp_path));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sp_records.data()),
+               sp_records.size() * sizeof(SPChannelCacheRecord));
+    file.write(reinterpret_cast<const char*>(chan_records.data()),
+               chan_records.size() * sizeof(ChannelCacheRecord));
+    file.write(reinterpret_cast<const char*>(bare_records.data()),
+               bare_records.size() * sizeof(BareChannelCacheRecord));
+    imsrg::CheckForError(
+        !file.good(),
+        fmt::format("Failed to write model space cache file at {}", tmp_path));
+  }
+  imsrg::CheckForError(
+      std::rename(tmp_path.c_str(), path_to_cache_file.c_str()) != 0,
+      fmt::format("Failed to move model space cache file to {}",
+                  path_to_cache_file));
 }
 
 Scalar2BModelSpace::Scalar2BModelSpace(
@@ -133,56 +414,214 @@ Scalar2BModelSpace::Scalar2BModelSpace(
     absl::flat_hash_map<Scalar2BPandyaOpChannel,
                         std::vector<Scalar2BStateChannelKey>>&&
         pandya_state_keys_lookup,
-    std::vector<Scalar2BBareChannelKey>&& sp_chans)
+    std::vector<Scalar2BBareChannelKey>&& sp_chans, HOEnergy e2max)
     : sp_ms_(sp_ms),
       chans_(std::move(chans)),
-      chan_index_lookup_(imsrg::detail::GenerateChannelIndexLookup(chans_)),
+      chan_layout_(Scalar2BChannelLayout::FromChannels(chans_)),
+      chan_index_lookup_(
+          Scalar2BChannelIndexLookup::FromChannels(*sp_ms_, chans_)),
       state_keys_lookup_(std::move(state_keys_lookup)),
       pandya_state_keys_lookup_(std::move(pandya_state_keys_lookup)),
-      sp_chans_(std::move(sp_chans)) {}
+      sp_chans_(std::move(sp_chans)),
+      pandya_chan_table_(Scalar2BPandyaChannelTable::FromBareChannels(
+          sp_chans_, pandya_state_keys_lookup_, chan_index_lookup_)),
+      pandya_recoupling_table_(
+          Scalar2BPandyaRecouplingTable::FromSPModelSpace(*sp_ms_)),
+      e2max_(e2max) {}
 
 namespace detail {
 
-absl::flat_hash_map<imsrg::Scalar2BChannelKey, std::size_t>
-GenerateChannelIndexLookup(const std::vector<imsrg::Scalar2BChannel>& chans) {
-  absl::flat_hash_map<imsrg::Scalar2BChannelKey, std::size_t> index_lookup;
-  index_lookup.reserve(chans.size());
+std::vector<SPChannelPair> GenerateSPChannelPairs(
+    const imsrg::SPModelSpace& sp_ms) {
+  const auto& sp_chans = sp_ms.Channels();
+  std::vector<SPChannelPair> pairs;
+  pairs.reserve(sp_chans.size() * sp_chans.size());
+
+  for (std::size_t index_p = 0; index_p < sp_chans.size(); index_p += 1) {
+    for (std::size_t index_q = 0; index_q < sp_chans.size(); index_q += 1) {
+      const auto& chan_p = sp_chans[index_p];
+      const auto& chan_q = sp_chans[index_q];
+      pairs.push_back(
+          {index_p, index_q,
+           CouplingMinimum<TotalAngMom>(chan_p.JJ(), chan_q.JJ()),
+           CouplingMaximum<TotalAngMom>(chan_p.JJ(), chan_q.JJ()),
+           static_cast<std::uint32_t>(chan_p.size()),
+           static_cast<std::uint32_t>(chan_q.size())});
+    }
+  }
+  return pairs;
+}
+
+std::vector<SPChannelPair> TruncateSPChannelPairs(
+    const imsrg::SPModelSpace& sp_ms, const std::vector<SPChannelPair>& pairs,
+    imsrg::HOEnergy e2max) {
+  const auto& sp_chans = sp_ms.Channels();
 
-  for (std::size_t index = 0; index < chans.size(); index += 1) {
-    index_lookup[chans[index].ChannelKey()] = index;
+  // Energies of the states in each SP channel. They must not decrease within
+  // a channel, so the kept states of a pair are leading states.
+  std::vector<std::vector<int>> energies(sp_chans.size());
+  for (std::size_t pos = 0; pos < sp_chans.size(); pos += 1) {
+    const auto& basis = sp_chans[pos].ChannelBasis();
+    energies[pos].reserve(basis.size());
+    for (std::size_t i = 0; i < basis.size(); i += 1) {
+      energies[pos].push_back(basis.at(i).E().AsInt());
+      Expects((i == 0) || (energies[pos][i - 1] <= energies[pos][i]));
+    }
   }
-  return index_lookup;
+
+  const auto num_states_up_to = [](const std::vector<int>& e_chan, int e) {
+    return static_cast<std::uint32_t>(
+        std::upper_bound(e_chan.begin(), e_chan.end(), e) - e_chan.begin());
+  };
+
+  std::vector<SPChannelPair> truncated_pairs;
+  truncated_pairs.reserve(pairs.size());
+  for (const auto& pair : pairs) {
+    const auto& e_p = energies[pair.index_p];
+    const auto& e_q = energies[pair.index_q];
+    if (e_p.empty() || e_q.empty() || (e_p[0] + e_q[0] > e2max.AsInt())) {
+      continue;
+    }
+    auto truncated_pair = pair;
+    truncated_pair.dim_p = num_states_up_to(e_p, e2max.AsInt() - e_q[0]);
+    truncated_pair.dim_q = num_states_up_to(e_q, e2max.AsInt() - e_p[0]);
+    truncated_pairs.push_back(truncated_pair);
+  }
+  return truncated_pairs;
+}
+
+imsrg::HOEnergy UntruncatedE2Max(const imsrg::SPModelSpace& sp_ms) {
+  int emax = 0;
+  for (const auto& chan : sp_ms.Channels()) {
+    const auto& basis = chan.ChannelBasis();
+    for (std::size_t i = 0; i < basis.size(); i += 1) {
+      emax = std::max(emax, basis.at(i).E().AsInt());
+    }
+  }
+  return imsrg::HOEnergy(2 * emax);
+}
+
+std::vector<std::array<std::uint32_t, 2>> GeneratePairDimsLookup(
+    const imsrg::SPModelSpace& sp_ms, const std::vector<SPChannelPair>& pairs) {
+  const auto num_sp_chans = sp_ms.Channels().size();
+  std::vector<std::array<std::uint32_t, 2>> pair_dims(
+      num_sp_chans * num_sp_chans, {0, 0});
+  for (const auto& pair : pairs) {
+    pair_dims[pair.index_p * num_sp_chans + pair.index_q] = {pair.dim_p,
+                                                             pair.dim_q};
+  }
+  return pair_dims;
+}
+
+std::pair<std::vector<imsrg::Scalar2BChannel>,
+          std::vector<imsrg::Scalar2BBareChannelKey>>
+GenerateChannelsAndBareChannels(const imsrg::SPModelSpace& sp_ms,
+                                const std::vector<SPChannelPair>& pairs) {
+  const auto& sp_chans = sp_ms.Channels();
+
+  // Only pairs with the same total parity and isospin projection can form a
+  // channel. Groups keep the (p, q) order of pairs, so the channels below come
+  // out in the same order as a brute-force loop over p, q, r, s.
+  using PairGroupKey = std::pair<imsrg::Parity, imsrg::IsospinProj>;
+  std::vector<PairGroupKey> pair_group_keys;
+  pair_group_keys.reserve(pairs.size());
+  for (const auto& pair : pairs) {
+    const auto& chan_p = sp_chans[pair.index_p];
+    const auto& chan_q = sp_chans[pair.index_q];
+    pair_group_keys.push_back(
+        {chan_p.P() + chan_q.P(), chan_p.M_TT() + chan_q.M_TT()});
+  }
+
+  absl::flat_hash_map<PairGroupKey, std::vector<std::size_t>> pair_groups;
+  for (std::size_t i = 0; i < pairs.size(); i += 1) {
+    pair_groups[pair_group_keys[i]].push_back(i);
+  }
+
+  // Each bra pair is independent. Results are collected per bra pair and
+  // concatenated afterwards to keep the ordering deterministic.
+  std::vector<std::vector<imsrg::Scalar2BChannel>> chans_per_pair(
+      pairs.size());
+  std::vector<std::vector<imsrg::Scalar2BBareChannelKey>> bare_chans_per_pair(
+      pairs.size());
+
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t i = 0; i < pairs.size(); i += 1) {
+    const auto& pair_pq = pairs[i];
+    const auto& chan_p = sp_chans[pair_pq.index_p];
+    const auto& chan_q = sp_chans[pair_pq.index_q];
+
+    for (const auto j : pair_groups.at(pair_group_keys[i])) {
+      const auto& pair_rs = pairs[j];
+
+      // Overlapping coupling range
+      const auto jj_min = std::max(pair_pq.jj_min, pair_rs.jj_min);
+      const auto jj_max = std::min(pair_pq.jj_max, pair_rs.jj_max);
+      if (jj_max < jj_min) {
+        continue;
+      }
+
+      const auto& chan_r = sp_chans[pair_rs.index_p];
+      const auto& chan_s = sp_chans[pair_rs.index_q];
+      bare_chans_per_pair[i].push_back(Scalar2BBareChannelKey{
+          chan_p.ChannelKey(), chan_q.ChannelKey(), chan_r.ChannelKey(),
+          chan_s.ChannelKey()});
+      for (const auto jj_2b : CouplingRangeFromMinAndMax(jj_min, jj_max)) {
+        const Scalar2BChannelKey chankey(
+            {chan_p.ChannelKey(), chan_q.ChannelKey()},
+            {chan_r.ChannelKey(), chan_s.ChannelKey()}, jj_2b);
+        chans_per_pair[i].push_back(Scalar2BChannel(
+            sp_ms, chankey,
+            {pair_pq.dim_p, pair_pq.dim_q, pair_rs.dim_p, pair_rs.dim_q}));
+      }
+    }
+  }
+
+  std::size_t num_chans = 0;
+  std::size_t num_bare_chans = 0;
+  for (std::size_t i = 0; i < pairs.size(); i += 1) {
+    num_chans += chans_per_pair[i].size();
+    num_bare_chans += bare_chans_per_pair[i].size();
+  }
+
+  std::vector<imsrg::Scalar2BChannel> chans;
+  std::vector<imsrg::Scalar2BBareChannelKey> bare_chans;
+  chans.reserve(num_chans);
+  bare_chans.reserve(num_bare_chans);
+  for (std::size_t i = 0; i < pairs.size(); i += 1) {
+    std::move(chans_per_pair[i].begin(), chans_per_pair[i].end(),
+              std::back_inserter(chans));
+    bare_chans.insert(bare_chans.end(), bare_chans_per_pair[i].begin(),
+                      bare_chans_per_pair[i].end());
+  }
+
+  return {std::move(chans), std::move(bare_chans)};
 }
 
 absl::flat_hash_map<imsrg::Scalar2BOpChannel,
                     std::vector<imsrg::Scalar2BStateChannelKey>>
-Generate2BStateKeyLookup(const imsrg::SPModelSpace& sp_ms) {
+Generate2BStateKeyLookup(const imsrg::SPModelSpace& sp_ms,
+                         const std::vector<SPChannelPair>& pairs) {
   absl::flat_hash_map<imsrg::Scalar2BOpChannel,
                       std::vector<imsrg::Scalar2BStateChannelKey>>
       state_key_lookup;
 
   const auto& sp_chans = sp_ms.Channels();
 
-  for (const auto& chan_p : sp_chans) {
-    for (const auto& chan_q : sp_chans) {
-      // p, q coupling range
-      const auto jj_pq_min =
-          CouplingMinimum<TotalAngMom>(chan_p.JJ(), chan_q.JJ());
-      const auto jj_pq_max =
-          CouplingMaximum<TotalAngMom>(chan_p.JJ(), chan_q.JJ());
+  for (const auto& pair : pairs) {
+    const auto& chan_p = sp_chans[pair.index_p];
+    const auto& chan_q = sp_chans[pair.index_q];
 
-      const auto parity_pq = chan_p.P() + chan_q.P();
-      const auto m_tt_pq = chan_p.M_TT() + chan_q.M_TT();
+    const auto parity_pq = chan_p.P() + chan_q.P();
+    const auto m_tt_pq = chan_p.M_TT() + chan_q.M_TT();
 
-      const imsrg::Scalar2BStateChannelKey state_chankey = {
-          chan_p.ChannelKey(), chan_q.ChannelKey()};
+    const imsrg::Scalar2BStateChannelKey state_chankey = {chan_p.ChannelKey(),
+                                                          chan_q.ChannelKey()};
 
-      for (const auto jj_pq :
-           CouplingRangeFromMinAndMax(jj_pq_min, jj_pq_max)) {
-        const imsrg::Scalar2BOpChannel op_chan(jj_pq, parity_pq, m_tt_pq);
+    for (const auto jj_pq :
+         CouplingRangeFromMinAndMax(pair.jj_min, pair.jj_max)) {
+      const imsrg::Scalar2BOpChannel op_chan(jj_pq, parity_pq, m_tt_pq);
 
-        state_key_lookup[op_chan].push_back(state_chankey);
-      }
+      state_key_lookup[op_chan].push_back(state_chankey);
     }
   }
   return state_key_lookup;
@@ -190,88 +629,78 @@ Generate2BStateKeyLookup(const imsrg::SPModelSpace& sp_ms) {
 
 absl::flat_hash_map<imsrg::Scalar2BPandyaOpChannel,
                     std::vector<imsrg::Scalar2BStateChannelKey>>
-Generate2BPandyaStateKeyLookup(const imsrg::SPModelSpace& sp_ms) {
+Generate2BPandyaStateKeyLookup(const imsrg::SPModelSpace& sp_ms,
+                               const std::vector<SPChannelPair>& pairs) {
   absl::flat_hash_map<imsrg::Scalar2BPandyaOpChannel,
                       std::vector<imsrg::Scalar2BStateChannelKey>>
       pandya_state_key_lookup;
 
   const auto& sp_chans = sp_ms.Channels();
 
-  for (const auto& chan_p : sp_chans) {
-    for (const auto& chan_q : sp_chans) {
-      // p, q coupling range
-      const auto jj_pq_min =
-          CouplingMinimum<TotalAngMom>(chan_p.JJ(), chan_q.JJ());
-      const auto jj_pq_max =
-          CouplingMaximum<TotalAngMom>(chan_p.JJ(), chan_q.JJ());
+  for (const auto& pair : pairs) {
+    const auto& chan_p = sp_chans[pair.index_p];
+    const auto& chan_q = sp_chans[pair.index_q];
 
-      const auto parity_pq = chan_p.P() - chan_q.P();
-      const auto m_ttau_pq = chan_p.M_TT() - chan_q.M_TT();
+    const auto parity_pq = chan_p.P() - chan_q.P();
+    const auto m_ttau_pq = chan_p.M_TT() - chan_q.M_TT();
 
-      const imsrg::Scalar2BStateChannelKey state_chankey = {
-          chan_p.ChannelKey(), chan_q.ChannelKey()};
+    const imsrg::Scalar2BStateChannelKey state_chankey = {chan_p.ChannelKey(),
+                                                          chan_q.ChannelKey()};
 
-      for (const auto jj_pq :
-           CouplingRangeFromMinAndMax(jj_pq_min, jj_pq_max)) {
-        const imsrg::Scalar2BPandyaOpChannel op_chan(jj_pq, parity_pq,
-                                                     m_ttau_pq);
+    for (const auto jj_pq :
+         CouplingRangeFromMinAndMax(pair.jj_min, pair.jj_max)) {
+      const imsrg::Scalar2BPandyaOpChannel op_chan(jj_pq, parity_pq,
+                                                   m_ttau_pq);
 
-        pandya_state_key_lookup[op_chan].push_back(state_chankey);
-      }
+      pandya_state_key_lookup[op_chan].push_back(state_chankey);
     }
   }
   return pandya_state_key_lookup;
 }
 
-std::vector<imsrg::Scalar2BBareChannelKey> GenerateBareChannels(
+std::vector<SPChannelCacheRecord> MakeSPChannelCacheRecords(
     const imsrg::SPModelSpace& sp_ms) {
-  std::vector<imsrg::Scalar2BBareChannelKey> bare_chans;
-  const auto& sp_chans = sp_ms.Channels();
-  std::vector<Scalar2BChannel> chans;
+  std::vector<SPChannelCacheRecord> records;
+  records.reserve(sp_ms.Channels().size());
+  for (const auto& chan : sp_ms.Channels()) {
+    records.push_back({static_cast<std::uint32_t>(chan.Index()),
+                       static_cast<std::uint32_t>(chan.size())});
+  }
+  return records;
+}
 
-  for (const auto& chan_p : sp_chans) {
-    for (const auto& chan_q : sp_chans) {
-      // if (chan_q.Index() > chan_p.Index()) {
-      //   continue;
-      // }
-      // p, q coupling range
-      const auto jj_pq_min =
-          CouplingMinimum<TotalAngMom>(chan_p.JJ(), chan_q.JJ());
-      const auto jj_pq_max =
-          CouplingMaximum<TotalAngMom>(chan_p.JJ(), chan_q.JJ());
-      for (const auto& chan_r : sp_chans) {
-        for (const auto& chan_s : sp_chans) {
-          // if (chan_s.Index() > chan_r.Index()) {
-          //   continue;
-          // }
-          // Parity conservation
-          if (chan_p.P() + chan_q.P() != chan_r.P() + chan_s.P()) {
-            continue;
-          }
-          // Isospin conservation
-          if (chan_p.M_TT() + chan_q.M_TT() != chan_r.M_TT() + chan_s.M_TT()) {
-            continue;
-          }
-
-          // r, s coupling range
-          const auto jj_rs_min =
-              CouplingMinimum<TotalAngMom>(chan_r.JJ(), chan_s.JJ());
-          const auto jj_rs_max =
-              CouplingMaximum<TotalAngMom>(chan_r.JJ(), chan_s.JJ());
-
-          // Overlapping coupling range
-          const auto jj_min = std::max(jj_pq_min, jj_rs_min);
-          const auto jj_max = std::min(jj_pq_max, jj_rs_max);
-          if (jj_max >= jj_min) {
-            bare_chans.push_back(Scalar2BBareChannelKey{
-                chan_p.ChannelKey(), chan_q.ChannelKey(), chan_r.ChannelKey(),
-                chan_s.ChannelKey()});
-          }
-        }
-      }
-    }
+std::size_t CacheFileSize(const Scalar2BModelSpaceCacheHeader& header) {
+  return sizeof(Scalar2BModelSpaceCacheHeader) +
+         header.num_sp_chans * sizeof(SPChannelCacheRecord) +
+         header.num_chans * sizeof(ChannelCacheRecord) +
+         header.num_bare_chans * sizeof(BareChannelCacheRecord);
+}
+
+MappedCacheFile::MappedCacheFile(const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat file_stat;
+  if ((fstat(fd, &file_stat) != 0) || (file_stat.st_size <= 0)) {
+    close(fd);
+    return;
+  }
+  const auto size = static_cast<std::size_t>(file_stat.st_size);
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (map == MAP_FAILED) {
+    return;
+  }
+  data_ = static_cast<const char*>(map);
+  size_ = size;
+}
+
+MappedCacheFile::~MappedCacheFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
   }
-  return bare_chans;
 }
 
 }  // namespace detail
@@ -3,17 +3,24 @@
 #define IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_MODEL_SPACE_H_
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 
+#include "imsrg/assert.h"
 #include "imsrg/model_space/scalar/two_body/bare_channel_key.h"
 #include "imsrg/model_space/scalar/two_body/channel.h"
+#include "imsrg/model_space/scalar/two_body/channel_index_lookup.h"
 #include "imsrg/model_space/scalar/two_body/channel_key.h"
+#include "imsrg/model_space/scalar/two_body/channel_layout.h"
+#include "imsrg/model_space/scalar/two_body/pandya_channel_table.h"
 #include "imsrg/model_space/scalar/two_body/pandya_operator_channel.h"
+#include "imsrg/model_space/scalar/two_body/pandya_recoupling_table.h"
 #include "imsrg/model_space/scalar/two_body/state_channel_key.h"
 #include "imsrg/model_space/single_particle/model_space.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
 
 namespace imsrg {
 
@@ -22,6 +29,36 @@ class Scalar2BModelSpace {
   static std::shared_ptr<const Scalar2BModelSpace> FromSPModelSpace(
       const std::shared_ptr<const SPModelSpace>& sp_ms);
 
+  // Keeps only two-body states with e_p + e_q <= e2max. SP channel pairs
+  // without any such state are dropped, and channel dims are shrunk to the
+  // leading states of each SP channel that can appear below the cut.
+  static std::shared_ptr<const Scalar2BModelSpace> FromSPModelSpaceAndE2Max(
+      const std::shared_ptr<const SPModelSpace>& sp_ms, HOEnergy e2max);
+
+  // Loads the model space from the cache file at path_to_cache_file if it was
+  // written for the same SP channels and e2max. Otherwise builds it and
+  // (re)writes the cache file.
+  static std::shared_ptr<const Scalar2BModelSpace> FromSPModelSpaceWithCache(
+      const std::shared_ptr<const SPModelSpace>& sp_ms,
+      const std::string& path_to_cache_file);
+  static std::shared_ptr<const Scalar2BModelSpace> FromSPModelSpaceWithCache(
+      const std::shared_ptr<const SPModelSpace>& sp_ms, HOEnergy e2max,
+      const std::string& path_to_cache_file);
+
+  // Returns nullptr if the file does not exist, is truncated, has another
+  // format version, or was written for other SP channels or e2max.
+  static std::shared_ptr<const Scalar2BModelSpace> FromCacheFile(
+      const std::shared_ptr<const SPModelSpace>& sp_ms,
+      const std::string& path_to_cache_file);
+  static std::shared_ptr<const Scalar2BModelSpace> FromCacheFile(
+      const std::shared_ptr<const SPModelSpace>& sp_ms, HOEnergy e2max,
+      const std::string& path_to_cache_file);
+
+  // Versioned binary format: a header, the SP channels (keys and dims) the
+  // model space depends on, then channels and bare channels as SP channel
+  // positions. Lookups are rebuilt on load.
+  void WriteToCacheFile(const std::string& path_to_cache_file) const;
+
   // Ctor from a vector of channels
   // YOU SHOULD NOT CALL THIS DIRECTLY.
   explicit Scalar2BModelSpace(
@@ -33,7 +70,7 @@ class Scalar2BModelSpace {
       absl::flat_hash_map<Scalar2BPandyaOpChannel,
                           std::vector<Scalar2BStateChannelKey>>&&
           pandya_state_keys_lookup,
-      std::vector<Scalar2BBareChannelKey>&& sp_chans);
+      std::vector<Scalar2BBareChannelKey>&& sp_chans, HOEnergy e2max);
 
   // Not copyable or movable (only pointers)
   Scalar2BModelSpace(const Scalar2BModelSpace&) = delete;
@@ -53,12 +90,29 @@ class Scalar2BModelSpace {
 
   const SPModelSpace& SingleParticleModelSpace() const { return *sp_ms_; }
 
+  HOEnergy E2Max() const { return e2max_; }
+
   const Scalar2BChannel& ChannelAtIndex(std::size_t index) const {
     return chans_[index];
   }
 
-  bool IsChannelInModelSpace(Scalar2BChannelKey chankey) const;
-  std::size_t IndexOfChannelInModelSpace(Scalar2BChannelKey chankey) const;
+  // Tensor shapes and offsets of all channels, shared by all operators
+  const Scalar2BChannelLayout& ChannelLayout() const { return chan_layout_; }
+
+  bool IsChannelInModelSpace(Scalar2BChannelKey chankey) const {
+    return chan_index_lookup_.Find(chankey) !=
+           Scalar2BChannelIndexLookup::npos;
+  }
+
+  std::size_t IndexOfChannelInModelSpace(Scalar2BChannelKey chankey) const {
+    const auto index = chan_index_lookup_.Find(chankey);
+    Expects(index != Scalar2BChannelIndexLookup::npos);
+    return index;
+  }
+
+  const Scalar2BChannelIndexLookup& ChannelIndexLookup() const {
+    return chan_index_lookup_;
+  }
 
   const std::vector<Scalar2BStateChannelKey>& GetStateChannelsInOperatorChannel(
       Scalar2BOpChannel op_chan) const;
@@ -71,25 +125,43 @@ class Scalar2BModelSpace {
     return sp_chans_;
   }
 
+  // Pandya channels of BareChannels() and their partner pairs
+  const Scalar2BPandyaChannelTable& PandyaChannelTable() const {
+    return pandya_chan_table_;
+  }
+
+  // 6j recoupling factors of the Pandya transform
+  const Scalar2BPandyaRecouplingTable& PandyaRecouplingTable() const {
+    return pandya_recoupling_table_;
+  }
+
   void swap(Scalar2BModelSpace& other) noexcept {
     using std::swap;
     swap(chans_, other.chans_);
+    swap(chan_layout_, other.chan_layout_);
     swap(chan_index_lookup_, other.chan_index_lookup_);
     swap(state_keys_lookup_, other.state_keys_lookup_);
     swap(pandya_state_keys_lookup_, other.pandya_state_keys_lookup_);
     swap(sp_chans_, other.sp_chans_);
+    swap(pandya_chan_table_, other.pandya_chan_table_);
+    swap(pandya_recoupling_table_, other.pandya_recoupling_table_);
+    swap(e2max_, other.e2max_);
   }
 
  private:
   std::shared_ptr<const SPModelSpace> sp_ms_;
   std::vector<Scalar2BChannel> chans_;
-  absl::flat_hash_map<Scalar2BChannelKey, std::size_t> chan_index_lookup_;
+  Scalar2BChannelLayout chan_layout_;
+  Scalar2BChannelIndexLookup chan_index_lookup_;
   absl::flat_hash_map<Scalar2BOpChannel, std::vector<Scalar2BStateChannelKey>>
       state_keys_lookup_;
   absl::flat_hash_map<Scalar2BPandyaOpChannel,
                       std::vector<Scalar2BStateChannelKey>>
       pandya_state_keys_lookup_;
   std::vector<Scalar2BBareChannelKey> sp_chans_;
+  Scalar2BPandyaChannelTable pandya_chan_table_;
+  Scalar2BPandyaRecouplingTable pandya_recoupling_table_;
+  HOEnergy e2max_;
 };
 
 inline void swap(Scalar2BModelSpace& a, Scalar2BModelSpace& b) noexcept {
@@ -0,0 +1,88 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/model_space/scalar/two_body/pandya_channel_table.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+#include "imsrg/assert.h"
+#include "imsrg/model_space/scalar/two_body/bare_channel_key.h"
+#include "imsrg/model_space/scalar/two_body/channel_index_lookup.h"
+#include "imsrg/model_space/scalar/two_body/pandya_channel_key.h"
+#include "imsrg/model_space/scalar/two_body/pandya_operator_channel.h"
+#include "imsrg/model_space/scalar/two_body/state_channel_key.h"
+
+namespace imsrg {
+
+Scalar2BPandyaChannelTable Scalar2BPandyaChannelTable::FromBareChannels(
+    const std::vector<Scalar2BBareChannelKey>& bare_chans,
+    const absl::flat_hash_map<Scalar2BPandyaOpChannel,
+                              std::vector<Scalar2BStateChannelKey>>&
+        pandya_state_keys_lookup,
+    const Scalar2BChannelIndexLookup& chan_index_lookup) {
+  std::vector<std::size_t> pandya_chan_offsets;
+  std::vector<PandyaChannel> pandya_chans;
+  std::vector<std::size_t> state_chan_offsets;
+  std::vector<Scalar2BStateChannelKey> state_chans;
+
+  // Pandya operator channels are numbered in order of first use.
+  absl::flat_hash_map<Scalar2BPandyaOpChannel, std::uint32_t> op_chan_indices;
+
+  pandya_chan_offsets.reserve(bare_chans.size() + 1);
+  state_chan_offsets.push_back(0);
+  for (const auto& bare_chan : bare_chans) {
+    pandya_chan_offsets.push_back(pandya_chans.size());
+
+    const auto pandya_bare_chan = imsrg::BareChannelKeyPandyaSwap(bare_chan);
+    for (const auto& pandya_chan :
+         imsrg::GeneratePandyaChannels(pandya_bare_chan)) {
+      const auto op_chan = pandya_chan.OperatorChannel();
+      const auto [it, inserted] = op_chan_indices.try_emplace(
+          op_chan, static_cast<std::uint32_t>(op_chan_indices.size()));
+      if (inserted) {
+        const auto search = pandya_state_keys_lookup.find(op_chan);
+        Expects(search != pandya_state_keys_lookup.end());
+        state_chans.insert(state_chans.end(), search->second.begin(),
+                           search->second.end());
+        state_chan_offsets.push_back(state_chans.size());
+      }
+
+      // Standard channels of Pandya channel (p, s, r, q) are (p, q, r, s).
+      pandya_chans.push_back(
+          {pandya_chan, it->second,
+           chan_index_lookup.FindRange(
+               imsrg::BareChannelKeyPandyaSwap(pandya_bare_chan))});
+    }
+  }
+  pandya_chan_offsets.push_back(pandya_chans.size());
+
+  return Scalar2BPandyaChannelTable(
+      std::move(pandya_chan_offsets), std::move(pandya_chans),
+      std::move(state_chan_offsets), std::move(state_chans));
+}
+
+Scalar2BPandyaChannelTable::Scalar2BPandyaChannelTable(
+    std::vector<std::size_t>&& pandya_chan_offsets,
+    std::vector<PandyaChannel>&& pandya_chans,
+    std::vector<std::size_t>&& state_chan_offsets,
+    std::vector<Scalar2BStateChannelKey>&& state_chans)
+    : pandya_chan_offsets_(std::move(pandya_chan_offsets)),
+      pandya_chans_(std::move(pandya_chans)),
+      state_chan_offsets_(std::move(state_chan_offsets)),
+      state_chans_(std::move(state_chans)) {
+  Expects(!pandya_chan_offsets_.empty());
+  Expects(!state_chan_offsets_.empty());
+  Expects(pandya_chan_offsets_.back() == pandya_chans_.size());
+  Expects(state_chan_offsets_.back() == state_chans_.size());
+}
+
+std::size_t Scalar2BPandyaChannelTable::SizeInBytes() const {
+  return pandya_chan_offsets_.size() * sizeof(std::size_t) +
+         pandya_chans_.size() * sizeof(PandyaChannel) +
+         state_chan_offsets_.size() * sizeof(std::size_t) +
+         state_chans_.size() * sizeof(Scalar2BStateChannelKey);
+}
+
+}  // namespace imsrg
@@ -0,0 +1,109 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_PANDYA_CHANNEL_TABLE_H_
+#define IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_PANDYA_CHANNEL_TABLE_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+#include "imsrg/model_space/scalar/two_body/bare_channel_key.h"
+#include "imsrg/model_space/scalar/two_body/channel_index_lookup.h"
+#include "imsrg/model_space/scalar/two_body/pandya_channel_key.h"
+#include "imsrg/model_space/scalar/two_body/pandya_operator_channel.h"
+#include "imsrg/model_space/scalar/two_body/state_channel_key.h"
+
+namespace imsrg {
+
+// Flat (CSR) tables of everything the Pandya term needs per bare channel.
+//
+// For bare channel i, PandyaChannels(i) are the Pandya channels of its Pandya
+// swap (p, s, r, q), each with the index range of its standard channels in
+// the model space and the index of its Pandya operator channel.
+// StateChannels(op_chan_index) are the (p, q) SP channel pairs in that
+// Pandya operator channel. Built once with the model space, so evaluations
+// iterate over contiguous arrays instead of generating and hashing keys.
+class Scalar2BPandyaChannelTable {
+ public:
+  struct PandyaChannel {
+    Scalar2BPandyaChannelKey chankey;
+    std::uint32_t op_chan_index;
+    Scalar2BChannelIndexLookup::ChannelRange standard_chans;
+  };
+
+  // Contiguous run of table entries
+  template <typename T>
+  class Span {
+   public:
+    Span(const T* first, const T* last) : first_(first), last_(last) {}
+
+    const T* begin() const { return first_; }
+    const T* end() const { return last_; }
+    std::size_t size() const { return last_ - first_; }
+    bool empty() const { return first_ == last_; }
+    const T& operator[](std::size_t i) const { return first_[i]; }
+
+   private:
+    const T* first_;
+    const T* last_;
+  };
+
+  static Scalar2BPandyaChannelTable FromBareChannels(
+      const std::vector<Scalar2BBareChannelKey>& bare_chans,
+      const absl::flat_hash_map<Scalar2BPandyaOpChannel,
+                                std::vector<Scalar2BStateChannelKey>>&
+          pandya_state_keys_lookup,
+      const Scalar2BChannelIndexLookup& chan_index_lookup);
+
+  // Default copy, move, and dtor
+
+  std::size_t NumberOfBareChannels() const {
+    return pandya_chan_offsets_.size() - 1;
+  }
+
+  std::size_t NumberOfPandyaOpChannels() const {
+    return state_chan_offsets_.size() - 1;
+  }
+
+  Span<PandyaChannel> PandyaChannels(std::size_t bare_index) const {
+    return {pandya_chans_.data() + pandya_chan_offsets_[bare_index],
+            pandya_chans_.data() + pandya_chan_offsets_[bare_index + 1]};
+  }
+
+  Span<Scalar2BStateChannelKey> StateChannels(std::size_t op_chan_index) const {
+    return {state_chans_.data() + state_chan_offsets_[op_chan_index],
+            state_chans_.data() + state_chan_offsets_[op_chan_index + 1]};
+  }
+
+  std::size_t SizeInBytes() const;
+
+  void swap(Scalar2BPandyaChannelTable& other) noexcept {
+    using std::swap;
+    swap(pandya_chan_offsets_, other.pandya_chan_offsets_);
+    swap(pandya_chans_, other.pandya_chans_);
+    swap(state_chan_offsets_, other.state_chan_offsets_);
+    swap(state_chans_, other.state_chans_);
+  }
+
+ private:
+  std::vector<std::size_t> pandya_chan_offsets_;
+  std::vector<PandyaChannel> pandya_chans_;
+  std::vector<std::size_t> state_chan_offsets_;
+  std::vector<Scalar2BStateChannelKey> state_chans_;
+
+  explicit Scalar2BPandyaChannelTable(
+      std::vector<std::size_t>&& pandya_chan_offsets,
+      std::vector<PandyaChannel>&& pandya_chans,
+      std::vector<std::size_t>&& state_chan_offsets,
+      std::vector<Scalar2BStateChannelKey>&& state_chans);
+};
+
+inline void swap(Scalar2BPandyaChannelTable& a,
+                 Scalar2BPandyaChannelTable& b) noexcept {
+  a.swap(b);
+}
+
+}  // namespace imsrg
+
+#endif  // IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_PANDYA_CHANNEL_TABLE_H_
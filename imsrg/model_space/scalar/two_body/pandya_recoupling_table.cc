@@ -0,0 +1,112 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/model_space/scalar/two_body/pandya_recoupling_table.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "imsrg/assert.h"
+#include "imsrg/model_space/single_particle/model_space.h"
+#include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
+#include "imsrg/quantum_numbers/coupling/factors.h"
+#include "imsrg/quantum_numbers/coupling/jj.h"
+#include "imsrg/quantum_numbers/coupling/wigner_symbols.h"
+
+namespace imsrg {
+
+Scalar2BPandyaRecouplingTable Scalar2BPandyaRecouplingTable::FromSPModelSpace(
+    const SPModelSpace& sp_ms) {
+  std::vector<JJ> jjs;
+  for (const auto& chan : sp_ms.Channels()) {
+    const auto jj = chan.JJ().AsJJ();
+    if (std::find(jjs.begin(), jjs.end(), jj) == jjs.end()) {
+      jjs.push_back(jj);
+    }
+  }
+  std::sort(jjs.begin(), jjs.end());
+
+  const auto num_jjs = jjs.size();
+  std::vector<std::uint32_t> jj_positions(
+      jjs.empty() ? 0 : jjs.back().AsInt() + 1,
+      std::numeric_limits<std::uint32_t>::max());
+  for (std::size_t pos = 0; pos < num_jjs; pos += 1) {
+    jj_positions[jjs[pos].AsInt()] = static_cast<std::uint32_t>(pos);
+  }
+
+  const auto& wigner_engine = WignerSymbolEngine::GetInstance();
+
+  std::vector<Block> blocks;
+  blocks.reserve(num_jjs * num_jjs * num_jjs * num_jjs);
+  std::vector<double> to_pandya_factors;
+  std::vector<double> from_pandya_factors;
+  // Same nesting as BlockIndex
+  for (const auto jj_p : jjs) {
+    for (const auto jj_s : jjs) {
+      for (const auto jj_r : jjs) {
+        for (const auto jj_q : jjs) {
+          const auto jj_pandya_min = std::max(CouplingMinimum(jj_p, jj_s),
+                                              CouplingMinimum(jj_r, jj_q));
+          const auto jj_pandya_max = std::min(CouplingMaximum(jj_p, jj_s),
+                                              CouplingMaximum(jj_r, jj_q));
+          const auto jj_standard_min = std::max(CouplingMinimum(jj_p, jj_q),
+                                                CouplingMinimum(jj_r, jj_s));
+          const auto jj_standard_max = std::min(CouplingMaximum(jj_p, jj_q),
+                                                CouplingMaximum(jj_r, jj_s));
+          const int num_jj_standard =
+              (jj_standard_max < jj_standard_min)
+                  ? 0
+                  : (jj_standard_max.AsInt() - jj_standard_min.AsInt()) / 2 + 1;
+          blocks.push_back({to_pandya_factors.size(), jj_pandya_min.AsInt(),
+                            jj_standard_min.AsInt(), num_jj_standard});
+          if ((jj_pandya_max < jj_pandya_min) ||
+              (jj_standard_max < jj_standard_min)) {
+            continue;
+          }
+
+          for (const auto jj_pandya :
+               CouplingRangeFromMinAndMax(jj_pandya_min, jj_pandya_max)) {
+            for (const auto jj_standard :
+                 CouplingRangeFromMinAndMax(jj_standard_min, jj_standard_max)) {
+              to_pandya_factors.push_back(
+                  -1 * imsrg::HatSquared(jj_standard) *
+                  wigner_engine.Wigner6J(jj_p, jj_s, jj_pandya, jj_r, jj_q,
+                                         jj_standard));
+              from_pandya_factors.push_back(
+                  -1 * imsrg::HatSquared(jj_pandya) *
+                  wigner_engine.Wigner6J(jj_p, jj_q, jj_standard, jj_r, jj_s,
+                                         jj_pandya));
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return Scalar2BPandyaRecouplingTable(
+      std::move(jj_positions), num_jjs, std::move(blocks),
+      std::move(to_pandya_factors), std::move(from_pandya_factors));
+}
+
+Scalar2BPandyaRecouplingTable::Scalar2BPandyaRecouplingTable(
+    std::vector<std::uint32_t>&& jj_positions, std::size_t num_jjs,
+    std::vector<Block>&& blocks, std::vector<double>&& to_pandya_factors,
+    std::vector<double>&& from_pandya_factors)
+    : jj_positions_(std::move(jj_positions)),
+      num_jjs_(num_jjs),
+      blocks_(std::move(blocks)),
+      to_pandya_factors_(std::move(to_pandya_factors)),
+      from_pandya_factors_(std::move(from_pandya_factors)) {
+  Expects(blocks_.size() == num_jjs_ * num_jjs_ * num_jjs_ * num_jjs_);
+  Expects(to_pandya_factors_.size() == from_pandya_factors_.size());
+}
+
+std::size_t Scalar2BPandyaRecouplingTable::SizeInBytes() const {
+  return jj_positions_.size() * sizeof(std::uint32_t) +
+         blocks_.size() * sizeof(Block) +
+         to_pandya_factors_.size() * sizeof(double) +
+         from_pandya_factors_.size() * sizeof(double);
+}
+
+}  // namespace imsrg
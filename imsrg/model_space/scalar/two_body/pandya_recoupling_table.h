@@ -0,0 +1,97 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_PANDYA_RECOUPLING_TABLE_H_
+#define IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_PANDYA_RECOUPLING_TABLE_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "imsrg/model_space/single_particle/model_space.h"
+#include "imsrg/quantum_numbers/coupling/jj.h"
+
+namespace imsrg {
+
+// Recoupling factors between Pandya channel (p, s, r, q) with J' and standard
+// channel (p, q, r, s) with J:
+//
+// to Pandya:   -[J]^2  {j_p j_s J'; j_r j_q J}
+// from Pandya: -[J']^2 {j_p j_q J; j_r j_s J'}
+//
+// They only depend on the SP channel j values, so one block is stored per
+// (j_p, j_s, j_r, j_q) of the SP model space, with all allowed (J', J) in
+// row-major order. All 6j symbols are evaluated at construction.
+class Scalar2BPandyaRecouplingTable {
+ public:
+  static Scalar2BPandyaRecouplingTable FromSPModelSpace(
+      const SPModelSpace& sp_ms);
+
+  // Default copy, move, and dtor
+
+  // Index of the factors for (J', J). The factors for J + 1 are at index + 1.
+  std::size_t Index(JJ jj_p, JJ jj_s, JJ jj_r, JJ jj_q, JJ jj_pandya,
+                    JJ jj_standard) const {
+    const auto& block = blocks_[BlockIndex(jj_p, jj_s, jj_r, jj_q)];
+    const auto row = (jj_pandya.AsInt() - block.jj_pandya_min) / 2;
+    const auto col = (jj_standard.AsInt() - block.jj_standard_min) / 2;
+    return block.offset + row * block.num_jj_standard + col;
+  }
+
+  double ToPandyaFactor(std::size_t index) const {
+    return to_pandya_factors_[index];
+  }
+
+  double FromPandyaFactor(std::size_t index) const {
+    return from_pandya_factors_[index];
+  }
+
+  std::size_t size() const { return to_pandya_factors_.size(); }
+
+  std::size_t SizeInBytes() const;
+
+  void swap(Scalar2BPandyaRecouplingTable& other) noexcept {
+    using std::swap;
+    swap(jj_positions_, other.jj_positions_);
+    swap(num_jjs_, other.num_jjs_);
+    swap(blocks_, other.blocks_);
+    swap(to_pandya_factors_, other.to_pandya_factors_);
+    swap(from_pandya_factors_, other.from_pandya_factors_);
+  }
+
+ private:
+  struct Block {
+    std::size_t offset;
+    std::int32_t jj_pandya_min;
+    std::int32_t jj_standard_min;
+    std::int32_t num_jj_standard;
+  };
+
+  // Indexed by 2 * j
+  std::vector<std::uint32_t> jj_positions_;
+  std::size_t num_jjs_;
+  std::vector<Block> blocks_;
+  std::vector<double> to_pandya_factors_;
+  std::vector<double> from_pandya_factors_;
+
+  explicit Scalar2BPandyaRecouplingTable(
+      std::vector<std::uint32_t>&& jj_positions, std::size_t num_jjs,
+      std::vector<Block>&& blocks, std::vector<double>&& to_pandya_factors,
+      std::vector<double>&& from_pandya_factors);
+
+  std::size_t BlockIndex(JJ jj_p, JJ jj_s, JJ jj_r, JJ jj_q) const {
+    return ((jj_positions_[jj_p.AsInt()] * num_jjs_ +
+             jj_positions_[jj_s.AsInt()]) *
+                num_jjs_ +
+            jj_positions_[jj_r.AsInt()]) *
+               num_jjs_ +
+           jj_positions_[jj_q.AsInt()];
+  }
+};
+
+inline void swap(Scalar2BPandyaRecouplingTable& a,
+                 Scalar2BPandyaRecouplingTable& b) noexcept {
+  a.swap(b);
+}
+
+}  // namespace imsrg
+
+#endif  // IMSRG_MODEL_SPACE_SCALAR_TWO_BODY_PANDYA_RECOUPLING_TABLE_H_
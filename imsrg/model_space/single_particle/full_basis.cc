@@ -3,12 +3,15 @@
 
 #include <vector>
 
+#include "fmt/core.h"
+
 #include "imsrg/error.h"
 #include "imsrg/model_space/single_particle/reference_state.h"
 #include "imsrg/model_space/single_particle/state.h"
 #include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
 #include "imsrg/quantum_numbers/ho_energy.h"
 #include "imsrg/quantum_numbers/isospin_projection.h"
+#include "imsrg/quantum_numbers/orbital_ang_mom.h"
 #include "imsrg/quantum_numbers/spin.h"
 #include "imsrg/quantum_numbers/total_ang_mom.h"
 
@@ -45,4 +48,54 @@ SPFullBasis SPFullBasis::FromEMaxAndReferenceState(HOEnergy emax,
 
   return SPFullBasis(states);
 }
+
+SPFullBasis SPFullBasis::FromEMaxAndLMax(HOEnergy emax, OrbitalAngMom lmax) {
+  std::vector<SPState> states;
+
+  for (const auto& x : SPFullBasis::FromEMax(emax).states_) {
+    if (x.L() <= lmax) {
+      states.push_back(x);
+    }
+  }
+
+  return SPFullBasis(states);
+}
+
+SPFullBasis SPFullBasis::FromEMaxLMaxAndReferenceState(
+    HOEnergy emax, OrbitalAngMom lmax, const ReferenceState& ref) {
+  const auto emax_validation = ref.ValidateAgainstEMax(emax);
+  if (!emax_validation.valid) {
+    imsrg::Error(emax_validation.first_err_msg);
+  }
+  const auto lmax_validation = ref.ValidateAgainstLMax(lmax);
+  if (!lmax_validation.valid) {
+    imsrg::Error(lmax_validation.first_err_msg);
+  }
+
+  auto states = SPFullBasis::FromEMaxAndLMax(emax, lmax).states_;
+
+  for (auto& x : states) {
+    x = ref.GetStateWithOccupations(x);
+  }
+
+  return SPFullBasis(states);
+}
+
+SPFullBasis SPFullBasis::FromEMinEMaxAndReferenceState(
+    HOEnergy emin, HOEnergy emax, const ReferenceState& ref) {
+  if (emin > emax) {
+    imsrg::Error(fmt::format("Energy window is empty: emin = {} > emax = {}",
+                             emin.AsInt(), emax.AsInt()));
+  }
+
+  std::vector<SPState> states;
+  for (const auto& x :
+       SPFullBasis::FromEMaxAndReferenceState(emax, ref).states_) {
+    if (x.E() >= emin) {
+      states.push_back(x);
+    }
+  }
+
+  return SPFullBasis(states);
+}
 }  // namespace imsrg
@@ -8,6 +8,7 @@
 #include "imsrg/model_space/single_particle/reference_state.h"
 #include "imsrg/model_space/single_particle/state.h"
 #include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/orbital_ang_mom.h"
 
 namespace imsrg {
 
@@ -18,6 +19,21 @@ class SPFullBasis {
   static SPFullBasis FromEMaxAndReferenceState(HOEnergy emax,
                                                const ReferenceState& ref);
 
+  // Drops states with l > lmax.
+  static SPFullBasis FromEMaxAndLMax(HOEnergy emax, OrbitalAngMom lmax);
+
+  static SPFullBasis FromEMaxLMaxAndReferenceState(HOEnergy emax,
+                                                   OrbitalAngMom lmax,
+                                                   const ReferenceState& ref);
+
+  // Keeps states with emin <= e <= emax, e.g., a window around the Fermi
+  // surface. Occupations come from ref, so reference states below emin form
+  // an inert core that is not part of the basis.
+  static SPFullBasis FromEMinEMaxAndReferenceState(HOEnergy emin,
+                                                   HOEnergy emax,
+                                                   const ReferenceState& ref);
+
+  // Arbitrary (active) subsets can be built directly from their states.
   explicit SPFullBasis(const std::vector<SPState>& states) : states_(states) {}
 
   // Default copy, move, and destructor
@@ -23,12 +23,19 @@ static std::vector<imsrg::SPChannelKey> ExtractChannelKeys(
     const std::vector<SPChannel>& chans);
 static std::vector<bool> ExtractDefined(const std::vector<SPChannel>& chans,
                                         std::size_t max_index);
+static std::vector<std::size_t> ExtractPositions(
+    const std::vector<SPChannel>& chans, std::size_t max_index);
 static std::vector<std::size_t> ExtractDims(const std::vector<SPChannel>& chans,
                                             std::size_t max_index);
 static std::vector<std::vector<double>> ExtractOccs(
     const std::vector<SPChannel>& chans, std::size_t max_index);
 static std::vector<std::vector<double>> ExtractOccsBar(
     const std::vector<SPChannel>& chans, std::size_t max_index);
+static std::vector<std::size_t> ExtractStateOffsets(
+    const std::vector<SPChannel>& chans, std::size_t max_index);
+static std::vector<std::size_t> ExtractStateIndices(
+    const std::vector<SPChannel>& chans,
+    const std::vector<std::size_t>& state_offsets);
 }  // namespace detail
 
 std::shared_ptr<const SPModelSpace> SPModelSpace::FromFullBasis(
@@ -49,9 +56,13 @@ SPModelSpace::SPModelSpace(const std::vector<SPChannel>& chans)
       max_index_(imsrg::detail::DetermineMaxIndex(chans_)),
       chankeys_(imsrg::detail::ExtractChannelKeys(chans_)),
       defined_(imsrg::detail::ExtractDefined(chans_, max_index_)),
+      positions_(imsrg::detail::ExtractPositions(chans_, max_index_)),
       dims_(imsrg::detail::ExtractDims(chans_, max_index_)),
       occs_(imsrg::detail::ExtractOccs(chans_, max_index_)),
-      occs_bar_(imsrg::detail::ExtractOccsBar(chans_, max_index_)) {
+      occs_bar_(imsrg::detail::ExtractOccsBar(chans_, max_index_)),
+      state_offsets_(imsrg::detail::ExtractStateOffsets(chans_, max_index_)),
+      state_indices_(
+          imsrg::detail::ExtractStateIndices(chans_, state_offsets_)) {
   // Expects(chans are unique)
   // Ensures(chans are sorted)
 }
@@ -113,6 +124,16 @@ std::vector<bool> ExtractDefined(const std::vector<SPChannel>& chans,
   return defined;
 }
 
+std::vector<std::size_t> ExtractPositions(const std::vector<SPChannel>& chans,
+                                          std::size_t max_index) {
+  std::vector<std::size_t> positions(max_index + 1, 0);
+
+  for (std::size_t pos = 0; pos < chans.size(); pos += 1) {
+    positions[chans[pos].Index()] = pos;
+  }
+  return positions;
+}
+
 std::vector<std::size_t> ExtractDims(const std::vector<SPChannel>& chans,
                                      std::size_t max_index) {
   std::vector<std::size_t> sizes(max_index + 1, 0);
@@ -145,6 +166,54 @@ std::vector<std::vector<double>> ExtractOccsBar(
   }
   return occs;
 }
+
+std::vector<std::size_t> ExtractStateOffsets(
+    const std::vector<SPChannel>& chans, std::size_t max_index) {
+  // Number of radial quantum numbers n per channel
+  std::vector<std::size_t> num_ns(max_index + 1, 0);
+  for (const auto& chan : chans) {
+    const auto& basis = chan.ChannelBasis();
+    for (std::size_t i = 0; i < basis.size(); i += 1) {
+      const auto key = basis.at(i).StateKey();
+      if (SPModelSpace::ChannelKeyOfState(key).Index() != chan.Index()) {
+        continue;
+      }
+      num_ns[chan.Index()] =
+          std::max(num_ns[chan.Index()],
+                   static_cast<std::size_t>(key.RadialN().AsInt()) + 1);
+    }
+  }
+
+  std::vector<std::size_t> offsets(max_index + 2, 0);
+  for (std::size_t index = 0; index <= max_index; index += 1) {
+    offsets[index + 1] = offsets[index] + num_ns[index];
+  }
+  return offsets;
+}
+
+std::vector<std::size_t> ExtractStateIndices(
+    const std::vector<SPChannel>& chans,
+    const std::vector<std::size_t>& state_offsets) {
+  std::vector<std::size_t> indices(state_offsets.back(),
+                                   SPPartialBasis::npos);
+
+  for (const auto& chan : chans) {
+    const auto& basis = chan.ChannelBasis();
+    for (std::size_t i = 0; i < basis.size(); i += 1) {
+      const auto key = basis.at(i).StateKey();
+      // States not matching their channel cannot be looked up by key
+      if (SPModelSpace::ChannelKeyOfState(key).Index() != chan.Index()) {
+        continue;
+      }
+      const auto pos = state_offsets[chan.Index()] +
+                       static_cast<std::size_t>(key.RadialN().AsInt());
+      // States must be unique
+      Expects(indices[pos] == SPPartialBasis::npos);
+      indices[pos] = i;
+    }
+  }
+  return indices;
+}
 }  // namespace detail
 
 }  // namespace imsrg
@@ -7,9 +7,12 @@
 #include <utility>
 #include <vector>
 
+#include "imsrg/assert.h"
 #include "imsrg/model_space/single_particle/channel.h"
 #include "imsrg/model_space/single_particle/channel_key.h"
 #include "imsrg/model_space/single_particle/full_basis.h"
+#include "imsrg/model_space/single_particle/partial_basis.h"
+#include "imsrg/model_space/single_particle/state_key.h"
 
 namespace imsrg {
 
@@ -26,32 +29,80 @@ class SPModelSpace {
   const std::vector<SPChannel>& Channels() const { return chans_; }
 
   bool IsChannelInModelSpace(SPChannelKey chankey) const {
-    return defined_[chankey.Index()];
+    return (chankey.Index() < defined_.size()) && defined_[chankey.Index()];
+  }
+
+  const SPChannel& Channel(SPChannelKey chankey) const {
+    Expects(IsChannelInModelSpace(chankey));
+    return chans_[positions_[chankey.Index()]];
   }
 
   std::size_t ChannelDim(SPChannelKey chankey) const;
   const std::vector<double>& Occs(SPChannelKey chankey) const;
   const std::vector<double>& OccsBar(SPChannelKey chankey) const;
 
+  // Channel a state with quantum numbers key belongs to
+  static SPChannelKey ChannelKeyOfState(SPStateKey key) {
+    return SPChannelKey(key.JJ(), key.L().Parity(), key.M_TT());
+  }
+
+  bool IsStateInModelSpace(SPStateKey key) const {
+    return StateIndexPosition(key) != kAbsent;
+  }
+
+  // Index of state in its channel, ChannelKeyOfState(key)
+  std::size_t IndexOfStateInChannel(SPStateKey key) const {
+    const auto pos = StateIndexPosition(key);
+    Expects(pos != kAbsent);
+    return state_indices_[pos];
+  }
+
   void swap(SPModelSpace& other) noexcept {
     using std::swap;
     swap(chans_, other.chans_);
     swap(max_index_, other.max_index_);
     swap(chankeys_, other.chankeys_);
     swap(defined_, other.defined_);
+    swap(positions_, other.positions_);
     swap(dims_, other.dims_);
     swap(occs_, other.occs_);
     swap(occs_bar_, other.occs_bar_);
+    swap(state_offsets_, other.state_offsets_);
+    swap(state_indices_, other.state_indices_);
   }
 
  private:
+  static constexpr std::size_t kAbsent = SPPartialBasis::npos;
+
   std::vector<SPChannel> chans_;
   std::size_t max_index_;
   std::vector<SPChannelKey> chankeys_;
   std::vector<bool> defined_;
+  // Position in chans_, indexed by SPChannelKey::Index()
+  std::vector<std::size_t> positions_;
   std::vector<std::size_t> dims_;
   std::vector<std::vector<double>> occs_;
   std::vector<std::vector<double>> occs_bar_;
+  // In-channel index of states, indexed by
+  // state_offsets_[SPChannelKey::Index()] + n. Within a channel, the radial
+  // quantum number n determines the state.
+  std::vector<std::size_t> state_offsets_;
+  std::vector<std::size_t> state_indices_;
+
+  // Position in state_indices_ for state key, kAbsent if not present
+  std::size_t StateIndexPosition(SPStateKey key) const {
+    const auto chan_index = ChannelKeyOfState(key).Index();
+    if (!((chan_index < defined_.size()) && defined_[chan_index])) {
+      return kAbsent;
+    }
+    const auto pos = state_offsets_[chan_index] +
+                     static_cast<std::size_t>(key.RadialN().AsInt());
+    if ((pos >= state_offsets_[chan_index + 1]) ||
+        (state_indices_[pos] == kAbsent)) {
+      return kAbsent;
+    }
+    return pos;
+  }
 };
 
 inline void swap(SPModelSpace& a, SPModelSpace& b) noexcept { a.swap(b); }
@@ -7,18 +7,24 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 
+#include "imsrg/assert.h"
+#include "imsrg/model_space/single_particle/state_key.h"
+
 namespace imsrg {
 namespace detail {
 static std::vector<double> ExtractOccsFromStatesVector(
     const std::vector<SPState>& states);
 static std::vector<double> ExtractOccsBarFromStatesVector(
     const std::vector<SPState>& states);
+static absl::flat_hash_map<imsrg::SPStateKey, std::size_t>
+GenerateStateIndexLookup(const std::vector<SPState>& states);
 }  // namespace detail
 
 SPPartialBasis::SPPartialBasis(const std::vector<SPState>& states)
     : states_(states),
       occs_(imsrg::detail::ExtractOccsFromStatesVector(states)),
-      occs_bar_(imsrg::detail::ExtractOccsBarFromStatesVector(states)) {}
+      occs_bar_(imsrg::detail::ExtractOccsBarFromStatesVector(states)),
+      indices_(imsrg::detail::GenerateStateIndexLookup(states)) {}
 
 absl::flat_hash_map<imsrg::JJ_P_M_TT, std::shared_ptr<const SPPartialBasis>>
 PartitionSPFullBasisIntoSPPartialBases(const imsrg::SPFullBasis& full_basis) {
@@ -67,5 +73,17 @@ static std::vector<double> ExtractOccsBarFromStatesVector(
   }
   return occsbar;
 }
+static absl::flat_hash_map<imsrg::SPStateKey, std::size_t>
+GenerateStateIndexLookup(const std::vector<SPState>& states) {
+  absl::flat_hash_map<imsrg::SPStateKey, std::size_t> lookup;
+  lookup.reserve(states.size());
+
+  for (std::size_t index = 0; index < states.size(); index += 1) {
+    const auto [it, inserted] = lookup.emplace(states[index].StateKey(), index);
+    // States must be unique
+    Expects(inserted);
+  }
+  return lookup;
+}
 }  // namespace detail
 }  // namespace imsrg
@@ -2,6 +2,7 @@
 #ifndef IMSRG_MODEL_SPACE_SINGLE_PARTICLE_PARTIAL_BASIS_H_
 #define IMSRG_MODEL_SPACE_SINGLE_PARTICLE_PARTIAL_BASIS_H_
 
+#include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -11,11 +12,14 @@
 #include "imsrg/model_space/jj_p_m_tt.h"
 #include "imsrg/model_space/single_particle/full_basis.h"
 #include "imsrg/model_space/single_particle/state.h"
+#include "imsrg/model_space/single_particle/state_key.h"
 
 namespace imsrg {
 
 class SPPartialBasis {
  public:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
   explicit SPPartialBasis(const std::vector<SPState>& states);
 
   // Default copy, move, and destructor
@@ -24,6 +28,16 @@ class SPPartialBasis {
 
   SPState at(std::size_t index) const { return states_[index]; }
 
+  // Index of the state with quantum numbers key, npos if it is not in the
+  // basis.
+  std::size_t IndexOf(SPStateKey key) const {
+    const auto search = indices_.find(key);
+    if (search == indices_.end()) {
+      return npos;
+    }
+    return search->second;
+  }
+
   const std::vector<double>& Occs() const { return occs_; }
   const std::vector<double>& OccsBar() const { return occs_bar_; }
 
@@ -32,6 +46,7 @@ class SPPartialBasis {
     swap(states_, other.states_);
     swap(occs_, other.occs_);
     swap(occs_bar_, other.occs_bar_);
+    swap(indices_, other.indices_);
   }
 
  private:
@@ -40,7 +55,7 @@ class SPPartialBasis {
   std::vector<double> occs_;
   // Vector of inverse occupations for fast access
   std::vector<double> occs_bar_;
-  // TODO(mheinz): add lookup table for states to indices
+  absl::flat_hash_map<SPStateKey, std::size_t> indices_;
 };
 
 inline void swap(SPPartialBasis& a, SPPartialBasis& b) noexcept { a.swap(b); }
@@ -13,6 +13,7 @@
 #include "imsrg/model_space/single_particle/state_string.h"
 #include "imsrg/quantum_numbers/ho_energy.h"
 #include "imsrg/quantum_numbers/occupation_number.h"
+#include "imsrg/quantum_numbers/orbital_ang_mom.h"
 
 namespace imsrg {
 
@@ -57,6 +58,20 @@ ValidationResult ReferenceState::ValidateAgainstEMax(HOEnergy emax) const {
   return {true};
 }
 
+ValidationResult ReferenceState::ValidateAgainstLMax(
+    OrbitalAngMom lmax) const {
+  for (const auto& it : ref_states_) {
+    if (it.second.L() > lmax) {
+      return {false,
+              fmt::format("{} state in reference state with occupation "
+                          "{} is outside of lmax={} truncation.",
+                          it.second.StateString().String(),
+                          it.second.OccupationN().AsDouble(), lmax.AsInt())};
+    }
+  }
+  return {true};
+}
+
 ReferenceState ReferenceState::FromProtonAndNeutronMax(
     const SPStateString& p_max, const SPStateString& n_max) {
   auto p_states = SPStateString::GetProtonOrbitalsUpToMax(p_max);
@@ -12,6 +12,7 @@
 #include "imsrg/model_space/single_particle/state_key.h"
 #include "imsrg/model_space/single_particle/state_string.h"
 #include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/orbital_ang_mom.h"
 
 namespace imsrg {
 class ReferenceState {
@@ -27,6 +28,8 @@ class ReferenceState {
 
   ValidationResult ValidateAgainstEMax(HOEnergy emax) const;
 
+  ValidationResult ValidateAgainstLMax(OrbitalAngMom lmax) const;
+
   void swap(ReferenceState& other) noexcept {
     using std::swap;
     swap(ref_states_, other.ref_states_);
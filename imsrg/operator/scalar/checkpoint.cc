@@ -0,0 +1,435 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/checkpoint.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fmt/core.h"
+#include "ntcl/data/f_array.h"
+
+#include "imsrg/assert.h"
+#include "imsrg/error.h"
+#include "imsrg/files/formats/helpers/binary.h"
+#include "imsrg/openmp_runtime.h"
+#include "imsrg/operator/scalar/operator.h"
+
+namespace imsrg {
+
+namespace detail {
+struct CheckpointHeader {
+  std::uint64_t magic;
+  std::uint32_t version;
+  std::int32_t herm;
+  std::uint64_t num_1b_chans;
+  std::uint64_t num_2b_chans;
+  double zero_body;
+  // Offset of the first channel tensor in bytes
+  std::uint64_t data_offset;
+  std::uint64_t reserved[2];
+};
+static_assert(sizeof(CheckpointHeader) == 64,
+              "CheckpointHeader must keep the records 8 B aligned.");
+
+struct CheckpointChannelRecord {
+  // SP channel keys of p, q, r, s (0 for r, s of 1B channels)
+  std::uint64_t sp_chan_keys[4];
+  std::int64_t jj;
+  // Offset in bytes and number of matrix elements
+  std::uint64_t offset;
+  std::uint64_t size;
+  std::uint64_t checksum;
+};
+static_assert(sizeof(CheckpointChannelRecord) == 64,
+              "CheckpointChannelRecord must keep the tensors 8 B aligned.");
+
+// "IMSRGCKP"
+constexpr std::uint64_t kCheckpointMagic = 0x504B434752534D49;
+// Bump whenever the layout or the checksum changes.
+constexpr std::uint32_t kCheckpointVersion = 2;
+// Channel tensors start at a page boundary, so they can be mapped directly.
+constexpr std::size_t kCheckpointAlignment = 4096;
+
+// Records (without checksums) for the channels of op, 1B channels first
+static std::vector<CheckpointChannelRecord> MakeChannelRecords(
+    const ScalarOperator& op);
+
+static std::size_t CheckpointFileSize(
+    const std::vector<CheckpointChannelRecord>& records);
+
+static void WriteCheckpointFile(const ScalarOperator& op,
+                                const std::string& path_to_file,
+                                bool parallel);
+
+static void CopyTensorTo(const ntcl::FArray<double, 2>& tensor, double* dest);
+static void CopyTensorTo(const ntcl::FArray<double, 4>& tensor, double* dest);
+
+static void CopyTensorFrom(const double* src, ntcl::FArray<double, 2>& tensor);
+static void CopyTensorFrom(const double* src, ntcl::FArray<double, 4>& tensor);
+
+// Read-only private mapping of a whole file, unmapped on destruction.
+class MappedCheckpointFile {
+ public:
+  explicit MappedCheckpointFile(const std::string& path);
+  ~MappedCheckpointFile();
+
+  MappedCheckpointFile(const MappedCheckpointFile&) = delete;
+  MappedCheckpointFile& operator=(const MappedCheckpointFile&) = delete;
+
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+}  // namespace detail
+
+void WriteCheckpoint(const ScalarOperator& op,
+                     const std::string& path_to_file) {
+  imsrg::detail::WriteCheckpointFile(op, path_to_file, true);
+}
+
+void ReadCheckpoint(const std::string& path_to_file, ScalarOperator& op) {
+  using imsrg::detail::CheckpointChannelRecord;
+  using imsrg::detail::CheckpointHeader;
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const imsrg::detail::MappedCheckpointFile file(path_to_file);
+  imsrg::CheckForError(
+      file.data() == nullptr,
+      fmt::format("Failed to open checkpoint at {}", path_to_file));
+  imsrg::CheckForError(
+      file.size() < sizeof(CheckpointHeader),
+      fmt::format("Checkpoint at {} is truncated.", path_to_file));
+
+  CheckpointHeader header;
+  std::memcpy(&header, file.data(), sizeof(header));
+  imsrg::CheckForError(
+      (header.magic != imsrg::detail::kCheckpointMagic) ||
+          (header.version != imsrg::detail::kCheckpointVersion),
+      fmt::format("File at {} is not a checkpoint of this version.",
+                  path_to_file));
+  imsrg::CheckForError(
+      header.herm != op.Herm().Factor(),
+      fmt::format("Checkpoint at {} has hermiticity {}, expected {}.",
+                  path_to_file, header.herm, op.Herm().Factor()));
+
+  const auto expected_records = imsrg::detail::MakeChannelRecords(op);
+  const std::size_t num_1b_chans = op.OneBodyPart().size();
+  const std::size_t num_2b_chans = op.TwoBodyPart().size();
+  imsrg::CheckForError(
+      (header.num_1b_chans != num_1b_chans) ||
+          (header.num_2b_chans != num_2b_chans),
+      fmt::format("Checkpoint at {} has {} + {} channels, expected {} + {}.",
+                  path_to_file, header.num_1b_chans, header.num_2b_chans,
+                  num_1b_chans, num_2b_chans));
+  imsrg::CheckForError(
+      file.size() != imsrg::detail::CheckpointFileSize(expected_records),
+      fmt::format("Checkpoint at {} has size {} B, expected {} B.",
+                  path_to_file, file.size(),
+                  imsrg::detail::CheckpointFileSize(expected_records)));
+
+  std::vector<CheckpointChannelRecord> records(expected_records.size());
+  std::memcpy(records.data(), file.data() + sizeof(header),
+              records.size() * sizeof(CheckpointChannelRecord));
+  for (std::size_t i = 0; i < records.size(); i += 1) {
+    const auto& record = records[i];
+    const auto& expected = expected_records[i];
+    const bool same_channel =
+        (std::memcmp(record.sp_chan_keys, expected.sp_chan_keys,
+                     sizeof(record.sp_chan_keys)) == 0) &&
+        (record.jj == expected.jj) && (record.offset == expected.offset) &&
+        (record.size == expected.size);
+    imsrg::CheckForError(
+        !same_channel,
+        fmt::format("Checkpoint at {} was written for another model space "
+                    "(channel {} differs).",
+                    path_to_file, i));
+  }
+
+  // Checksums are verified while copying, errors are reported afterwards.
+  std::vector<std::uint8_t> corrupt(records.size(), 0);
+  const auto channel_data = [&file, &records](std::size_t i) {
+    return reinterpret_cast<const double*>(file.data() + records[i].offset);
+  };
+  const auto verify = [&records, &corrupt](std::size_t i, const double* src) {
+    if (imsrg::mexj::MEChecksum(src, records[i].size) != records[i].checksum) {
+      corrupt[i] = 1;
+    }
+  };
+
+  auto& op_1b = op.MutableOneBodyPart();
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t i = 0; i < num_1b_chans; i += 1) {
+    const double* src = channel_data(i);
+    verify(i, src);
+    imsrg::detail::CopyTensorFrom(src, op_1b.GetMutableTensorAtIndex(i));
+  }
+
+  auto& op_2b = op.MutableTwoBodyPart();
+  const bool in_memory = !op_2b.IsOutOfCore();
+  // Same schedule as first-touch placement, out-of-core operators are filled
+  // one channel at a time.
+#pragma omp parallel for schedule(static) if (in_memory)
+  for (std::size_t i = 0; i < num_2b_chans; i += 1) {
+    const double* src = channel_data(num_1b_chans + i);
+    verify(num_1b_chans + i, src);
+    auto tensor = op_2b.GetMutableTensorAtIndex(i);
+    imsrg::detail::CopyTensorFrom(src, tensor);
+    op_2b.EvictTensorAtIndex(i);
+  }
+
+  for (std::size_t i = 0; i < records.size(); i += 1) {
+    imsrg::CheckForError(
+        corrupt[i] != 0,
+        fmt::format("Checkpoint at {} is corrupt (checksum of channel {}).",
+                    path_to_file, i));
+  }
+  op.SetZeroBodyPart(header.zero_body);
+}
+
+AsyncCheckpointWriter::~AsyncCheckpointWriter() {
+  if (pending_.valid()) {
+    pending_.wait();
+  }
+}
+
+void AsyncCheckpointWriter::Write(const ScalarOperator& op,
+                                  const std::string& path_to_file) {
+  Wait();
+  // Copy-on-write snapshot, taken on the calling thread
+  pending_ = std::async(std::launch::async,
+                        [snapshot = op, path_to_file]() {
+                          imsrg::detail::WriteCheckpointFile(
+                              snapshot, path_to_file, false);
+                        });
+}
+
+void AsyncCheckpointWriter::Wait() {
+  if (pending_.valid()) {
+    // Invalidates pending_, also if get throws
+    pending_.get();
+  }
+}
+
+namespace detail {
+std::vector<CheckpointChannelRecord> MakeChannelRecords(
+    const ScalarOperator& op) {
+  const auto& ms_1b = op.GetModelSpace().OneBodyModelSpace();
+  const auto& ms_2b = op.GetModelSpace().TwoBodyModelSpace();
+  const auto& layout = ms_2b.ChannelLayout();
+
+  std::vector<CheckpointChannelRecord> records;
+  records.reserve(ms_1b.NumberOfChannels() + ms_2b.NumberOfChannels());
+  for (std::size_t i = 0; i < ms_1b.NumberOfChannels(); i += 1) {
+    const auto& chan = ms_1b.ChannelAtIndex(i);
+    const auto& tensor = op.OneBodyPart().GetTensorAtIndex(i);
+    CheckpointChannelRecord record = {};
+    record.sp_chan_keys[0] = chan.BraChannel().Index();
+    record.sp_chan_keys[1] = chan.KetChannel().Index();
+    record.size = tensor.dim_size(0) * tensor.dim_size(1);
+    records.push_back(record);
+  }
+  for (std::size_t i = 0; i < ms_2b.NumberOfChannels(); i += 1) {
+    const auto chankey = ms_2b.ChannelAtIndex(i).ChannelKey();
+    CheckpointChannelRecord record = {};
+    record.sp_chan_keys[0] = chankey.BraChannelKey().p_chan_key.Index();
+    record.sp_chan_keys[1] = chankey.BraChannelKey().q_chan_key.Index();
+    record.sp_chan_keys[2] = chankey.KetChannelKey().p_chan_key.Index();
+    record.sp_chan_keys[3] = chankey.KetChannelKey().q_chan_key.Index();
+    record.jj = chankey.OpChannel().JJ().AsInt();
+    record.size = layout.ChannelSize(i);
+    records.push_back(record);
+  }
+
+  const std::size_t records_end =
+      sizeof(CheckpointHeader) +
+      records.size() * sizeof(CheckpointChannelRecord);
+  std::size_t offset = (records_end + kCheckpointAlignment - 1) /
+                       kCheckpointAlignment * kCheckpointAlignment;
+  for (auto& record : records) {
+    record.offset = offset;
+    offset += record.size * sizeof(double);
+  }
+  return records;
+}
+
+std::size_t CheckpointFileSize(
+    const std::vector<CheckpointChannelRecord>& records) {
+  if (records.empty()) {
+    return sizeof(CheckpointHeader);
+  }
+  return records.back().offset + records.back().size * sizeof(double);
+}
+
+void WriteCheckpointFile(const ScalarOperator& op,
+                         const std::string& path_to_file, bool parallel) {
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  auto records = MakeChannelRecords(op);
+  const std::size_t num_1b_chans = op.OneBodyPart().size();
+  const std::size_t num_2b_chans = op.TwoBodyPart().size();
+  const std::size_t size_in_bytes = CheckpointFileSize(records);
+
+  CheckpointHeader header = {};
+  header.magic = kCheckpointMagic;
+  header.version = kCheckpointVersion;
+  header.herm = op.Herm().Factor();
+  header.num_1b_chans = num_1b_chans;
+  header.num_2b_chans = num_2b_chans;
+  header.zero_body = op.ZeroBodyPart();
+  header.data_offset = records.empty() ? size_in_bytes : records[0].offset;
+
+  // Write to a temporary file first so a preempted run never leaves a
+  // partial checkpoint.
+  const std::string tmp_path = path_to_file + ".tmp";
+  const int fd = open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  imsrg::CheckForError(
+      fd < 0, fmt::format("Failed to create checkpoint at {}: {}", tmp_path,
+                          std::strerror(errno)));
+  if (ftruncate(fd, static_cast<off_t>(size_in_bytes)) != 0) {
+    close(fd);
+    imsrg::Error(fmt::format("Failed to resize checkpoint at {} to {} B",
+                             tmp_path, size_in_bytes));
+  }
+  void* map =
+      mmap(nullptr, size_in_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    close(fd);
+    imsrg::Error(fmt::format("Failed to map checkpoint at {}: {}", tmp_path,
+                             std::strerror(errno)));
+  }
+  char* data = static_cast<char*>(map);
+
+  const auto& op_1b = op.OneBodyPart();
+#pragma omp parallel for schedule(dynamic) if (parallel)
+  for (std::size_t i = 0; i < num_1b_chans; i += 1) {
+    auto* dest = reinterpret_cast<double*>(data + records[i].offset);
+    CopyTensorTo(op_1b.GetTensorAtIndex(i), dest);
+    records[i].checksum = imsrg::mexj::MEChecksum(dest, records[i].size);
+  }
+
+  const auto& op_2b = op.TwoBodyPart();
+#pragma omp parallel for schedule(dynamic) if (parallel)
+  for (std::size_t i = 0; i < num_2b_chans; i += 1) {
+    auto& record = records[num_1b_chans + i];
+    auto* dest = reinterpret_cast<double*>(data + record.offset);
+    CopyTensorTo(op_2b.GetTensorAtIndex(i), dest);
+    record.checksum = imsrg::mexj::MEChecksum(dest, record.size);
+  }
+
+  std::memcpy(data, &header, sizeof(header));
+  std::memcpy(data + sizeof(header), records.data(),
+              records.size() * sizeof(CheckpointChannelRecord));
+
+  const bool synced = (msync(map, size_in_bytes, MS_SYNC) == 0);
+  munmap(map, size_in_bytes);
+  close(fd);
+  imsrg::CheckForError(
+      !synced, fmt::format("Failed to write checkpoint at {}: {}", tmp_path,
+                           std::strerror(errno)));
+  imsrg::CheckForError(
+      std::rename(tmp_path.c_str(), path_to_file.c_str()) != 0,
+      fmt::format("Failed to move checkpoint to {}", path_to_file));
+}
+
+void CopyTensorTo(const ntcl::FArray<double, 2>& tensor, double* dest) {
+  std::size_t index = 0;
+  for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+    for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+      dest[index] = tensor(p, q);
+      index += 1;
+    }
+  }
+}
+
+void CopyTensorTo(const ntcl::FArray<double, 4>& tensor, double* dest) {
+  const auto dim_p = tensor.dim_size(0);
+  const auto dim_q = tensor.dim_size(1);
+  const auto dim_r = tensor.dim_size(2);
+  const auto dim_s = tensor.dim_size(3);
+  std::size_t index = 0;
+  for (std::size_t s = 0; s < dim_s; s += 1) {
+    for (std::size_t r = 0; r < dim_r; r += 1) {
+      for (std::size_t q = 0; q < dim_q; q += 1) {
+        for (std::size_t p = 0; p < dim_p; p += 1) {
+          dest[index] = tensor(p, q, r, s);
+          index += 1;
+        }
+      }
+    }
+  }
+}
+
+void CopyTensorFrom(const double* src, ntcl::FArray<double, 2>& tensor) {
+  std::size_t index = 0;
+  for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+    for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+      tensor(p, q) = src[index];
+      index += 1;
+    }
+  }
+}
+
+void CopyTensorFrom(const double* src, ntcl::FArray<double, 4>& tensor) {
+  const auto dim_p = tensor.dim_size(0);
+  const auto dim_q = tensor.dim_size(1);
+  const auto dim_r = tensor.dim_size(2);
+  const auto dim_s = tensor.dim_size(3);
+  std::size_t index = 0;
+  for (std::size_t s = 0; s < dim_s; s += 1) {
+    for (std::size_t r = 0; r < dim_r; r += 1) {
+      for (std::size_t q = 0; q < dim_q; q += 1) {
+        for (std::size_t p = 0; p < dim_p; p += 1) {
+          tensor(p, q, r, s) = src[index];
+          index += 1;
+        }
+      }
+    }
+  }
+}
+
+MappedCheckpointFile::MappedCheckpointFile(const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat file_stat;
+  if ((fstat(fd, &file_stat) != 0) || (file_stat.st_size <= 0)) {
+    close(fd);
+    return;
+  }
+  const auto size = static_cast<std::size_t>(file_stat.st_size);
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (map == MAP_FAILED) {
+    return;
+  }
+  data_ = static_cast<const char*>(map);
+  size_ = size;
+}
+
+MappedCheckpointFile::~MappedCheckpointFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+}  // namespace detail
+
+}  // namespace imsrg
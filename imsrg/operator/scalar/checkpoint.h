@@ -0,0 +1,64 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_OPERATOR_SCALAR_CHECKPOINT_H_
+#define IMSRG_OPERATOR_SCALAR_CHECKPOINT_H_
+
+#include <future>
+#include <string>
+
+#include "imsrg/operator/scalar/operator.h"
+
+namespace imsrg {
+
+// Checkpoint files hold a ScalarOperator in its internal channel layout
+// (native byte order):
+//
+// Header (64 B): magic, version, hermiticity, number of channels,
+//   zero-body part
+// Channel record (64 B) x (1B channels + 2B channels): SP channel keys and
+//   2 * J of the channel (the model space signature), offset and number of
+//   matrix elements, and the checksum of the matrix elements (see
+//   mexj::MEChecksum)
+// Channel tensors (column-major), starting at a page boundary
+//
+// Files are written to a temporary file in parallel over channels and then
+// moved into place, so a preempted run never leaves a partial checkpoint.
+// Writing an out-of-core operator loads all of its tensors.
+void WriteCheckpoint(const ScalarOperator& op, const std::string& path_to_file);
+
+// Maps the checkpoint and reads it into op in parallel over channels,
+// verifying the checksum of each channel. Throws if the file was written for
+// another model space or hermiticity, or is truncated or corrupt.
+void ReadCheckpoint(const std::string& path_to_file, ScalarOperator& op);
+
+// Writes checkpoints on a background thread, so the next flow step can run
+// while the previous checkpoint is written.
+//
+// Write takes a copy-on-write snapshot of the operator (see
+// Scalar2BOperator), so changing the operator afterwards only copies the
+// channels that are modified before the write finishes. The background write
+// runs on one thread to leave the cores to the flow step.
+class AsyncCheckpointWriter {
+ public:
+  AsyncCheckpointWriter() = default;
+
+  AsyncCheckpointWriter(const AsyncCheckpointWriter&) = delete;
+  AsyncCheckpointWriter& operator=(const AsyncCheckpointWriter&) = delete;
+
+  // Waits for a pending write, errors are only reported by Wait.
+  ~AsyncCheckpointWriter();
+
+  // Waits for the previous write (see Wait) and starts writing op.
+  void Write(const ScalarOperator& op, const std::string& path_to_file);
+
+  bool IsWriting() const { return pending_.valid(); }
+
+  // Waits for the pending write, if any, and rethrows its error.
+  void Wait();
+
+ private:
+  std::future<void> pending_;
+};
+
+}  // namespace imsrg
+
+#endif  // IMSRG_OPERATOR_SCALAR_CHECKPOINT_H_
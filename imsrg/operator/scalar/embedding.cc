@@ -0,0 +1,184 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/embedding.h"
+
+#include <memory>
+#include <vector>
+
+#include "imsrg/assert.h"
+#include "imsrg/model_space/scalar/model_space.h"
+#include "imsrg/model_space/scalar/one_body/model_space.h"
+#include "imsrg/model_space/scalar/two_body/model_space.h"
+#include "imsrg/model_space/single_particle/channel.h"
+#include "imsrg/model_space/single_particle/partial_basis.h"
+#include "imsrg/openmp_runtime.h"
+#include "imsrg/operator/scalar/one_body/operator.h"
+#include "imsrg/operator/scalar/operator.h"
+#include "imsrg/operator/scalar/two_body/operator.h"
+
+namespace imsrg {
+
+namespace detail {
+// Index in from_chan of the first to_dim states of to_chan,
+// SPPartialBasis::npos if not among the first from_dim states of from_chan.
+static std::vector<std::size_t> GenerateIndexMap(const SPChannel& to_chan,
+                                                 std::size_t to_dim,
+                                                 const SPChannel& from_chan,
+                                                 std::size_t from_dim);
+
+static bool AnyIndexMapped(const std::vector<std::size_t>& index_map);
+}  // namespace detail
+
+void CopyMatrixElementsInCommonStates(const Scalar1BOperator& from,
+                                      Scalar1BOperator& to) {
+  Expects(from.Herm() == to.Herm());
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const auto& from_ms = from.GetModelSpace();
+  const auto& to_ms = to.GetModelSpace();
+
+#pragma omp parallel for schedule(static)
+  for (std::size_t index = 0; index < to_ms.NumberOfChannels(); index += 1) {
+    const auto& to_chan = to_ms.ChannelAtIndex(index);
+    if (!from_ms.IsChannelInModelSpace(to_chan.ChannelKey())) {
+      continue;
+    }
+    const auto from_index =
+        from_ms.IndexOfChannelInModelSpace(to_chan.ChannelKey());
+    const auto& from_chan = from_ms.ChannelAtIndex(from_index);
+
+    const auto map_p = imsrg::detail::GenerateIndexMap(
+        to_chan.BraChannel(), to_chan.BraChannel().size(),
+        from_chan.BraChannel(), from_chan.BraChannel().size());
+    const auto map_q = imsrg::detail::GenerateIndexMap(
+        to_chan.KetChannel(), to_chan.KetChannel().size(),
+        from_chan.KetChannel(), from_chan.KetChannel().size());
+
+    const auto& from_tensor = from.GetTensorAtIndex(from_index);
+    auto& to_tensor = to.GetMutableTensorAtIndex(index);
+    for (std::size_t q = 0; q < map_q.size(); q += 1) {
+      if (map_q[q] == SPPartialBasis::npos) {
+        continue;
+      }
+      for (std::size_t p = 0; p < map_p.size(); p += 1) {
+        if (map_p[p] == SPPartialBasis::npos) {
+          continue;
+        }
+        to_tensor(p, q) = from_tensor(map_p[p], map_q[q]);
+      }
+    }
+  }
+}
+
+void CopyMatrixElementsInCommonStates(const Scalar2BOperator& from,
+                                      Scalar2BOperator& to) {
+  Expects(from.Herm() == to.Herm());
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const auto& from_ms = from.GetModelSpace();
+  const auto& to_ms = to.GetModelSpace();
+
+#pragma omp parallel for schedule(static)
+  for (std::size_t index = 0; index < to_ms.NumberOfChannels(); index += 1) {
+    const auto& to_chan = to_ms.ChannelAtIndex(index);
+    const auto from_index =
+        from_ms.ChannelIndexLookup().Find(to_chan.ChannelKey());
+    if (from_index == Scalar2BChannelIndexLookup::npos) {
+      continue;
+    }
+    const auto& from_chan = from_ms.ChannelAtIndex(from_index);
+
+    const auto map_p = imsrg::detail::GenerateIndexMap(
+        to_chan.BraChannel1(), to_chan.BraDim1(), from_chan.BraChannel1(),
+        from_chan.BraDim1());
+    const auto map_q = imsrg::detail::GenerateIndexMap(
+        to_chan.BraChannel2(), to_chan.BraDim2(), from_chan.BraChannel2(),
+        from_chan.BraDim2());
+    const auto map_r = imsrg::detail::GenerateIndexMap(
+        to_chan.KetChannel1(), to_chan.KetDim1(), from_chan.KetChannel1(),
+        from_chan.KetDim1());
+    const auto map_s = imsrg::detail::GenerateIndexMap(
+        to_chan.KetChannel2(), to_chan.KetDim2(), from_chan.KetChannel2(),
+        from_chan.KetDim2());
+
+    // Avoid detaching tensors shared with copies of to if nothing changes.
+    if (!imsrg::detail::AnyIndexMapped(map_p) ||
+        !imsrg::detail::AnyIndexMapped(map_q) ||
+        !imsrg::detail::AnyIndexMapped(map_r) ||
+        !imsrg::detail::AnyIndexMapped(map_s)) {
+      continue;
+    }
+
+    const auto& from_tensor = from.GetTensorAtIndex(from_index);
+    auto to_tensor = to.GetMutableTensorAtIndex(index);
+    for (std::size_t s = 0; s < map_s.size(); s += 1) {
+      if (map_s[s] == SPPartialBasis::npos) {
+        continue;
+      }
+      for (std::size_t r = 0; r < map_r.size(); r += 1) {
+        if (map_r[r] == SPPartialBasis::npos) {
+          continue;
+        }
+        for (std::size_t q = 0; q < map_q.size(); q += 1) {
+          if (map_q[q] == SPPartialBasis::npos) {
+            continue;
+          }
+          for (std::size_t p = 0; p < map_p.size(); p += 1) {
+            if (map_p[p] == SPPartialBasis::npos) {
+              continue;
+            }
+            to_tensor(p, q, r, s) =
+                from_tensor(map_p[p], map_q[q], map_r[r], map_s[s]);
+          }
+        }
+      }
+    }
+  }
+}
+
+ScalarOperator TransferToModelSpace(
+    const ScalarOperator& op,
+    const std::shared_ptr<const ScalarModelSpace>& ms_ptr) {
+  auto new_op = ScalarOperator::FromScalarModelSpace(ms_ptr, op.Herm());
+
+  new_op.SetZeroBodyPart(op.ZeroBodyPart());
+  CopyMatrixElementsInCommonStates(op.OneBodyPart(),
+                                   new_op.MutableOneBodyPart());
+  CopyMatrixElementsInCommonStates(op.TwoBodyPart(),
+                                   new_op.MutableTwoBodyPart());
+
+  return new_op;
+}
+
+namespace detail {
+std::vector<std::size_t> GenerateIndexMap(const SPChannel& to_chan,
+                                          std::size_t to_dim,
+                                          const SPChannel& from_chan,
+                                          std::size_t from_dim) {
+  const auto& to_basis = to_chan.ChannelBasis();
+  const auto& from_basis = from_chan.ChannelBasis();
+
+  std::vector<std::size_t> index_map(to_dim, SPPartialBasis::npos);
+  for (std::size_t i = 0; i < to_dim; i += 1) {
+    const auto from_i = from_basis.IndexOf(to_basis.at(i).StateKey());
+    if (from_i < from_dim) {
+      index_map[i] = from_i;
+    }
+  }
+  return index_map;
+}
+
+bool AnyIndexMapped(const std::vector<std::size_t>& index_map) {
+  for (const auto i : index_map) {
+    if (i != SPPartialBasis::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace detail
+
+}  // namespace imsrg
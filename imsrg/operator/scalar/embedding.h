@@ -0,0 +1,38 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_OPERATOR_SCALAR_EMBEDDING_H_
+#define IMSRG_OPERATOR_SCALAR_EMBEDDING_H_
+
+#include <memory>
+
+#include "imsrg/model_space/scalar/model_space.h"
+#include "imsrg/operator/scalar/one_body/operator.h"
+#include "imsrg/operator/scalar/operator.h"
+#include "imsrg/operator/scalar/two_body/operator.h"
+
+namespace imsrg {
+
+// Copies the matrix elements of from between states that are also in the
+// model space of to. Matrix elements of to involving states not in the model
+// space of from are left unchanged.
+//
+// Model spaces are matched by state quantum numbers, so this restricts an
+// operator to a subset of orbitals (e.g., an energy window or active space)
+// if to is built on the subset, and embeds it if to is built on a larger
+// space (leaving the added matrix elements zero for a new operator).
+void CopyMatrixElementsInCommonStates(const Scalar1BOperator& from,
+                                      Scalar1BOperator& to);
+void CopyMatrixElementsInCommonStates(const Scalar2BOperator& from,
+                                      Scalar2BOperator& to);
+
+// New operator on ms_ptr with the zero-body part of op and the one- and
+// two-body matrix elements of op in common states.
+//
+// The zero-body part is not renormalized: it is the caller's responsibility
+// to account for contributions of states outside of ms_ptr.
+ScalarOperator TransferToModelSpace(
+    const ScalarOperator& op,
+    const std::shared_ptr<const ScalarModelSpace>& ms_ptr);
+
+}  // namespace imsrg
+
+#endif  // IMSRG_OPERATOR_SCALAR_EMBEDDING_H_
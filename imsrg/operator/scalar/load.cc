@@ -0,0 +1,136 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/load.h"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "imsrg/assert.h"
+#include "imsrg/files/formats/me1j.h"
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/model_space/scalar/model_space.h"
+#include "imsrg/openmp_runtime.h"
+#include "imsrg/operator/scalar/one_body/read.h"
+#include "imsrg/operator/scalar/operator.h"
+#include "imsrg/operator/scalar/two_body/read.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+namespace imsrg {
+
+namespace detail {
+static ME1JFile ReadME1JFile(const std::string& path_to_file,
+                             MEXJFileFormat format, HOEnergy emax,
+                             Hermiticity herm);
+
+static ME2JPFile ReadME2JPFile(const std::string& path_to_file,
+                               MEXJFileFormat format, HOEnergy emax,
+                               Hermiticity herm);
+
+template <typename T>
+static bool IsFutureReady(const std::future<T>& future) {
+  return future.valid() && future.wait_for(std::chrono::seconds(0)) ==
+                               std::future_status::ready;
+}
+}  // namespace detail
+
+ScalarOperatorLoader ScalarOperatorLoader::FromME1JAndME2JPFiles(
+    std::string path_to_me1j, std::string path_to_me2jp,
+    MEXJFileFormat format, HOEnergy emax, Hermiticity herm) {
+  // Parallel parsing on the reader threads needs the runtime, which is
+  // initialized here to not race with the caller.
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  auto me1j = std::async(std::launch::async, [=]() {
+    return imsrg::detail::ReadME1JFile(path_to_me1j, format, emax, herm);
+  });
+  auto me2jp = std::async(std::launch::async, [=]() {
+    return imsrg::detail::ReadME2JPFile(path_to_me2jp, format, emax, herm);
+  });
+  return ScalarOperatorLoader(herm, std::move(me1j), std::move(me2jp));
+}
+
+bool ScalarOperatorLoader::IsReady() const {
+  return imsrg::detail::IsFutureReady(me1j_) &&
+         imsrg::detail::IsFutureReady(me2jp_);
+}
+
+ScalarOperator ScalarOperatorLoader::Load(
+    const std::shared_ptr<const ScalarModelSpace>& ms_ptr) {
+  return LoadWith(ms_ptr, nullptr);
+}
+
+ScalarOperator ScalarOperatorLoader::Load(
+    const std::shared_ptr<const ScalarModelSpace>& ms_ptr,
+    const ME2JPReadPlan& plan) {
+  return LoadWith(ms_ptr, &plan);
+}
+
+ScalarOperatorLoader::ScalarOperatorLoader(Hermiticity herm,
+                                           std::future<ME1JFile>&& me1j,
+                                           std::future<ME2JPFile>&& me2jp)
+    : herm_(herm), me1j_(std::move(me1j)), me2jp_(std::move(me2jp)) {
+  Expects(me1j_.valid());
+  Expects(me2jp_.valid());
+}
+
+ScalarOperator ScalarOperatorLoader::LoadWith(
+    const std::shared_ptr<const ScalarModelSpace>& ms_ptr,
+    const ME2JPReadPlan* plan) {
+  Expects(me1j_.valid());
+  Expects(me2jp_.valid());
+
+  // Allocation and first touch overlap with the remaining reads.
+  auto op = ScalarOperator::FromScalarModelSpace(ms_ptr, herm_);
+
+  {
+    const auto me1j = me1j_.get();
+    op.SetZeroBodyPart(me1j.Get0BPart());
+    imsrg::ReadOperatorFromME1J(me1j, op.MutableOneBodyPart());
+  }
+
+  {
+    const auto me2jp = me2jp_.get();
+    if (plan == nullptr) {
+      imsrg::ReadOperatorFromME2JP(me2jp, op.MutableTwoBodyPart());
+    } else {
+      imsrg::ReadOperatorFromME2JP(me2jp, *plan, op.MutableTwoBodyPart());
+    }
+  }
+
+  return op;
+}
+
+namespace detail {
+ME1JFile ReadME1JFile(const std::string& path_to_file, MEXJFileFormat format,
+                      HOEnergy emax, Hermiticity herm) {
+  switch (format) {
+    case MEXJFileFormat::kGZipped:
+      return ME1JFile::FromGZippedFile(path_to_file, emax, herm);
+    case MEXJFileFormat::kBinary:
+      return ME1JFile::FromBinary(path_to_file, emax, herm);
+    case MEXJFileFormat::kText:
+    default:
+      return ME1JFile::FromTextFile(path_to_file, emax, herm);
+  }
+}
+
+ME2JPFile ReadME2JPFile(const std::string& path_to_file, MEXJFileFormat format,
+                        HOEnergy emax, Hermiticity herm) {
+  switch (format) {
+    case MEXJFileFormat::kGZipped:
+      return ME2JPFile::FromGZippedFile(path_to_file, emax, herm);
+    case MEXJFileFormat::kBinary:
+      return ME2JPFile::FromBinary(path_to_file, emax, herm);
+    case MEXJFileFormat::kText:
+    default:
+      return ME2JPFile::FromTextFile(path_to_file, emax, herm);
+  }
+}
+}  // namespace detail
+
+}  // namespace imsrg
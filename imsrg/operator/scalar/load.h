@@ -0,0 +1,71 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_OPERATOR_SCALAR_LOAD_H_
+#define IMSRG_OPERATOR_SCALAR_LOAD_H_
+
+#include <future>
+#include <memory>
+#include <string>
+
+#include "imsrg/files/formats/me1j.h"
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/model_space/scalar/model_space.h"
+#include "imsrg/operator/scalar/operator.h"
+#include "imsrg/operator/scalar/two_body/read.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+namespace imsrg {
+
+enum class MEXJFileFormat { kText, kGZipped, kBinary };
+
+// Loads a ScalarOperator from ME1J and ME2JP files, which are read and parsed
+// on background threads from construction on. Model-space setup (and, e.g.,
+// building an ME2JPReadPlan or the WignerSymbolEngine) in the meantime
+// overlaps with reading, so startup takes about as long as the slowest stage
+// instead of the sum of all stages:
+//
+//   auto loader = ScalarOperatorLoader::FromME1JAndME2JPFiles(...);
+//   const auto ms = ScalarModelSpace::FromSPModelSpace(...);
+//   const auto plan = ME2JPReadPlan::FromModelSpaceAndEMax(
+//       ms->TwoBodyModelSpacePtr(), emax);
+//   auto op = loader.Load(ms, plan);
+//
+// Text files are parsed in parallel, so reading competes with parallel setup
+// for cores.
+class ScalarOperatorLoader {
+ public:
+  static ScalarOperatorLoader FromME1JAndME2JPFiles(std::string path_to_me1j,
+                                                    std::string path_to_me2jp,
+                                                    MEXJFileFormat format,
+                                                    HOEnergy emax,
+                                                    Hermiticity herm);
+
+  // Move only. The dtor waits for reads that were not joined by Load.
+
+  bool IsReady() const;
+
+  // Allocates the operator and waits for each file only right before
+  // filling its part (the zero-body part is taken from the ME1J file).
+  // Rethrows errors from reading. Can be called once.
+  ScalarOperator Load(const std::shared_ptr<const ScalarModelSpace>& ms_ptr);
+
+  // Same, with locations from plan (see ReadOperatorFromME2JP).
+  ScalarOperator Load(const std::shared_ptr<const ScalarModelSpace>& ms_ptr,
+                      const ME2JPReadPlan& plan);
+
+ private:
+  Hermiticity herm_;
+  std::future<ME1JFile> me1j_;
+  std::future<ME2JPFile> me2jp_;
+
+  explicit ScalarOperatorLoader(Hermiticity herm, std::future<ME1JFile>&& me1j,
+                                std::future<ME2JPFile>&& me2jp);
+
+  ScalarOperator LoadWith(
+      const std::shared_ptr<const ScalarModelSpace>& ms_ptr,
+      const ME2JPReadPlan* plan);
+};
+
+}  // namespace imsrg
+
+#endif  // IMSRG_OPERATOR_SCALAR_LOAD_H_
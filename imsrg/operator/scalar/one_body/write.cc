@@ -0,0 +1,49 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/one_body/write.h"
+
+#include <utility>
+#include <vector>
+
+#include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/files/formats/me1j.h"
+#include "imsrg/operator/scalar/one_body/operator.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+namespace imsrg {
+
+ME1JFile WriteOperatorToME1J(const Scalar1BOperator& op, HOEnergy emax,
+                             double me_0b) {
+  using imsrg::mexj::NLJJT;
+
+  // The file stores q <= p, row by row.
+  const std::size_t num_states = imsrg::mexj::GetNLJJTs(emax).size();
+  std::vector<double> mes(num_states * (num_states + 1) / 2, 0.0);
+
+  const auto& ms = op.GetModelSpace();
+
+  for (std::size_t index = 0; index < ms.NumberOfChannels(); index += 1) {
+    const auto& tensor = op.GetTensorAtIndex(index);
+    const auto& channel = ms.ChannelAtIndex(index);
+
+    const auto& basis_bra = channel.BraChannel().ChannelBasis();
+    const auto& basis_ket = channel.KetChannel().ChannelBasis();
+
+    for (std::size_t p_i = 0; p_i < basis_bra.size(); p_i += 1) {
+      const auto i_p = NLJJT(basis_bra.at(p_i)).Index().AsSizeT();
+      if (i_p >= num_states) {
+        continue;
+      }
+      for (std::size_t q_i = 0; q_i < basis_ket.size(); q_i += 1) {
+        const auto i_q = NLJJT(basis_ket.at(q_i)).Index().AsSizeT();
+        if (i_q > i_p) {
+          continue;
+        }
+        mes[i_p * (i_p + 1) / 2 + i_q] = tensor(p_i, q_i);
+      }
+    }
+  }
+
+  return ME1JFile::FromMatrixElements(me_0b, std::move(mes), emax, op.Herm());
+}
+
+}  // namespace imsrg
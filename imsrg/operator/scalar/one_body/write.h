@@ -0,0 +1,18 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_OPERATOR_SCALAR_ONE_BODY_WRITE_H_
+#define IMSRG_OPERATOR_SCALAR_ONE_BODY_WRITE_H_
+
+#include "imsrg/files/formats/me1j.h"
+#include "imsrg/operator/scalar/one_body/operator.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+namespace imsrg {
+
+// Matrix elements of op in ME1J file order for emax, with zero-body part
+// me_0b. Elements outside the model space of op are 0, elements of op above
+// emax are dropped.
+ME1JFile WriteOperatorToME1J(const Scalar1BOperator& op, HOEnergy emax,
+                             double me_0b);
+}  // namespace imsrg
+
+#endif  // IMSRG_OPERATOR_SCALAR_ONE_BODY_WRITE_H_
@@ -0,0 +1,455 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/operator.h"
+
+#include <cmath>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "ntcl/data/f_array.h"
+
+#include "imsrg/assert.h"
+#include "imsrg/error.h"
+#include "imsrg/model_space/scalar/model_space.h"
+#include "imsrg/openmp_runtime.h"
+#include "imsrg/operator/scalar/one_body/operator.h"
+#include "imsrg/operator/scalar/two_body/operator.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+
+namespace imsrg {
+
+namespace detail {
+
+// Runs f_1b on every 1B channel index and f_2b on every 2B channel index
+// inside one parallel region.
+template <typename F1, typename F2>
+static void ForEachChannelFused(std::size_t num_chans_1b,
+                                std::size_t num_chans_2b, F1&& f_1b,
+                                F2&& f_2b);
+
+static void SetTensorToZero(ntcl::FArray<double, 2>& tensor);
+static void SetTensorToZero(ntcl::FArray<double, 4>& tensor);
+
+static void ScaleTensor(double alpha, ntcl::FArray<double, 2>& tensor);
+static void ScaleTensor(double alpha, const ntcl::FArray<double, 4>& x,
+                        ntcl::FArray<double, 4>& y);
+
+static void AxpyTensor(double alpha, const ntcl::FArray<double, 2>& x,
+                       ntcl::FArray<double, 2>& y);
+static void AxpyTensor(double alpha, const ntcl::FArray<double, 4>& x,
+                       ntcl::FArray<double, 4>& y);
+
+static void CopyTensorValues(const ntcl::FArray<double, 2>& x,
+                             ntcl::FArray<double, 2>& y);
+static void CopyTensorValues(const ntcl::FArray<double, 4>& x,
+                             ntcl::FArray<double, 4>& y);
+
+static double SumOfSquares(const ntcl::FArray<double, 2>& tensor);
+static double SumOfSquares(const ntcl::FArray<double, 4>& tensor);
+
+static void WriteTensor(const ntcl::FArray<double, 2>& tensor,
+                        std::vector<double>& buffer, std::ostream& stream);
+static void WriteTensor(const ntcl::FArray<double, 4>& tensor,
+                        std::vector<double>& buffer, std::ostream& stream);
+
+static void ReadTensor(std::istream& stream, std::vector<double>& buffer,
+                       ntcl::FArray<double, 2>& tensor);
+static void ReadTensor(std::istream& stream, std::vector<double>& buffer,
+                       ntcl::FArray<double, 4>& tensor);
+
+// 0 for Hermitian, 1 for anti-Hermitian
+static std::uint64_t HermiticityCode(Hermiticity herm);
+
+constexpr std::uint64_t kScalarOperatorStreamMagic = 0x31504F5253474D49;
+}  // namespace detail
+
+ScalarOperator ScalarOperator::FromScalarModelSpace(
+    const std::shared_ptr<const ScalarModelSpace>& ms_ptr, Hermiticity herm) {
+  return ScalarOperator(ms_ptr, herm, 0.0,
+                        Scalar1BOperator::FromScalar1BModelSpace(
+                            ms_ptr->OneBodyModelSpacePtr(), herm),
+                        Scalar2BOperator::FromScalar2BModelSpace(
+                            ms_ptr->TwoBodyModelSpacePtr(), herm));
+}
+
+ScalarOperator::ScalarOperator(
+    const std::shared_ptr<const ScalarModelSpace>& ms_ptr, Hermiticity herm,
+    double zero_body, Scalar1BOperator&& one_body, Scalar2BOperator&& two_body)
+    : ms_ptr_(ms_ptr),
+      herm_(herm),
+      zero_body_(zero_body),
+      one_body_(std::move(one_body)),
+      two_body_(std::move(two_body)) {
+  Expects(one_body_.GetModelSpacePtr() == ms_ptr_->OneBodyModelSpacePtr());
+  Expects(two_body_.GetModelSpacePtr() == ms_ptr_->TwoBodyModelSpacePtr());
+  Expects(one_body_.Herm() == herm_);
+  Expects(two_body_.Herm() == herm_);
+}
+
+void ScalarOperator::SetZero() {
+  zero_body_ = 0.0;
+  imsrg::detail::ForEachChannelFused(
+      one_body_.size(), two_body_.size(),
+      [this](std::size_t i) {
+        imsrg::detail::SetTensorToZero(one_body_.GetMutableTensorAtIndex(i));
+      },
+      [this](std::size_t i) {
+        two_body_.UpdateTensorAtIndex(
+            i, [](const auto&, auto& new_tensor) {
+              imsrg::detail::SetTensorToZero(new_tensor);
+            });
+      });
+}
+
+void ScalarOperator::Scale(double alpha) {
+  zero_body_ *= alpha;
+  imsrg::detail::ForEachChannelFused(
+      one_body_.size(), two_body_.size(),
+      [this, alpha](std::size_t i) {
+        imsrg::detail::ScaleTensor(alpha, one_body_.GetMutableTensorAtIndex(i));
+      },
+      [this, alpha](std::size_t i) {
+        two_body_.UpdateTensorAtIndex(
+            i, [alpha](const auto& tensor, auto& new_tensor) {
+              imsrg::detail::ScaleTensor(alpha, tensor, new_tensor);
+            });
+      });
+}
+
+void ScalarOperator::Axpy(double alpha, const ScalarOperator& x) {
+  Expects(x.GetModelSpacePtr() == GetModelSpacePtr());
+  Expects(x.Herm() == Herm());
+
+  zero_body_ += alpha * x.zero_body_;
+  imsrg::detail::ForEachChannelFused(
+      one_body_.size(), two_body_.size(),
+      [this, alpha, &x](std::size_t i) {
+        imsrg::detail::AxpyTensor(alpha, x.one_body_.GetTensorAtIndex(i),
+                                  one_body_.GetMutableTensorAtIndex(i));
+      },
+      [this, alpha, &x](std::size_t i) {
+        auto tensor = two_body_.GetMutableTensorAtIndex(i);
+        imsrg::detail::AxpyTensor(alpha, x.two_body_.GetTensorAtIndex(i),
+                                  tensor);
+      });
+}
+
+void ScalarOperator::CopyValuesFrom(const ScalarOperator& other) {
+  Expects(other.GetModelSpacePtr() == GetModelSpacePtr());
+  Expects(other.Herm() == Herm());
+
+  zero_body_ = other.zero_body_;
+  imsrg::detail::ForEachChannelFused(
+      one_body_.size(), two_body_.size(),
+      [this, &other](std::size_t i) {
+        imsrg::detail::CopyTensorValues(other.one_body_.GetTensorAtIndex(i),
+                                        one_body_.GetMutableTensorAtIndex(i));
+      },
+      [this, &other](std::size_t i) {
+        two_body_.UpdateTensorAtIndex(
+            i, [&other, i](const auto&, auto& new_tensor) {
+              imsrg::detail::CopyTensorValues(
+                  other.two_body_.GetTensorAtIndex(i), new_tensor);
+            });
+      });
+}
+
+double ScalarOperator::Norm() const {
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const auto num_chans_1b = one_body_.size();
+  const auto num_chans_2b = two_body_.size();
+
+  double sum = 0.0;
+#pragma omp parallel reduction(+ : sum)
+  {
+#pragma omp for schedule(static) nowait
+    for (std::size_t i = 0; i < num_chans_1b; i += 1) {
+      sum += imsrg::detail::SumOfSquares(one_body_.GetTensorAtIndex(i));
+    }
+#pragma omp for schedule(static) nowait
+    for (std::size_t i = 0; i < num_chans_2b; i += 1) {
+      sum += imsrg::detail::SumOfSquares(two_body_.GetTensorAtIndex(i));
+    }
+  }
+
+  return std::sqrt(zero_body_ * zero_body_ + sum);
+}
+
+void ScalarOperator::WriteToStream(std::ostream& stream) const {
+  // Hermiticity is stored as 0 (Hermitian) or 1 (anti-Hermitian).
+  const std::uint64_t header[4] = {imsrg::detail::kScalarOperatorStreamMagic,
+                                   imsrg::detail::HermiticityCode(herm_),
+                                   one_body_.size(), two_body_.size()};
+  stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+  stream.write(reinterpret_cast<const char*>(&zero_body_), sizeof(double));
+
+  std::vector<double> buffer;
+  for (std::size_t i = 0; i < one_body_.size(); i += 1) {
+    imsrg::detail::WriteTensor(one_body_.GetTensorAtIndex(i), buffer, stream);
+  }
+  for (std::size_t i = 0; i < two_body_.size(); i += 1) {
+    imsrg::detail::WriteTensor(two_body_.GetTensorAtIndex(i), buffer, stream);
+  }
+  imsrg::CheckForError(!stream.good(), "Failed to write ScalarOperator.");
+}
+
+void ScalarOperator::ReadFromStream(std::istream& stream) {
+  std::uint64_t header[4] = {0, 0, 0, 0};
+  stream.read(reinterpret_cast<char*>(header), sizeof(header));
+  imsrg::CheckForError(!stream.good(), "Failed to read ScalarOperator header.");
+  imsrg::CheckForError(
+      header[0] != imsrg::detail::kScalarOperatorStreamMagic,
+      "Stream does not contain a ScalarOperator.");
+  imsrg::CheckForError(
+      header[1] != imsrg::detail::HermiticityCode(herm_),
+      "ScalarOperator in stream has different hermiticity.");
+  imsrg::CheckForError(
+      header[2] != one_body_.size() || header[3] != two_body_.size(),
+      "ScalarOperator in stream has a different model space.");
+
+  stream.read(reinterpret_cast<char*>(&zero_body_), sizeof(double));
+
+  std::vector<double> buffer;
+  for (std::size_t i = 0; i < one_body_.size(); i += 1) {
+    imsrg::detail::ReadTensor(stream, buffer,
+                              one_body_.GetMutableTensorAtIndex(i));
+  }
+  for (std::size_t i = 0; i < two_body_.size(); i += 1) {
+    two_body_.UpdateTensorAtIndex(
+        i, [&stream, &buffer](const auto&, auto& new_tensor) {
+          imsrg::detail::ReadTensor(stream, buffer, new_tensor);
+        });
+  }
+  imsrg::CheckForError(!stream.good(), "Failed to read ScalarOperator.");
+}
+
+namespace detail {
+
+template <typename F1, typename F2>
+void ForEachChannelFused(std::size_t num_chans_1b, std::size_t num_chans_2b,
+                         F1&& f_1b, F2&& f_2b) {
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+#pragma omp parallel
+  {
+#pragma omp for schedule(static) nowait
+    for (std::size_t i = 0; i < num_chans_1b; i += 1) {
+      f_1b(i);
+    }
+#pragma omp for schedule(static)
+    for (std::size_t i = 0; i < num_chans_2b; i += 1) {
+      f_2b(i);
+    }
+  }
+}
+
+void SetTensorToZero(ntcl::FArray<double, 2>& tensor) {
+  for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+    for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+      tensor(p, q) = 0.0;
+    }
+  }
+}
+
+void SetTensorToZero(ntcl::FArray<double, 4>& tensor) {
+  const auto dim_p = tensor.dim_size(0);
+  const auto dim_q = tensor.dim_size(1);
+  const auto dim_r = tensor.dim_size(2);
+  const auto dim_s = tensor.dim_size(3);
+  for (std::size_t s = 0; s < dim_s; s += 1) {
+    for (std::size_t r = 0; r < dim_r; r += 1) {
+      for (std::size_t q = 0; q < dim_q; q += 1) {
+        for (std::size_t p = 0; p < dim_p; p += 1) {
+          tensor(p, q, r, s) = 0.0;
+        }
+      }
+    }
+  }
+}
+
+void ScaleTensor(double alpha, ntcl::FArray<double, 2>& tensor) {
+  for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+    for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+      tensor(p, q) *= alpha;
+    }
+  }
+}
+
+void ScaleTensor(double alpha, const ntcl::FArray<double, 4>& x,
+                 ntcl::FArray<double, 4>& y) {
+  const auto dim_p = y.dim_size(0);
+  const auto dim_q = y.dim_size(1);
+  const auto dim_r = y.dim_size(2);
+  const auto dim_s = y.dim_size(3);
+  for (std::size_t s = 0; s < dim_s; s += 1) {
+    for (std::size_t r = 0; r < dim_r; r += 1) {
+      for (std::size_t q = 0; q < dim_q; q += 1) {
+        for (std::size_t p = 0; p < dim_p; p += 1) {
+          y(p, q, r, s) = alpha * x(p, q, r, s);
+        }
+      }
+    }
+  }
+}
+
+void AxpyTensor(double alpha, const ntcl::FArray<double, 2>& x,
+                ntcl::FArray<double, 2>& y) {
+  for (std::size_t q = 0; q < y.dim_size(1); q += 1) {
+    for (std::size_t p = 0; p < y.dim_size(0); p += 1) {
+      y(p, q) += alpha * x(p, q);
+    }
+  }
+}
+
+void AxpyTensor(double alpha, const ntcl::FArray<double, 4>& x,
+                ntcl::FArray<double, 4>& y) {
+  const auto dim_p = y.dim_size(0);
+  const auto dim_q = y.dim_size(1);
+  const auto dim_r = y.dim_size(2);
+  const auto dim_s = y.dim_size(3);
+  for (std::size_t s = 0; s < dim_s; s += 1) {
+    for (std::size_t r = 0; r < dim_r; r += 1) {
+      for (std::size_t q = 0; q < dim_q; q += 1) {
+        for (std::size_t p = 0; p < dim_p; p += 1) {
+          y(p, q, r, s) += alpha * x(p, q, r, s);
+        }
+      }
+    }
+  }
+}
+
+void CopyTensorValues(const ntcl::FArray<double, 2>& x,
+                      ntcl::FArray<double, 2>& y) {
+  for (std::size_t q = 0; q < y.dim_size(1); q += 1) {
+    for (std::size_t p = 0; p < y.dim_size(0); p += 1) {
+      y(p, q) = x(p, q);
+    }
+  }
+}
+
+void CopyTensorValues(const ntcl::FArray<double, 4>& x,
+                      ntcl::FArray<double, 4>& y) {
+  const auto dim_p = y.dim_size(0);
+  const auto dim_q = y.dim_size(1);
+  const auto dim_r = y.dim_size(2);
+  const auto dim_s = y.dim_size(3);
+  for (std::size_t s = 0; s < dim_s; s += 1) {
+    for (std::size_t r = 0; r < dim_r; r += 1) {
+      for (std::size_t q = 0; q < dim_q; q += 1) {
+        for (std::size_t p = 0; p < dim_p; p += 1) {
+          y(p, q, r, s) = x(p, q, r, s);
+        }
+      }
+    }
+  }
+}
+
+double SumOfSquares(const ntcl::FArray<double, 2>& tensor) {
+  double sum = 0.0;
+  for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+    for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+      sum += tensor(p, q) * tensor(p, q);
+    }
+  }
+  return sum;
+}
+
+double SumOfSquares(const ntcl::FArray<double, 4>& tensor) {
+  const auto dim_p = tensor.dim_size(0);
+  const auto dim_q = tensor.dim_size(1);
+  const auto dim_r = tensor.dim_size(2);
+  const auto dim_s = tensor.dim_size(3);
+  double sum = 0.0;
+  for (std::size_t s = 0; s < dim_s; s += 1) {
+    for (std::size_t r = 0; r < dim_r; r += 1) {
+      for (std::size_t q = 0; q < dim_q; q += 1) {
+        for (std::size_t p = 0; p < dim_p; p += 1) {
+          sum += tensor(p, q, r, s) * tensor(p, q, r, s);
+        }
+      }
+    }
+  }
+  return sum;
+}
+
+void WriteTensor(const ntcl::FArray<double, 2>& tensor,
+                 std::vector<double>& buffer, std::ostream& stream) {
+  buffer.clear();
+  for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+    for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+      buffer.push_back(tensor(p, q));
+    }
+  }
+  stream.write(reinterpret_cast<const char*>(buffer.data()),
+               buffer.size() * sizeof(double));
+}
+
+void WriteTensor(const ntcl::FArray<double, 4>& tensor,
+                 std::vector<double>& buffer, std::ostream& stream) {
+  const auto dim_p = tensor.dim_size(0);
+  const auto dim_q = tensor.dim_size(1);
+  const auto dim_r = tensor.dim_size(2);
+  const auto dim_s = tensor.dim_size(3);
+  buffer.clear();
+  for (std::size_t s = 0; s < dim_s; s += 1) {
+    for (std::size_t r = 0; r < dim_r; r += 1) {
+      for (std::size_t q = 0; q < dim_q; q += 1) {
+        for (std::size_t p = 0; p < dim_p; p += 1) {
+          buffer.push_back(tensor(p, q, r, s));
+        }
+      }
+    }
+  }
+  stream.write(reinterpret_cast<const char*>(buffer.data()),
+               buffer.size() * sizeof(double));
+}
+
+void ReadTensor(std::istream& stream, std::vector<double>& buffer,
+                ntcl::FArray<double, 2>& tensor) {
+  buffer.resize(tensor.dim_size(0) * tensor.dim_size(1));
+  stream.read(reinterpret_cast<char*>(buffer.data()),
+              buffer.size() * sizeof(double));
+  std::size_t index = 0;
+  for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+    for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+      tensor(p, q) = buffer[index];
+      index += 1;
+    }
+  }
+}
+
+void ReadTensor(std::istream& stream, std::vector<double>& buffer,
+                ntcl::FArray<double, 4>& tensor) {
+  const auto dim_p = tensor.dim_size(0);
+  const auto dim_q = tensor.dim_size(1);
+  const auto dim_r = tensor.dim_size(2);
+  const auto dim_s = tensor.dim_size(3);
+  buffer.resize(dim_p * dim_q * dim_r * dim_s);
+  stream.read(reinterpret_cast<char*>(buffer.data()),
+              buffer.size() * sizeof(double));
+  std::size_t index = 0;
+  for (std::size_t s = 0; s < dim_s; s += 1) {
+    for (std::size_t r = 0; r < dim_r; r += 1) {
+      for (std::size_t q = 0; q < dim_q; q += 1) {
+        for (std::size_t p = 0; p < dim_p; p += 1) {
+          tensor(p, q, r, s) = buffer[index];
+          index += 1;
+        }
+      }
+    }
+  }
+}
+
+std::uint64_t HermiticityCode(Hermiticity herm) {
+  return herm.IsHermitian() ? 0 : 1;
+}
+}  // namespace detail
+}  // namespace imsrg
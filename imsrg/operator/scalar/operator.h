@@ -0,0 +1,87 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_OPERATOR_SCALAR_OPERATOR_H_
+#define IMSRG_OPERATOR_SCALAR_OPERATOR_H_
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <utility>
+
+#include "imsrg/model_space/scalar/model_space.h"
+#include "imsrg/operator/scalar/one_body/operator.h"
+#include "imsrg/operator/scalar/two_body/operator.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+
+namespace imsrg {
+
+// Scalar operator with zero-, one-, and two-body parts.
+//
+// The bulk operations (SetZero, Scale, Axpy, CopyValuesFrom, Norm) touch all
+// parts in a single parallel region. Two-body channels are distributed with
+// the same static schedule used for first-touch placement in
+// Scalar2BOperator.
+class ScalarOperator {
+ public:
+  static ScalarOperator FromScalarModelSpace(
+      const std::shared_ptr<const ScalarModelSpace>& ms_ptr, Hermiticity herm);
+
+  // Default copy, move, and dtor
+
+  Hermiticity Herm() const { return herm_; }
+
+  const ScalarModelSpace& GetModelSpace() const { return *ms_ptr_; }
+  std::shared_ptr<const ScalarModelSpace> GetModelSpacePtr() const {
+    return ms_ptr_;
+  }
+
+  double ZeroBodyPart() const { return zero_body_; }
+  void SetZeroBodyPart(double val) { zero_body_ = val; }
+
+  const Scalar1BOperator& OneBodyPart() const { return one_body_; }
+  Scalar1BOperator& MutableOneBodyPart() { return one_body_; }
+
+  const Scalar2BOperator& TwoBodyPart() const { return two_body_; }
+  Scalar2BOperator& MutableTwoBodyPart() { return two_body_; }
+
+  void SetZero();
+  void Scale(double alpha);
+  // this += alpha * x
+  void Axpy(double alpha, const ScalarOperator& x);
+  // Copies the matrix elements of other into this operator without
+  // reallocating any tensors.
+  void CopyValuesFrom(const ScalarOperator& other);
+  // Frobenius norm of all stored matrix elements and the zero-body part.
+  double Norm() const;
+
+  // Raw binary dump of all parts (native byte order, channel by channel).
+  void WriteToStream(std::ostream& stream) const;
+  // Reads a dump written by WriteToStream for the same model space.
+  void ReadFromStream(std::istream& stream);
+
+  void swap(ScalarOperator& other) noexcept {
+    using std::swap;
+    swap(ms_ptr_, other.ms_ptr_);
+    swap(herm_, other.herm_);
+    swap(zero_body_, other.zero_body_);
+    swap(one_body_, other.one_body_);
+    swap(two_body_, other.two_body_);
+  }
+
+ private:
+  std::shared_ptr<const ScalarModelSpace> ms_ptr_;
+  Hermiticity herm_;
+  double zero_body_;
+  Scalar1BOperator one_body_;
+  Scalar2BOperator two_body_;
+
+  explicit ScalarOperator(const std::shared_ptr<const ScalarModelSpace>& ms_ptr,
+                          Hermiticity herm, double zero_body,
+                          Scalar1BOperator&& one_body,
+                          Scalar2BOperator&& two_body);
+};
+
+inline void swap(ScalarOperator& a, ScalarOperator& b) noexcept { a.swap(b); }
+
+}  // namespace imsrg
+
+#endif  // IMSRG_OPERATOR_SCALAR_OPERATOR_H_
@@ -17,16 +17,6 @@ void AntisymmetrizeOperatorInChannel(Scalar2BOperator& op,
   }
 
   const auto& ms_2b = op.GetModelSpace();
-  const auto& sp_ms = ms_2b.SingleParticleModelSpace();
-
-  const auto dim_p = sp_ms.ChannelDim(chankey.BraChannelKey().p_chan_key);
-  const auto dim_q = sp_ms.ChannelDim(chankey.BraChannelKey().q_chan_key);
-  const auto dim_r = sp_ms.ChannelDim(chankey.KetChannelKey().p_chan_key);
-  const auto dim_s = sp_ms.ChannelDim(chankey.KetChannelKey().q_chan_key);
-
-  // spdlog::info("dims = {} {} {} {}", dim_p, dim_q, dim_r, dim_s);
-
-  ntcl::FArray<double, 4> temp_pqrs(dim_p, dim_q, dim_r, dim_s);
 
   const auto [chankey_qprs, chankey_pqsr, chankey_qpsr] =
       GeneratePermutedChannels(chankey);
@@ -34,14 +24,26 @@ void AntisymmetrizeOperatorInChannel(Scalar2BOperator& op,
       GeneratePermutationFactors(chankey);
 
   const auto index_pqrs = ms_2b.IndexOfChannelInModelSpace(chankey);
+
+  // Channel dims (possibly e2max truncated). Swapping p and q (r and s)
+  // swaps the dims, so they agree across the permuted channels.
+  const auto& chan_pqrs = ms_2b.ChannelAtIndex(index_pqrs);
+  const auto dim_p = chan_pqrs.BraDim1();
+  const auto dim_q = chan_pqrs.BraDim2();
+  const auto dim_r = chan_pqrs.KetDim1();
+  const auto dim_s = chan_pqrs.KetDim2();
+
+  // spdlog::info("dims = {} {} {} {}", dim_p, dim_q, dim_r, dim_s);
+
+  ntcl::FArray<double, 4> temp_pqrs(dim_p, dim_q, dim_r, dim_s);
   const auto index_qprs = ms_2b.IndexOfChannelInModelSpace(chankey_qprs);
   const auto index_pqsr = ms_2b.IndexOfChannelInModelSpace(chankey_pqsr);
   const auto index_qpsr = ms_2b.IndexOfChannelInModelSpace(chankey_qpsr);
 
-  auto& tensor_pqrs = op.GetMutableTensorAtIndex(index_pqrs);
-  auto& tensor_qprs = op.GetMutableTensorAtIndex(index_qprs);
-  auto& tensor_pqsr = op.GetMutableTensorAtIndex(index_pqsr);
-  auto& tensor_qpsr = op.GetMutableTensorAtIndex(index_qpsr);
+  auto tensor_pqrs = op.GetMutableTensorAtIndex(index_pqrs);
+  auto tensor_qprs = op.GetMutableTensorAtIndex(index_qprs);
+  auto tensor_pqsr = op.GetMutableTensorAtIndex(index_pqsr);
+  auto tensor_qpsr = op.GetMutableTensorAtIndex(index_qpsr);
 
   // spdlog::info("dims(pqrs) = {} {} {} {}", tensor_pqrs.dim_size(0),
   //              tensor_pqrs.dim_size(1), tensor_pqrs.dim_size(2),
@@ -82,5 +84,11 @@ void AntisymmetrizeOperatorInChannel(Scalar2BOperator& op,
       }
     }
   }
+
+  // Out-of-core operators are antisymmetrized one channel at a time.
+  op.EvictTensorAtIndex(index_pqrs);
+  op.EvictTensorAtIndex(index_qprs);
+  op.EvictTensorAtIndex(index_pqsr);
+  op.EvictTensorAtIndex(index_qpsr);
 }
 }  // namespace imsrg
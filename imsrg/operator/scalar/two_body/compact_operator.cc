@@ -0,0 +1,90 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/two_body/compact_operator.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ntcl/data/f_array.h"
+
+#include "imsrg/assert.h"
+#include "imsrg/model_space/scalar/two_body/channel_layout.h"
+#include "imsrg/model_space/scalar/two_body/model_space.h"
+#include "imsrg/openmp_runtime.h"
+#include "imsrg/operator/scalar/two_body/operator.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+
+namespace imsrg {
+
+template <typename T>
+Scalar2BCompactOperator<T> Scalar2BCompactOperator<T>::FromScalar2BOperator(
+    const Scalar2BOperator& op) {
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const auto& ms_ptr = op.GetModelSpacePtr();
+  const auto& layout = ms_ptr->ChannelLayout();
+  std::vector<T> data(layout.TotalSize());
+
+#pragma omp parallel for schedule(static)
+  for (std::size_t index = 0; index < op.size(); index += 1) {
+    const auto& tensor = op.GetTensorAtIndex(index);
+    const Scalar2BCompactTensor<T> compact_tensor(
+        data.data() + layout.Offset(index), layout.ChannelDims(index));
+    const auto dim_p = tensor.dim_size(0);
+    const auto dim_q = tensor.dim_size(1);
+    const auto dim_r = tensor.dim_size(2);
+    const auto dim_s = tensor.dim_size(3);
+    for (std::size_t s = 0; s < dim_s; s += 1) {
+      for (std::size_t r = 0; r < dim_r; r += 1) {
+        for (std::size_t q = 0; q < dim_q; q += 1) {
+          for (std::size_t p = 0; p < dim_p; p += 1) {
+            compact_tensor.Set(p, q, r, s, tensor(p, q, r, s));
+          }
+        }
+      }
+    }
+  }
+
+  return Scalar2BCompactOperator<T>(ms_ptr, op.Herm(), std::move(data));
+}
+
+template <typename T>
+Scalar2BCompactOperator<T>::Scalar2BCompactOperator(
+    const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr, Hermiticity herm,
+    std::vector<T>&& data)
+    : ms_ptr_(ms_ptr), herm_(herm), data_(std::move(data)) {
+  Expects(ms_ptr_->ChannelLayout().TotalSize() == data_.size());
+}
+
+template <typename T>
+Scalar2BOperator Scalar2BCompactOperator<T>::ToScalar2BOperator() const {
+  auto op = Scalar2BOperator::FromScalar2BModelSpace(ms_ptr_, herm_);
+
+#pragma omp parallel for schedule(static)
+  for (std::size_t index = 0; index < size(); index += 1) {
+    const auto compact_tensor = GetTensorAtIndex(index);
+    auto tensor = op.GetMutableTensorAtIndex(index);
+    const auto dim_p = compact_tensor.dim_size(0);
+    const auto dim_q = compact_tensor.dim_size(1);
+    const auto dim_r = compact_tensor.dim_size(2);
+    const auto dim_s = compact_tensor.dim_size(3);
+    for (std::size_t s = 0; s < dim_s; s += 1) {
+      for (std::size_t r = 0; r < dim_r; r += 1) {
+        for (std::size_t q = 0; q < dim_q; q += 1) {
+          for (std::size_t p = 0; p < dim_p; p += 1) {
+            tensor(p, q, r, s) = compact_tensor(p, q, r, s);
+          }
+        }
+      }
+    }
+  }
+
+  return op;
+}
+
+template class Scalar2BCompactOperator<float>;
+template class Scalar2BCompactOperator<BFloat16>;
+
+}  // namespace imsrg
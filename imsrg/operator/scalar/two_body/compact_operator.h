@@ -0,0 +1,165 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_OPERATOR_SCALAR_TWO_BODY_COMPACT_OPERATOR_H_
+#define IMSRG_OPERATOR_SCALAR_TWO_BODY_COMPACT_OPERATOR_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "imsrg/model_space/scalar/two_body/channel_layout.h"
+#include "imsrg/model_space/scalar/two_body/model_space.h"
+#include "imsrg/operator/scalar/two_body/operator.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+
+namespace imsrg {
+
+// bfloat16: the upper 16 bits of an IEEE single,
+// rounded to nearest even on conversion.
+class BFloat16 {
+ public:
+  BFloat16() = default;
+  explicit BFloat16(float val) : bits_(FloatToBits(val)) {}
+
+  explicit operator float() const {
+    const std::uint32_t bits = static_cast<std::uint32_t>(bits_) << 16;
+    float val;
+    std::memcpy(&val, &bits, sizeof(val));
+    return val;
+  }
+
+  std::uint16_t Bits() const { return bits_; }
+
+ private:
+  std::uint16_t bits_ = 0;
+
+  static std::uint16_t FloatToBits(float val) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &val, sizeof(val));
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+      // Quiet NaN
+      return 0x7FC0;
+    }
+    const std::uint32_t lsb = (bits >> 16) & 1;
+    bits += 0x7FFF + lsb;
+    return static_cast<std::uint16_t>(bits >> 16);
+  }
+};
+
+// View of one channel tensor in reduced precision (column-major, like
+// ntcl::FArray). Elements are converted to double on access. The shape comes
+// from the model space channel layout; the view does not own any memory.
+//
+// T = const U gives a read-only view.
+template <typename T>
+class Scalar2BCompactTensor {
+ public:
+  Scalar2BCompactTensor(T* data, const Scalar2BChannelLayout::Dims& dims)
+      : data_(data), dims_(&dims) {}
+
+  // Default copy, move, and dtor
+
+  std::size_t dim_size(std::size_t i) const { return (*dims_)[i]; }
+  std::size_t size() const {
+    return (*dims_)[0] * (*dims_)[1] * (*dims_)[2] * (*dims_)[3];
+  }
+
+  double operator()(std::size_t p, std::size_t q, std::size_t r,
+                    std::size_t s) const {
+    return static_cast<double>(
+        static_cast<float>(data_[Index(p, q, r, s)]));
+  }
+
+  void Set(std::size_t p, std::size_t q, std::size_t r, std::size_t s,
+           double val) const {
+    data_[Index(p, q, r, s)] = T(static_cast<float>(val));
+  }
+
+ private:
+  T* data_;
+  const Scalar2BChannelLayout::Dims* dims_;
+
+  std::size_t Index(std::size_t p, std::size_t q, std::size_t r,
+                    std::size_t s) const {
+    const auto& dims = *dims_;
+    return p + dims[0] * (q + dims[1] * (r + dims[2] * s));
+  }
+};
+
+// Two-body operator with channel tensors stored in reduced precision
+// (T = float or BFloat16). This halves (float) or quarters (BFloat16)
+// memory and bandwidth relative to Scalar2BOperator. Kernels on compact
+// operators convert elements to double and accumulate in double.
+//
+// Only the [2, 2] -> 0 commutator has a compact path. It reads every matrix
+// element once and is bandwidth bound. The [2, 2] -> 1 and [2, 2] -> 2
+// kernels reuse each input channel across many output elements and are
+// compute bound, so compact storage would save little there.
+//
+// All matrix elements live in one buffer laid out by the model space's
+// Scalar2BChannelLayout; tensors are views into it.
+template <typename T>
+class Scalar2BCompactOperator {
+ public:
+  // Rounds every matrix element of op to T.
+  static Scalar2BCompactOperator FromScalar2BOperator(
+      const Scalar2BOperator& op);
+
+  // Default copy, move, and dtor
+
+  // Expands back to double precision.
+  Scalar2BOperator ToScalar2BOperator() const;
+
+  Hermiticity Herm() const { return herm_; }
+
+  std::size_t size() const { return ms_ptr_->NumberOfChannels(); }
+
+  std::size_t SizeInBytes() const { return data_.size() * sizeof(T); }
+
+  Scalar2BCompactTensor<const T> GetTensorAtIndex(std::size_t i) const {
+    const auto& layout = ms_ptr_->ChannelLayout();
+    return {data_.data() + layout.Offset(i), layout.ChannelDims(i)};
+  }
+  Scalar2BCompactTensor<T> GetMutableTensorAtIndex(std::size_t i) {
+    const auto& layout = ms_ptr_->ChannelLayout();
+    return {data_.data() + layout.Offset(i), layout.ChannelDims(i)};
+  }
+
+  const Scalar2BModelSpace& GetModelSpace() const { return *ms_ptr_; }
+  std::shared_ptr<const Scalar2BModelSpace> GetModelSpacePtr() const {
+    return ms_ptr_;
+  }
+
+  void swap(Scalar2BCompactOperator& other) noexcept {
+    using std::swap;
+    swap(ms_ptr_, other.ms_ptr_);
+    swap(herm_, other.herm_);
+    swap(data_, other.data_);
+  }
+
+ private:
+  std::shared_ptr<const Scalar2BModelSpace> ms_ptr_;
+  Hermiticity herm_;
+  std::vector<T> data_;
+
+  explicit Scalar2BCompactOperator(
+      const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr, Hermiticity herm,
+      std::vector<T>&& data);
+};
+
+template <typename T>
+inline void swap(Scalar2BCompactOperator<T>& a,
+                 Scalar2BCompactOperator<T>& b) noexcept {
+  a.swap(b);
+}
+
+using Scalar2BFloatOperator = Scalar2BCompactOperator<float>;
+using Scalar2BBFloat16Operator = Scalar2BCompactOperator<BFloat16>;
+
+extern template class Scalar2BCompactOperator<float>;
+extern template class Scalar2BCompactOperator<BFloat16>;
+
+}  // namespace imsrg
+
+#endif  // IMSRG_OPERATOR_SCALAR_TWO_BODY_COMPACT_OPERATOR_H_
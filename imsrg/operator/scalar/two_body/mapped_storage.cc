@@ -0,0 +1,185 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/two_body/mapped_storage.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fmt/core.h"
+
+#include "imsrg/assert.h"
+#include "imsrg/error.h"
+
+namespace imsrg {
+
+namespace detail {
+
+// Unlinks and maps the scratch file open at fd (created at path_to_file),
+// sized for channel_dims. Closes fd on failure.
+static std::shared_ptr<Scalar2BMappedStorage> MapScratchFile(
+    const std::string& path_to_file, int fd,
+    const std::vector<std::array<std::size_t, 4>>& channel_dims);
+
+static std::size_t ChannelSize(const std::array<std::size_t, 4>& dims);
+
+// Smallest page-aligned byte range covering [begin, end).
+static std::pair<std::size_t, std::size_t> OuterPageRange(std::size_t begin,
+                                                          std::size_t end);
+
+// Largest page-aligned byte range inside [begin, end).
+static std::pair<std::size_t, std::size_t> InnerPageRange(std::size_t begin,
+                                                          std::size_t end);
+}  // namespace detail
+
+std::shared_ptr<Scalar2BMappedStorage> Scalar2BMappedStorage::FromChannelDims(
+    const std::string& path_to_file,
+    const std::vector<std::array<std::size_t, 4>>& channel_dims) {
+  const int fd = open(path_to_file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  imsrg::CheckForError(
+      fd < 0, fmt::format("Failed to create scratch file at {}: {}",
+                          path_to_file, std::strerror(errno)));
+
+  return imsrg::detail::MapScratchFile(path_to_file, fd, channel_dims);
+}
+
+std::shared_ptr<Scalar2BMappedStorage> Scalar2BMappedStorage::FromLayoutOf(
+    const Scalar2BMappedStorage& other) {
+  std::string path_to_file = other.path_to_file_ + ".XXXXXX";
+  const int fd = mkstemp(path_to_file.data());
+  imsrg::CheckForError(
+      fd < 0, fmt::format("Failed to create scratch file next to {}: {}",
+                          other.path_to_file_, std::strerror(errno)));
+
+  return imsrg::detail::MapScratchFile(path_to_file, fd, other.channel_dims_);
+}
+
+Scalar2BMappedStorage::Scalar2BMappedStorage(
+    std::string&& path_to_file, int fd, double* data,
+    std::size_t size_in_bytes,
+    std::vector<std::array<std::size_t, 4>>&& channel_dims,
+    std::vector<std::size_t>&& channel_offsets)
+    : path_to_file_(std::move(path_to_file)),
+      fd_(fd),
+      data_(data),
+      size_in_bytes_(size_in_bytes),
+      channel_dims_(std::move(channel_dims)),
+      channel_offsets_(std::move(channel_offsets)) {
+  Expects(channel_dims_.size() == channel_offsets_.size());
+}
+
+Scalar2BMappedStorage::~Scalar2BMappedStorage() {
+  if (data_ != nullptr) {
+    munmap(data_, size_in_bytes_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void Scalar2BMappedStorage::PrefetchChannel(std::size_t i) const {
+  const std::size_t begin = channel_offsets_[i] * sizeof(double);
+  const std::size_t end =
+      begin + imsrg::detail::ChannelSize(channel_dims_[i]) * sizeof(double);
+  const auto [page_begin, page_end] =
+      imsrg::detail::OuterPageRange(begin, end);
+  if (page_end > page_begin) {
+    // Purely advisory, failure is harmless.
+    madvise(reinterpret_cast<char*>(data_) + page_begin, page_end - page_begin,
+            MADV_WILLNEED);
+  }
+}
+
+void Scalar2BMappedStorage::ReleaseChannel(std::size_t i) const {
+  const std::size_t begin = channel_offsets_[i] * sizeof(double);
+  const std::size_t end =
+      begin + imsrg::detail::ChannelSize(channel_dims_[i]) * sizeof(double);
+  // Only whole pages, so neighboring channels are not affected.
+  const auto [page_begin, page_end] =
+      imsrg::detail::InnerPageRange(begin, end);
+  if (page_end > page_begin) {
+    char* addr = reinterpret_cast<char*>(data_) + page_begin;
+    msync(addr, page_end - page_begin, MS_ASYNC);
+    // Pages of a shared file mapping are reread from the page cache or file.
+    madvise(addr, page_end - page_begin, MADV_DONTNEED);
+  }
+}
+
+void Scalar2BMappedStorage::Sync() const {
+  if (data_ != nullptr) {
+    imsrg::CheckForError(msync(data_, size_in_bytes_, MS_SYNC) != 0,
+                         "Failed to sync mapped operator storage");
+  }
+}
+
+namespace detail {
+
+std::shared_ptr<Scalar2BMappedStorage> MapScratchFile(
+    const std::string& path_to_file, int fd,
+    const std::vector<std::array<std::size_t, 4>>& channel_dims) {
+  std::vector<std::size_t> channel_offsets;
+  channel_offsets.reserve(channel_dims.size());
+  std::size_t total_size = 0;
+  for (const auto& dims : channel_dims) {
+    channel_offsets.push_back(total_size);
+    total_size += imsrg::detail::ChannelSize(dims);
+  }
+  const std::size_t size_in_bytes = total_size * sizeof(double);
+
+  // The file lives as long as the descriptor and the mapping.
+  unlink(path_to_file.c_str());
+
+  double* data = nullptr;
+  if (size_in_bytes > 0) {
+    if (ftruncate(fd, static_cast<off_t>(size_in_bytes)) != 0) {
+      close(fd);
+      imsrg::Error(fmt::format("Failed to resize scratch file at {} to {} B",
+                               path_to_file, size_in_bytes));
+    }
+    void* map = mmap(nullptr, size_in_bytes, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+      close(fd);
+      imsrg::Error(fmt::format("Failed to map scratch file at {}: {}",
+                               path_to_file, std::strerror(errno)));
+    }
+    data = static_cast<double*>(map);
+  }
+
+  std::vector<std::array<std::size_t, 4>> dims_copy(channel_dims);
+  return std::make_shared<Scalar2BMappedStorage>(
+      std::string(path_to_file), fd, data, size_in_bytes,
+      std::move(dims_copy), std::move(channel_offsets));
+}
+
+std::size_t ChannelSize(const std::array<std::size_t, 4>& dims) {
+  return dims[0] * dims[1] * dims[2] * dims[3];
+}
+
+std::pair<std::size_t, std::size_t> OuterPageRange(std::size_t begin,
+                                                   std::size_t end) {
+  const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const std::size_t page_begin = (begin / page_size) * page_size;
+  const std::size_t page_end = ((end + page_size - 1) / page_size) * page_size;
+  return {page_begin, page_end};
+}
+
+std::pair<std::size_t, std::size_t> InnerPageRange(std::size_t begin,
+                                                   std::size_t end) {
+  const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const std::size_t page_begin =
+      ((begin + page_size - 1) / page_size) * page_size;
+  const std::size_t page_end = (end / page_size) * page_size;
+  return {page_begin, page_end};
+}
+
+}  // namespace detail
+}  // namespace imsrg
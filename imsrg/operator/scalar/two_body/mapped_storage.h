@@ -0,0 +1,82 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_OPERATOR_SCALAR_TWO_BODY_MAPPED_STORAGE_H_
+#define IMSRG_OPERATOR_SCALAR_TWO_BODY_MAPPED_STORAGE_H_
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace imsrg {
+
+// File-backed buffer for the channel tensors of a Scalar2BOperator.
+//
+// Channel tensors are laid out back to back (column-major, like
+// ntcl::FArray) in a scratch file that is memory-mapped shared, and the
+// operator hands out views into the mapping. The file is
+// unlinked right after creation, so it disappears with the mapping. Clean
+// pages may be dropped by the kernel at any time, which is what keeps the
+// resident set bounded for model spaces that do not fit in memory.
+class Scalar2BMappedStorage {
+ public:
+  // Creates a zero-filled scratch file at path_to_file.
+  static std::shared_ptr<Scalar2BMappedStorage> FromChannelDims(
+      const std::string& path_to_file,
+      const std::vector<std::array<std::size_t, 4>>& channel_dims);
+
+  // Creates a zero-filled scratch file with the channel layout of other,
+  // under a unique name (from mkstemp) next to the scratch file of other.
+  static std::shared_ptr<Scalar2BMappedStorage> FromLayoutOf(
+      const Scalar2BMappedStorage& other);
+
+  // Ctor from an open, mapped file
+  // YOU SHOULD NOT CALL THIS DIRECTLY.
+  explicit Scalar2BMappedStorage(
+      std::string&& path_to_file, int fd, double* data,
+      std::size_t size_in_bytes,
+      std::vector<std::array<std::size_t, 4>>&& channel_dims,
+      std::vector<std::size_t>&& channel_offsets);
+
+  // Not copyable or movable (only pointers)
+  Scalar2BMappedStorage(const Scalar2BMappedStorage&) = delete;
+  Scalar2BMappedStorage& operator=(const Scalar2BMappedStorage&) = delete;
+  Scalar2BMappedStorage(Scalar2BMappedStorage&&) = delete;
+  Scalar2BMappedStorage& operator=(Scalar2BMappedStorage&&) = delete;
+
+  ~Scalar2BMappedStorage();
+
+  std::size_t NumberOfChannels() const { return channel_dims_.size(); }
+  std::size_t SizeInBytes() const { return size_in_bytes_; }
+
+  const std::array<std::size_t, 4>& ChannelDims(std::size_t i) const {
+    return channel_dims_[i];
+  }
+
+  // Start of the mapping. Channel tensors are laid out back to back in
+  // channel order.
+  double* Data() const { return data_; }
+
+  // Asks the kernel to start reading channel i from disk.
+  void PrefetchChannel(std::size_t i) const;
+
+  // Tells the kernel that the pages of channel i are not needed soon.
+  // Data is not lost, it is read back from the file on next access.
+  void ReleaseChannel(std::size_t i) const;
+
+  // Flushes all modified pages to disk.
+  void Sync() const;
+
+ private:
+  // Path the file was created at (it is unlinked)
+  std::string path_to_file_;
+  int fd_;
+  double* data_;
+  std::size_t size_in_bytes_;
+  std::vector<std::array<std::size_t, 4>> channel_dims_;
+  // Offsets in units of doubles
+  std::vector<std::size_t> channel_offsets_;
+};
+
+}  // namespace imsrg
+
+#endif  // IMSRG_OPERATOR_SCALAR_TWO_BODY_MAPPED_STORAGE_H_
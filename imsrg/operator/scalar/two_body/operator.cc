@@ -1,57 +1,244 @@
 // Copyright 2022 Matthias Heinz
 #include "imsrg/operator/scalar/two_body/operator.h"
 
+#include <algorithm>
+#include <array>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "ntcl/data/f_array.h"
 
 #include "imsrg/assert.h"
+#include "imsrg/model_space/scalar/two_body/channel_index_lookup.h"
+#include "imsrg/model_space/scalar/two_body/channel_layout.h"
 #include "imsrg/model_space/scalar/two_body/model_space.h"
 #include "imsrg/model_space/scalar/two_body/pandya_channel_key.h"
-#include "imsrg/quantum_numbers/coupling/factors.h"
-#include "imsrg/quantum_numbers/coupling/wigner_symbols.h"
+#include "imsrg/model_space/scalar/two_body/pandya_channel_table.h"
+#include "imsrg/openmp_runtime.h"
+#include "imsrg/operator/scalar/two_body/mapped_storage.h"
+#include "imsrg/quantum_numbers/coupling/jj.h"
 #include "imsrg/quantum_numbers/hermiticity.h"
 
 namespace imsrg {
 
 namespace detail {
+// destination(p, s, r, q) += factor * input(p, q, r, s) over the states
+// present in both tensors (standard channel tensors may be e2max truncated).
 void AddPandyaContribution(const ntcl::FArray<double, 4>& input,
-                           std::size_t dim_p, std::size_t dim_q,
-                           std::size_t dim_r, std::size_t dim_s, double factor,
+                           double factor,
                            ntcl::FArray<double, 4>& destination);
-}
+
+// Buffer for all channels of layout, not initialized
+static std::shared_ptr<double[]> AllocateBuffer(
+    const Scalar2BChannelLayout& layout);
+
+// Runs f on every channel index with the static schedule of the commutator
+// channel loops and returns the channel indices [begin, end) each thread ran.
+template <typename F>
+static std::vector<std::array<std::size_t, 2>> ForEachChannelStatic(
+    std::size_t num_chans, F&& f);
+}  // namespace detail
 
 Scalar2BOperator Scalar2BOperator::FromScalar2BModelSpace(
     const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr, Hermiticity herm) {
-  std::vector<ntcl::FArray<double, 4>> tensors;
-  tensors.reserve(ms_ptr->NumberOfChannels());
+  const auto& layout = ms_ptr->ChannelLayout();
+  auto data = imsrg::detail::AllocateBuffer(layout);
 
-  for (std::size_t index = 0; index < ms_ptr->size(); index++) {
-    const auto& chan = ms_ptr->ChannelAtIndex(index);
-    const auto dim_i = chan.BraChannel1().size();
-    const auto dim_j = chan.BraChannel2().size();
-    const auto dim_k = chan.KetChannel1().size();
-    const auto dim_l = chan.KetChannel2().size();
+  // Same schedule as the channel loops in the commutators,
+  // so each thread zeroes (and thereby places) the pages it will work on.
+  auto first_touch_chans = imsrg::detail::ForEachChannelStatic(
+      layout.NumberOfChannels(), [&layout, &data](std::size_t index) {
+        std::fill_n(data.get() + layout.Offset(index),
+                    layout.ChannelSize(index), 0.0);
+      });
 
-    tensors.emplace_back(dim_i, dim_j, dim_k, dim_l);
-  }
+  return Scalar2BOperator(ms_ptr, herm, std::move(data),
+                          std::move(first_touch_chans));
+}
 
-  Ensures(ms_ptr->NumberOfChannels() == tensors.size());
+Scalar2BOperator Scalar2BOperator::FromScalar2BModelSpaceOutOfCore(
+    const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr, Hermiticity herm,
+    const std::string& path_to_scratch_file) {
+  auto storage = Scalar2BMappedStorage::FromChannelDims(
+      path_to_scratch_file, ms_ptr->ChannelLayout().AllChannelDims());
+  // The buffer keeps the mapping alive.
+  std::shared_ptr<double[]> data(storage, storage->Data());
 
-  return Scalar2BOperator(ms_ptr, herm, std::move(tensors));
+  return Scalar2BOperator(ms_ptr, herm, std::move(data), {},
+                          std::move(storage));
 }
 
 Scalar2BOperator::Scalar2BOperator(
     const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr, Hermiticity herm,
-    std::vector<ntcl::FArray<double, 4>>&& tensors)
-    : ms_ptr_(ms_ptr), herm_(herm), tensors_(std::move(tensors)) {
-  Expects(ms_ptr_->NumberOfChannels() == tensors_.size());
+    std::shared_ptr<double[]>&& data,
+    std::vector<std::array<std::size_t, 2>>&& first_touch_chans,
+    std::shared_ptr<Scalar2BMappedStorage>&& storage)
+    : ms_ptr_(ms_ptr),
+      herm_(herm),
+      data_(std::move(data)),
+      storage_(std::move(storage)),
+      first_touch_chans_(std::move(first_touch_chans)) {
+  if (storage_ != nullptr) {
+    Expects(storage_->NumberOfChannels() == ms_ptr_->NumberOfChannels());
+  }
+}
+
+Scalar2BOperator::Scalar2BOperator(const Scalar2BOperator& other)
+    : ms_ptr_(other.ms_ptr_), herm_(other.herm_) {
+  first_touch_chans_ = other.first_touch_chans_;
+  ShareBufferWith(other);
+}
+
+Scalar2BOperator& Scalar2BOperator::operator=(const Scalar2BOperator& other) {
+  Scalar2BOperator tmp(other);
+  swap(tmp);
+  return *this;
+}
+
+ntcl::FArray<double, 4> Scalar2BOperator::GetTensorAtIndex(
+    std::size_t i) const {
+  if (SharesTensorAtIndex(i)) {
+    return TensorViewAtIndex(shared_->data, i);
+  }
+  return TensorViewAtIndex(data_.get(), i);
+}
+
+ntcl::FArray<double, 4> Scalar2BOperator::GetMutableTensorAtIndex(
+    std::size_t i) {
+  if (SharesTensorAtIndex(i)) {
+    // The calling thread first-touches the copy.
+    const auto& layout = ms_ptr_->ChannelLayout();
+    AllocateWriteBuffer();
+    std::copy_n(shared_->data + layout.Offset(i), layout.ChannelSize(i),
+                data_.get() + layout.Offset(i));
+    MarkTensorWrittenAtIndex(i);
+  }
+  return TensorViewAtIndex(data_.get(), i);
+}
+
+void Scalar2BOperator::EvictAllTensors() const {
+  for (std::size_t index = 0; index < size(); index += 1) {
+    EvictTensorAtIndex(index);
+  }
+}
+
+int Scalar2BOperator::FirstTouchThreadAtIndex(std::size_t i) const {
+  for (std::size_t thread_id = 0; thread_id < first_touch_chans_.size();
+       thread_id += 1) {
+    const auto [begin, end] = first_touch_chans_[thread_id];
+    if ((begin <= i) && (i < end)) {
+      return static_cast<int>(thread_id);
+    }
+  }
+  return -1;
+}
+
+Scalar2BTensorPlacement Scalar2BOperator::TensorPlacement() const {
+  const auto& layout = ms_ptr_->ChannelLayout();
+  const auto num_threads = first_touch_chans_.size();
+
+  Scalar2BTensorPlacement placement;
+  placement.channels_per_thread.resize(num_threads, 0);
+  placement.bytes_per_thread.resize(num_threads, 0);
+
+  for (std::size_t thread_id = 0; thread_id < num_threads; thread_id += 1) {
+    const auto [begin, end] = first_touch_chans_[thread_id];
+    if (begin >= end) {
+      continue;
+    }
+    placement.channels_per_thread[thread_id] = end - begin;
+    placement.bytes_per_thread[thread_id] =
+        (layout.Offset(end) - layout.Offset(begin)) * sizeof(double);
+  }
+
+  return placement;
+}
+
+ntcl::FArray<double, 4> Scalar2BOperator::TensorViewAtIndex(
+    const double* data, std::size_t i) const {
+  const auto& layout = ms_ptr_->ChannelLayout();
+  const auto& dims = layout.ChannelDims(i);
+  // Constness is enforced by GetTensorAtIndex.
+  return ntcl::FArray<double, 4>(const_cast<double*>(data) + layout.Offset(i),
+                                 dims[0], dims[1], dims[2], dims[3]);
+}
+
+void Scalar2BOperator::AllocateWriteBuffer() {
+  std::call_once(shared_->allocate_flag, [this]() {
+    if (shared_->storage != nullptr) {
+      storage_ = Scalar2BMappedStorage::FromLayoutOf(*shared_->storage);
+      data_ = std::shared_ptr<double[]>(storage_, storage_->Data());
+      return;
+    }
+    data_ = imsrg::detail::AllocateBuffer(ms_ptr_->ChannelLayout());
+  });
+}
+
+void Scalar2BOperator::MarkTensorWrittenAtIndex(std::size_t i) {
+  shared_->written[i] = 1;
+
+  // Other threads only read the shared buffer for channels not written yet.
+  if (shared_->num_written.fetch_add(1) + 1 == size()) {
+    shared_->owner.reset();
+    shared_->storage.reset();
+  }
+}
+
+void Scalar2BOperator::ShareBufferWith(const Scalar2BOperator& other) {
+  const auto& layout = ms_ptr_->ChannelLayout();
+  const auto num_chans = layout.NumberOfChannels();
+
+  // Channels of other written since its last copy are in other.data_, the
+  // rest in other.shared_. Bring other back to one buffer before sharing it.
+  if ((other.shared_ != nullptr) && (other.shared_->num_written > 0)) {
+    imsrg::detail::ForEachChannelStatic(
+        num_chans, [&layout, &other](std::size_t index) {
+          if (!other.shared_->written[index]) {
+            std::copy_n(other.shared_->data + layout.Offset(index),
+                        layout.ChannelSize(index),
+                        other.data_.get() + layout.Offset(index));
+            if (other.storage_ != nullptr) {
+              other.storage_->ReleaseChannel(index);
+            }
+          }
+        });
+    other.shared_.reset();
+  }
+
+  std::shared_ptr<const double[]> owner = other.data_;
+  std::shared_ptr<const Scalar2BMappedStorage> storage = other.storage_;
+  if (other.shared_ != nullptr) {
+    owner = other.shared_->owner;
+    storage = other.shared_->storage;
+  }
+
+  other.shared_ = std::make_unique<SharedBuffer>(owner, storage, num_chans);
+  other.data_.reset();
+  other.storage_.reset();
+  shared_ = std::make_unique<SharedBuffer>(owner, storage, num_chans);
 }
 
 ntcl::FArray<double, 4> Scalar2BOperator::GeneratePandyaTensorInPandyaChannel(
     const Scalar2BPandyaChannelKey& pandya_channel) const {
+  // Standard channels of Pandya channel (p, s, r, q) are (p, q, r, s).
+  return GeneratePandyaTensorInPandyaChannel(
+      pandya_channel,
+      ms_ptr_->ChannelIndexLookup().FindRange(imsrg::BareChannelKeyPandyaSwap(
+          pandya_channel.SingleParticleChannels())));
+}
+
+ntcl::FArray<double, 4> Scalar2BOperator::GeneratePandyaTensorInPandyaChannel(
+    const Scalar2BPandyaChannelTable::PandyaChannel& pandya_channel) const {
+  return GeneratePandyaTensorInPandyaChannel(pandya_channel.chankey,
+                                             pandya_channel.standard_chans);
+}
+
+ntcl::FArray<double, 4> Scalar2BOperator::GeneratePandyaTensorInPandyaChannel(
+    const Scalar2BPandyaChannelKey& pandya_channel,
+    Scalar2BChannelIndexLookup::ChannelRange standard_chans) const {
   // TODO(mheinz): test
   const auto [chan_p, chan_s, chan_r, chan_q] =
       pandya_channel.SingleParticleChannels();
@@ -66,23 +253,25 @@ ntcl::FArray<double, 4> Scalar2BOperator::GeneratePandyaTensorInPandyaChannel(
   const auto jj_s = chan_s.JJ().AsJJ();
   const auto jj_2b_pand = pandya_channel.OperatorChannel().JJ().AsJJ();
 
-  const auto& wigner_engine = WignerSymbolEngine::GetInstance();
-
   ntcl::FArray<double, 4> tensor(dim_p, dim_s, dim_r, dim_q);
 
-  const auto standard_chankeys = pandya_channel.StandardChannels();
-  for (const auto& chankey : standard_chankeys) {
-    const auto index = ms_ptr_->IndexOfChannelInModelSpace(chankey);
-    const auto& standard_tensor = GetTensorAtIndex(index);
+  // Standard channels cut by e2max are not in the range (their matrix
+  // elements are 0).
+  if (standard_chans.num_jj == 0) {
+    return tensor;
+  }
 
-    const auto jj_2b_standard = chankey.OpChannel().JJ().AsJJ();
+  const auto& recoupling = ms_ptr_->PandyaRecouplingTable();
+  const auto factor_index =
+      recoupling.Index(jj_p, jj_s, jj_r, jj_q, jj_2b_pand,
+                       imsrg::JJ(standard_chans.jj_min));
+  for (std::size_t i = 0; i < standard_chans.num_jj; i += 1) {
+    const auto& standard_tensor =
+        GetTensorAtIndex(standard_chans.first_index + i);
 
-    double chan_factor = -1 * imsrg::HatSquared(jj_2b_standard) *
-                         wigner_engine.Wigner6J(jj_p, jj_s, jj_2b_pand, jj_r,
-                                                jj_q, jj_2b_standard);
+    const double chan_factor = recoupling.ToPandyaFactor(factor_index + i);
 
-    imsrg::detail::AddPandyaContribution(standard_tensor, dim_p, dim_q, dim_r,
-                                         dim_s, chan_factor, tensor);
+    imsrg::detail::AddPandyaContribution(standard_tensor, chan_factor, tensor);
   }
 
   return tensor;
@@ -91,13 +280,31 @@ ntcl::FArray<double, 4> Scalar2BOperator::GeneratePandyaTensorInPandyaChannel(
 void Scalar2BOperator::AddPandyaTensor(
     const Scalar2BPandyaChannelKey& pandya_channel,
     const ntcl::FArray<double, 4>& pandya_tensor, double factor) {
+  AddPandyaTensor(
+      pandya_channel,
+      ms_ptr_->ChannelIndexLookup().FindRange(imsrg::BareChannelKeyPandyaSwap(
+          pandya_channel.SingleParticleChannels())),
+      pandya_tensor, factor);
+}
+
+void Scalar2BOperator::AddPandyaTensor(
+    const Scalar2BPandyaChannelTable::PandyaChannel& pandya_channel,
+    const ntcl::FArray<double, 4>& pandya_tensor, double factor) {
+  AddPandyaTensor(pandya_channel.chankey, pandya_channel.standard_chans,
+                  pandya_tensor, factor);
+}
+
+void Scalar2BOperator::AddPandyaTensor(
+    const Scalar2BPandyaChannelKey& pandya_channel,
+    Scalar2BChannelIndexLookup::ChannelRange standard_chans,
+    const ntcl::FArray<double, 4>& pandya_tensor, double factor) {
   // TODO(mheinz): test
+  if (standard_chans.num_jj == 0) {
+    return;
+  }
+
   const auto [chan_p, chan_s, chan_r, chan_q] =
       pandya_channel.SingleParticleChannels();
-  const auto dim_p = ms_ptr_->SingleParticleModelSpace().ChannelDim(chan_p);
-  const auto dim_q = ms_ptr_->SingleParticleModelSpace().ChannelDim(chan_q);
-  const auto dim_r = ms_ptr_->SingleParticleModelSpace().ChannelDim(chan_r);
-  const auto dim_s = ms_ptr_->SingleParticleModelSpace().ChannelDim(chan_s);
 
   const auto jj_p = chan_p.JJ().AsJJ();
   const auto jj_q = chan_q.JJ().AsJJ();
@@ -105,21 +312,17 @@ void Scalar2BOperator::AddPandyaTensor(
   const auto jj_s = chan_s.JJ().AsJJ();
   const auto jj_2b_pand = pandya_channel.OperatorChannel().JJ().AsJJ();
 
-  const auto& wigner_engine = WignerSymbolEngine::GetInstance();
-
-  const auto standard_chankeys = pandya_channel.StandardChannels();
-  for (const auto& chankey : standard_chankeys) {
-    const auto index = ms_ptr_->IndexOfChannelInModelSpace(chankey);
-    auto& standard_tensor = GetMutableTensorAtIndex(index);
-
-    const auto jj_2b_standard = chankey.OpChannel().JJ().AsJJ();
+  const auto& recoupling = ms_ptr_->PandyaRecouplingTable();
+  const auto factor_index =
+      recoupling.Index(jj_p, jj_s, jj_r, jj_q, jj_2b_pand,
+                       imsrg::JJ(standard_chans.jj_min));
+  for (std::size_t i = 0; i < standard_chans.num_jj; i += 1) {
+    auto standard_tensor =
+        GetMutableTensorAtIndex(standard_chans.first_index + i);
 
-    double chan_factor = -1 * imsrg::HatSquared(jj_2b_pand) *
-                         wigner_engine.Wigner6J(jj_p, jj_q, jj_2b_standard,
-                                                jj_r, jj_s, jj_2b_pand);
+    const double chan_factor = recoupling.FromPandyaFactor(factor_index + i);
 
-    imsrg::detail::AddPandyaContribution(pandya_tensor, dim_p, dim_s, dim_r,
-                                         dim_q, factor * chan_factor,
+    imsrg::detail::AddPandyaContribution(pandya_tensor, factor * chan_factor,
                                          standard_tensor);
   }
 }
@@ -127,9 +330,12 @@ void Scalar2BOperator::AddPandyaTensor(
 namespace detail {
 
 void AddPandyaContribution(const ntcl::FArray<double, 4>& input,
-                           std::size_t dim_p, std::size_t dim_q,
-                           std::size_t dim_r, std::size_t dim_s, double factor,
+                           double factor,
                            ntcl::FArray<double, 4>& destination) {
+  const auto dim_p = std::min(input.dim_size(0), destination.dim_size(0));
+  const auto dim_q = std::min(input.dim_size(1), destination.dim_size(3));
+  const auto dim_r = std::min(input.dim_size(2), destination.dim_size(2));
+  const auto dim_s = std::min(input.dim_size(3), destination.dim_size(1));
   for (std::size_t s = 0; s < dim_s; s += 1) {
     for (std::size_t r = 0; r < dim_r; r += 1) {
       for (std::size_t q = 0; q < dim_q; q += 1) {
@@ -140,5 +346,40 @@ void AddPandyaContribution(const ntcl::FArray<double, 4>& input,
     }
   }
 }
+
+std::shared_ptr<double[]> AllocateBuffer(const Scalar2BChannelLayout& layout) {
+  // Default-initialized, so no page is touched here.
+  return std::shared_ptr<double[]>(new double[layout.TotalSize()]);
+}
+
+template <typename F>
+std::vector<std::array<std::size_t, 2>> ForEachChannelStatic(
+    std::size_t num_chans, F&& f) {
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+  const auto& omp_runtime = imsrg::OpenMPRuntime::GetInstance();
+
+  std::vector<std::array<std::size_t, 2>> chans(
+      omp_runtime.MaxNumberOfThreads(), {num_chans, 0});
+
+  // A static schedule hands each thread one contiguous range of indices.
+#pragma omp parallel for schedule(static)
+  for (std::size_t index = 0; index < num_chans; index += 1) {
+    f(index);
+
+    auto& [begin, end] = chans[omp_runtime.ThreadId()];
+    begin = std::min(begin, index);
+    end = std::max(end, index + 1);
+  }
+
+  for (auto& [begin, end] : chans) {
+    if (begin >= end) {
+      begin = 0;
+      end = 0;
+    }
+  }
+  return chans;
+}
 }  // namespace detail
 }  // namespace imsrg
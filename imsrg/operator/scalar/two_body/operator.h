@@ -2,40 +2,146 @@
 #ifndef IMSRG_OPERATOR_SCALAR_TWO_BODY_OPERATOR_H_
 #define IMSRG_OPERATOR_SCALAR_TWO_BODY_OPERATOR_H_
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "ntcl/data/f_array.h"
 
 #include "imsrg/model_space/scalar/two_body/model_space.h"
+#include "imsrg/model_space/scalar/two_body/channel_index_lookup.h"
 #include "imsrg/model_space/scalar/two_body/pandya_channel_key.h"
+#include "imsrg/model_space/scalar/two_body/pandya_channel_table.h"
+#include "imsrg/operator/scalar/two_body/mapped_storage.h"
 #include "imsrg/quantum_numbers/hermiticity.h"
 
 namespace imsrg {
 
+// Per-thread summary of where channel tensors were first touched.
+// Both vectors are indexed by OpenMP thread id.
+struct Scalar2BTensorPlacement {
+  std::vector<std::size_t> channels_per_thread;
+  std::vector<std::size_t> bytes_per_thread;
+};
+
 class Scalar2BOperator {
  public:
+  // The matrix elements of all channels live in one buffer laid out by the
+  // Scalar2BChannelLayout of the model space. The buffer is allocated
+  // uninitialized and zeroed inside `#pragma omp parallel for
+  // schedule(static)` over channel indices. Kernels that loop over channel
+  // indices with the same schedule therefore work on memory local to their
+  // NUMA node.
   static Scalar2BOperator FromScalar2BModelSpace(
       const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr,
       Hermiticity herm);
 
+  // Out-of-core operator whose buffer is a memory-mapped scratch file at
+  // path_to_scratch_file. Tensors are views into the mapping, so pages are
+  // read from the file on access and callers bound the resident set by
+  // evicting channels they are done with.
+  static Scalar2BOperator FromScalar2BModelSpaceOutOfCore(
+      const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr,
+      Hermiticity herm, const std::string& path_to_scratch_file);
+
+  // Copies share the buffer with other (copy-on-write). Each side copies a
+  // channel into a buffer of its own when it first writes that channel
+  // after the copy, so snapshots are cheap and only modified channels are
+  // duplicated.
+  // Copies of out-of-core operators share the scratch file, channels written
+  // after the copy go to a new scratch file next to it.
+  Scalar2BOperator(const Scalar2BOperator& other);
+  Scalar2BOperator& operator=(const Scalar2BOperator& other);
+
+  // Default move and dtor
+  Scalar2BOperator(Scalar2BOperator&& other) noexcept = default;
+  Scalar2BOperator& operator=(Scalar2BOperator&& other) noexcept = default;
+  ~Scalar2BOperator() = default;
+
   Hermiticity Herm() const { return herm_; }
 
-  std::size_t size() const { return tensors_.size(); }
+  std::size_t size() const { return ms_ptr_->NumberOfChannels(); }
 
-  const ntcl::FArray<double, 4>& GetTensorAtIndex(std::size_t i) const {
-    return tensors_[i];
+  bool IsOutOfCore() const {
+    return (storage_ != nullptr) ||
+           ((shared_ != nullptr) && (shared_->storage != nullptr));
   }
 
+  // Non-owning view of the tensor at index i. It stays valid until the
+  // operator is destroyed or assigned to, or the tensor is written through
+  // GetMutableTensorAtIndex. Elements must not be modified through it.
+  ntcl::FArray<double, 4> GetTensorAtIndex(std::size_t i) const;
+
   // This is an unsafe handle to an internal object in this operator.
   // The only mutable operation supported is the setting of tensor elements,
   // i.e.: a(i, j, k, l) = 2.0; Furthermore, this is not a thread-safe operation
   // in the sense that 2 threads should not write to the same matrix element at
   // once. It is up to the user to guarantee this.
-  ntcl::FArray<double, 4>& GetMutableTensorAtIndex(std::size_t i) {
-    return tensors_[i];
+  //
+  // If the tensor is shared with a copy of this operator, it is copied first
+  // by the calling thread (UpdateTensorAtIndex skips the copy when the whole
+  // tensor is overwritten). This must not race with other accesses to the
+  // same tensor, and handles obtained before copying this operator must not
+  // be written through afterwards (they may alias the copy).
+  ntcl::FArray<double, 4> GetMutableTensorAtIndex(std::size_t i);
+
+  // Calls f(tensor, new_tensor) with a view of the tensor at index i and a
+  // mutable view that receives its new values. f must set every element of
+  // new_tensor. Both views are the same memory unless the tensor is shared
+  // with a copy, in which case new_tensor is freshly allocated instead of
+  // being copied first, so whole-channel updates (zeroing, scaling, copying)
+  // take a single pass. Same rules as GetMutableTensorAtIndex otherwise.
+  template <typename F>
+  void UpdateTensorAtIndex(std::size_t i, F&& f) {
+    if (!SharesTensorAtIndex(i)) {
+      auto tensor = TensorViewAtIndex(data_.get(), i);
+      f(tensor, tensor);
+      return;
+    }
+    AllocateWriteBuffer();
+    const auto tensor = TensorViewAtIndex(shared_->data, i);
+    auto new_tensor = TensorViewAtIndex(data_.get(), i);
+    f(tensor, new_tensor);
+    MarkTensorWrittenAtIndex(i);
   }
+
+  // Whether the tensor at index i is still shared with a copy.
+  bool SharesTensorAtIndex(std::size_t i) const {
+    return shared_ != nullptr && !shared_->written[i];
+  }
+
+  // Hint that the tensor at index i is needed soon.
+  // No-op for in-memory operators and out-of-range indices.
+  void PrefetchTensorAtIndex(std::size_t i) const {
+    if (i >= size()) {
+      return;
+    }
+    if (const auto* storage = StorageOfTensorAtIndex(i); storage != nullptr) {
+      storage->PrefetchChannel(i);
+    }
+  }
+
+  // Hint that the tensor at index i is not needed soon. Its pages are
+  // written back to the scratch file and dropped from memory, they are read
+  // in again on the next access. No-op for in-memory operators.
+  void EvictTensorAtIndex(std::size_t i) const {
+    if (const auto* storage = StorageOfTensorAtIndex(i); storage != nullptr) {
+      storage->ReleaseChannel(i);
+    }
+  }
+  void EvictAllTensors() const;
+
+  // OpenMP thread whose static-schedule share of the channel loop contains
+  // index i, which is the thread that first touched the tensor when it was
+  // allocated. -1 for out-of-core operators, whose pages come from the page
+  // cache.
+  int FirstTouchThreadAtIndex(std::size_t i) const;
+  Scalar2BTensorPlacement TensorPlacement() const;
   const Scalar2BModelSpace& GetModelSpace() const { return *ms_ptr_; }
   std::shared_ptr<const Scalar2BModelSpace> GetModelSpacePtr() const {
     return ms_ptr_;
@@ -43,26 +149,91 @@ class Scalar2BOperator {
 
   ntcl::FArray<double, 4> GeneratePandyaTensorInPandyaChannel(
       const Scalar2BPandyaChannelKey& pandya_channel) const;
+  // Same, with the standard channels precomputed in the model space
+  ntcl::FArray<double, 4> GeneratePandyaTensorInPandyaChannel(
+      const Scalar2BPandyaChannelTable::PandyaChannel& pandya_channel) const;
 
   void AddPandyaTensor(const Scalar2BPandyaChannelKey& pandya_channel,
                        const ntcl::FArray<double, 4>& pandya_tensor,
                        double factor = 1.0);
+  // Same, with the standard channels precomputed in the model space
+  void AddPandyaTensor(
+      const Scalar2BPandyaChannelTable::PandyaChannel& pandya_channel,
+      const ntcl::FArray<double, 4>& pandya_tensor, double factor = 1.0);
 
   void swap(Scalar2BOperator& other) noexcept {
     using std::swap;
     swap(ms_ptr_, other.ms_ptr_);
     swap(herm_, other.herm_);
-    swap(tensors_, other.tensors_);
+    swap(data_, other.data_);
+    swap(shared_, other.shared_);
+    swap(storage_, other.storage_);
+    swap(first_touch_chans_, other.first_touch_chans_);
   }
 
  private:
+  // Buffer shared with copies of this operator. Channels that were not
+  // written since the copy are read from it.
+  struct SharedBuffer {
+    SharedBuffer(std::shared_ptr<const double[]> owner_,
+                 std::shared_ptr<const Scalar2BMappedStorage> storage_,
+                 std::size_t num_chans)
+        : owner(std::move(owner_)),
+          storage(std::move(storage_)),
+          data(owner.get()),
+          written(num_chans, 0),
+          num_written(0) {}
+
+    // Released once every channel has been written
+    std::shared_ptr<const double[]> owner;
+    // Mapping of owner for out-of-core operators, released with it
+    std::shared_ptr<const Scalar2BMappedStorage> storage;
+    const double* data;
+    // Allocation of data_ on the first write
+    std::once_flag allocate_flag;
+    // One entry per channel
+    std::vector<std::uint8_t> written;
+    std::atomic<std::size_t> num_written;
+  };
+
   std::shared_ptr<const Scalar2BModelSpace> ms_ptr_;
   Hermiticity herm_;
-  std::vector<ntcl::FArray<double, 4>> tensors_;
+  // Matrix elements of all channels, the tensor at index i starts at
+  // ChannelLayout().Offset(i). Null while shared and not written yet.
+  // Copying shares the buffer of the source too, hence mutable.
+  mutable std::shared_ptr<double[]> data_;
+  mutable std::unique_ptr<SharedBuffer> shared_;
+  // Only set for out-of-core operators (data_ points into its mapping)
+  mutable std::shared_ptr<Scalar2BMappedStorage> storage_;
+  // Channel indices [begin, end) zeroed by each OpenMP thread on allocation,
+  // empty for out-of-core operators
+  std::vector<std::array<std::size_t, 2>> first_touch_chans_;
 
   explicit Scalar2BOperator(
       const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr, Hermiticity herm,
-      std::vector<ntcl::FArray<double, 4>>&& tensors);
+      std::shared_ptr<double[]>&& data,
+      std::vector<std::array<std::size_t, 2>>&& first_touch_chans,
+      std::shared_ptr<Scalar2BMappedStorage>&& storage = nullptr);
+
+  ntcl::FArray<double, 4> TensorViewAtIndex(const double* data,
+                                            std::size_t i) const;
+  // Mapping holding the tensor at index i, null if it is in memory
+  const Scalar2BMappedStorage* StorageOfTensorAtIndex(std::size_t i) const {
+    return SharesTensorAtIndex(i) ? shared_->storage.get() : storage_.get();
+  }
+
+  // Allocates data_ on the first write after a copy (thread-safe)
+  void AllocateWriteBuffer();
+  void MarkTensorWrittenAtIndex(std::size_t i);
+  void ShareBufferWith(const Scalar2BOperator& other);
+
+  ntcl::FArray<double, 4> GeneratePandyaTensorInPandyaChannel(
+      const Scalar2BPandyaChannelKey& pandya_channel,
+      Scalar2BChannelIndexLookup::ChannelRange standard_chans) const;
+  void AddPandyaTensor(const Scalar2BPandyaChannelKey& pandya_channel,
+                       Scalar2BChannelIndexLookup::ChannelRange standard_chans,
+                       const ntcl::FArray<double, 4>& pandya_tensor,
+                       double factor);
 };
 
 inline void swap(Scalar2BOperator& a, Scalar2BOperator& b) noexcept {
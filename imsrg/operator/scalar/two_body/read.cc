@@ -1,48 +1,209 @@
 // Copyright 2022 Matthias Heinz
 #include "imsrg/operator/scalar/two_body/read.h"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "imsrg/assert.h"
+#include "imsrg/files/formats/helpers/me2jp_index.h"
+#include "imsrg/files/formats/me2j.h"
 #include "imsrg/files/formats/me2jp.h"
+#include "imsrg/model_space/scalar/two_body/model_space.h"
+#include "imsrg/openmp_runtime.h"
 #include "imsrg/operator/scalar/two_body/operator.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/total_ang_mom.h"
 
 namespace imsrg {
 
+namespace detail {
+// Calls f(p_i, q_i, r_i, s_i, p, q, r, s) for all elements of the channel at
+// index below e2max, with p_i running fastest (the tensor layout).
+template <typename F>
+static void ForEachElementBelowE2Max(const Scalar2BModelSpace& ms,
+                                     std::size_t index, F&& f);
+
+// Locations of all elements of operators on ms from locate(p, q, r, s, jj),
+// in parallel over channels.
+template <typename L>
+static std::vector<ME2JPElementLocation> LocateElements(
+    const Scalar2BModelSpace& ms, L&& locate);
+
+// Fills op with file.Get2BMatrixElement in parallel over channels.
+template <typename File>
+static void FillOperator(const File& file, Scalar2BOperator& op);
+}  // namespace detail
+
+ME2JPReadPlan ME2JPReadPlan::FromModelSpaceAndFile(
+    const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr,
+    const ME2JPFile& me2jp) {
+  auto locs = imsrg::detail::LocateElements(
+      *ms_ptr, [&me2jp](const auto& p, const auto& q, const auto& r,
+                        const auto& s, TotalAngMom jj) {
+        return me2jp.Locate2BMatrixElement(p, q, r, s, jj);
+      });
+  return ME2JPReadPlan(ms_ptr, me2jp.EMax(), me2jp.E2Max(), std::move(locs));
+}
+
+ME2JPReadPlan ME2JPReadPlan::FromModelSpaceAndEMax(
+    const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr, HOEnergy emax) {
+  const auto index_table = imsrg::mexj::ME2JPIndexTable::FromEMax(emax);
+  auto locs = imsrg::detail::LocateElements(
+      *ms_ptr, [&index_table](const auto& p, const auto& q, const auto& r,
+                              const auto& s, TotalAngMom jj) {
+        return ME2JPFile::Locate2BMatrixElement(index_table, p, q, r, s, jj);
+      });
+  return ME2JPReadPlan(ms_ptr, emax, HOEnergy(2 * emax.AsInt()),
+                       std::move(locs));
+}
+
+ME2JPReadPlan::ME2JPReadPlan(
+    const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr, HOEnergy emax,
+    HOEnergy e2max, std::vector<ME2JPElementLocation>&& locs)
+    : ms_ptr_(ms_ptr), emax_(emax), e2max_(e2max), locs_(std::move(locs)) {
+  Expects(locs_.size() == ms_ptr_->ChannelLayout().TotalSize());
+}
+
 void ReadOperatorFromME2JP(const ME2JPFile& me2jp, Scalar2BOperator& op) {
   Expects(me2jp.Herm() == op.Herm());
+  imsrg::detail::FillOperator(me2jp, op);
+}
+
+void ReadOperatorFromME2J(const ME2JFile& me2j, Scalar2BOperator& op) {
+  Expects(me2j.Herm() == op.Herm());
+  imsrg::detail::FillOperator(me2j, op);
+}
+
+void ReadOperatorFromME2JP(const ME2JPFile& me2jp, const ME2JPReadPlan& plan,
+                           Scalar2BOperator& op) {
+  Expects(me2jp.Herm() == op.Herm());
+  Expects(me2jp.EMax() == plan.EMax());
+  Expects(me2jp.E2Max() == plan.E2Max());
+  Expects(&plan.GetModelSpace() == &op.GetModelSpace());
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
 
   const auto& ms = op.GetModelSpace();
+  const auto& layout = ms.ChannelLayout();
+  const bool in_memory = !op.IsOutOfCore();
 
+  // Out-of-core operators are filled one channel at a time, see below.
+#pragma omp parallel for schedule(dynamic) if (in_memory)
   for (std::size_t index = 0; index < ms.NumberOfChannels(); index += 1) {
-    auto& tensor_mut = op.GetMutableTensorAtIndex(index);
-    const auto& channel = ms.ChannelAtIndex(index);
-
-    const auto jj = channel.ChannelKey().OpChannel().JJ();
-
-    const auto& chan_p = channel.BraChannel1();
-    const auto& chan_q = channel.BraChannel2();
-    const auto& chan_r = channel.KetChannel1();
-    const auto& chan_s = channel.KetChannel2();
-
-    const auto& basis_p = chan_p.ChannelBasis();
-    const auto& basis_q = chan_q.ChannelBasis();
-    const auto& basis_r = chan_r.ChannelBasis();
-    const auto& basis_s = chan_s.ChannelBasis();
-
-    for (std::size_t s_i = 0; s_i < basis_s.size(); s_i += 1) {
-      const auto s = basis_s.at(s_i);
-      for (std::size_t r_i = 0; r_i < basis_r.size(); r_i += 1) {
-        const auto r = basis_r.at(r_i);
-        for (std::size_t q_i = 0; q_i < basis_q.size(); q_i += 1) {
-          const auto q = basis_q.at(q_i);
-          for (std::size_t p_i = 0; p_i < basis_p.size(); p_i += 1) {
-            const auto p = basis_p.at(p_i);
+    auto tensor_mut = op.GetMutableTensorAtIndex(index);
+    const auto& dims = layout.ChannelDims(index);
+    const auto* chan_locs = plan.LocationsAtIndex(index);
+
+    std::size_t i = 0;
+    for (std::size_t s_i = 0; s_i < dims[3]; s_i += 1) {
+      for (std::size_t r_i = 0; r_i < dims[2]; r_i += 1) {
+        for (std::size_t q_i = 0; q_i < dims[1]; q_i += 1) {
+          for (std::size_t p_i = 0; p_i < dims[0]; p_i += 1) {
             tensor_mut(p_i, q_i, r_i, s_i) =
-                me2jp.Get2BMatrixElement(p, q, r, s, jj);
+                me2jp.MatrixElementAtLocation(chan_locs[i]);
+            i += 1;
+          }
+        }
+      }
+    }
+
+    // Keep the resident set of out-of-core operators to one channel.
+    op.EvictTensorAtIndex(index);
+  }
+}
+
+namespace detail {
+template <typename F>
+void ForEachElementBelowE2Max(const Scalar2BModelSpace& ms, std::size_t index,
+                              F&& f) {
+  const auto& channel = ms.ChannelAtIndex(index);
+
+  const auto& basis_p = channel.BraChannel1().ChannelBasis();
+  const auto& basis_q = channel.BraChannel2().ChannelBasis();
+  const auto& basis_r = channel.KetChannel1().ChannelBasis();
+  const auto& basis_s = channel.KetChannel2().ChannelBasis();
+
+  // States above e2max in the corners of truncated channels stay 0.
+  const auto e2max = ms.E2Max().AsInt();
+
+  for (std::size_t s_i = 0; s_i < channel.KetDim2(); s_i += 1) {
+    const auto s = basis_s.at(s_i);
+    for (std::size_t r_i = 0; r_i < channel.KetDim1(); r_i += 1) {
+      const auto r = basis_r.at(r_i);
+      if (r.E().AsInt() + s.E().AsInt() > e2max) {
+        continue;
+      }
+      for (std::size_t q_i = 0; q_i < channel.BraDim2(); q_i += 1) {
+        const auto q = basis_q.at(q_i);
+        for (std::size_t p_i = 0; p_i < channel.BraDim1(); p_i += 1) {
+          const auto p = basis_p.at(p_i);
+          if (p.E().AsInt() + q.E().AsInt() > e2max) {
+            continue;
           }
+          f(p_i, q_i, r_i, s_i, p, q, r, s);
         }
       }
     }
   }
 }
 
+template <typename L>
+std::vector<ME2JPElementLocation> LocateElements(const Scalar2BModelSpace& ms,
+                                                 L&& locate) {
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const auto& layout = ms.ChannelLayout();
+  std::vector<ME2JPElementLocation> locs(layout.TotalSize());
+
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t index = 0; index < ms.NumberOfChannels(); index += 1) {
+    const auto jj = ms.ChannelAtIndex(index).ChannelKey().OpChannel().JJ();
+    const auto& dims = layout.ChannelDims(index);
+    auto* chan_locs = locs.data() + layout.Offset(index);
+
+    imsrg::detail::ForEachElementBelowE2Max(
+        ms, index,
+        [&](std::size_t p_i, std::size_t q_i, std::size_t r_i, std::size_t s_i,
+            const auto& p, const auto& q, const auto& r, const auto& s) {
+          chan_locs[p_i + dims[0] * (q_i + dims[1] * (r_i + dims[2] * s_i))] =
+              locate(p, q, r, s, jj);
+        });
+  }
+
+  return locs;
+}
+
+template <typename File>
+void FillOperator(const File& file, Scalar2BOperator& op) {
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const auto& ms = op.GetModelSpace();
+  const bool in_memory = !op.IsOutOfCore();
+
+  // Out-of-core operators are filled one channel at a time, see below.
+#pragma omp parallel for schedule(dynamic) if (in_memory)
+  for (std::size_t index = 0; index < ms.NumberOfChannels(); index += 1) {
+    auto tensor_mut = op.GetMutableTensorAtIndex(index);
+    const auto jj = ms.ChannelAtIndex(index).ChannelKey().OpChannel().JJ();
+
+    imsrg::detail::ForEachElementBelowE2Max(
+        ms, index,
+        [&](std::size_t p_i, std::size_t q_i, std::size_t r_i, std::size_t s_i,
+            const auto& p, const auto& q, const auto& r, const auto& s) {
+          tensor_mut(p_i, q_i, r_i, s_i) =
+              file.Get2BMatrixElement(p, q, r, s, jj);
+        });
+
+    // Keep the resident set of out-of-core operators to one channel.
+    op.EvictTensorAtIndex(index);
+  }
+}
+}  // namespace detail
+
 }  // namespace imsrg
@@ -2,12 +2,84 @@
 #ifndef IMSRG_OPERATOR_SCALAR_TWO_BODY_READ_H_
 #define IMSRG_OPERATOR_SCALAR_TWO_BODY_READ_H_
 
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "imsrg/files/formats/me2j.h"
 #include "imsrg/files/formats/me2jp.h"
+#include "imsrg/model_space/scalar/two_body/model_space.h"
 #include "imsrg/operator/scalar/two_body/operator.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
 
 namespace imsrg {
 
+// Location in ME2JP files (for one emax and e2max) of each element of
+// operators on a model space, in the order of the model space's channel
+// layout.
+//
+// Building the plan does the quantum number lookups once. Reading files with
+// the same emax and e2max into operators on the same model space is then a
+// gather.
+class ME2JPReadPlan {
+ public:
+  // me2jp only provides the emax and index lookup, its matrix elements are
+  // not used.
+  static ME2JPReadPlan FromModelSpaceAndFile(
+      const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr,
+      const ME2JPFile& me2jp);
+
+  // Plan for (untruncated) files with emax, so the plan can be built while
+  // the file is read.
+  static ME2JPReadPlan FromModelSpaceAndEMax(
+      const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr, HOEnergy emax);
+
+  // Default copy, move, and dtor
+
+  const Scalar2BModelSpace& GetModelSpace() const { return *ms_ptr_; }
+  HOEnergy EMax() const { return emax_; }
+  HOEnergy E2Max() const { return e2max_; }
+
+  // Locations of the elements of the channel at index i
+  const ME2JPElementLocation* LocationsAtIndex(std::size_t i) const {
+    return locs_.data() + ms_ptr_->ChannelLayout().Offset(i);
+  }
+
+  std::size_t SizeInBytes() const {
+    return locs_.size() * sizeof(ME2JPElementLocation);
+  }
+
+  void swap(ME2JPReadPlan& other) noexcept {
+    using std::swap;
+    swap(ms_ptr_, other.ms_ptr_);
+    swap(emax_, other.emax_);
+    swap(e2max_, other.e2max_);
+    swap(locs_, other.locs_);
+  }
+
+ private:
+  std::shared_ptr<const Scalar2BModelSpace> ms_ptr_;
+  HOEnergy emax_;
+  HOEnergy e2max_;
+  std::vector<ME2JPElementLocation> locs_;
+
+  explicit ME2JPReadPlan(
+      const std::shared_ptr<const Scalar2BModelSpace>& ms_ptr, HOEnergy emax,
+      HOEnergy e2max, std::vector<ME2JPElementLocation>&& locs);
+};
+
+inline void swap(ME2JPReadPlan& a, ME2JPReadPlan& b) noexcept { a.swap(b); }
+
 void ReadOperatorFromME2JP(const ME2JPFile& me2jp, Scalar2BOperator& op);
-}
+
+// Same, with locations from plan. The plan must be for the model space of op
+// and the emax and e2max of me2jp.
+void ReadOperatorFromME2JP(const ME2JPFile& me2jp, const ME2JPReadPlan& plan,
+                           Scalar2BOperator& op);
+
+// Isospin-coupled matrix elements are converted to the proton-neutron
+// channels of op while filling (see ME2JFile).
+void ReadOperatorFromME2J(const ME2JFile& me2j, Scalar2BOperator& op);
+}  // namespace imsrg
 
 #endif  // IMSRG_OPERATOR_SCALAR_TWO_BODY_READ_H_
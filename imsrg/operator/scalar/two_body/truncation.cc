@@ -0,0 +1,89 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/two_body/truncation.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "imsrg/model_space/scalar/two_body/model_space.h"
+#include "imsrg/model_space/single_particle/channel.h"
+#include "imsrg/openmp_runtime.h"
+#include "imsrg/operator/scalar/two_body/operator.h"
+
+namespace imsrg {
+
+namespace detail {
+static std::vector<int> LeadingStateEnergies(const SPChannel& chan,
+                                             std::size_t dim);
+}  // namespace detail
+
+void ZeroStatesAboveE2Max(Scalar2BOperator& op) {
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  const auto& ms_2b = op.GetModelSpace();
+  const auto e2max = ms_2b.E2Max().AsInt();
+
+  // Nothing to do if no pair of SP states is above the cut.
+  int emax = 0;
+  for (const auto& sp_chan : ms_2b.SingleParticleModelSpace().Channels()) {
+    const auto& basis = sp_chan.ChannelBasis();
+    emax = std::max(emax, basis.at(basis.size() - 1).E().AsInt());
+  }
+  if (2 * emax <= e2max) {
+    return;
+  }
+
+#pragma omp parallel for schedule(static)
+  for (std::size_t index = 0; index < ms_2b.NumberOfChannels(); index += 1) {
+    const auto& chan = ms_2b.ChannelAtIndex(index);
+    const auto dim_p = chan.BraDim1();
+    const auto dim_q = chan.BraDim2();
+    const auto dim_r = chan.KetDim1();
+    const auto dim_s = chan.KetDim2();
+
+    const auto e_p =
+        imsrg::detail::LeadingStateEnergies(chan.BraChannel1(), dim_p);
+    const auto e_q =
+        imsrg::detail::LeadingStateEnergies(chan.BraChannel2(), dim_q);
+    const auto e_r =
+        imsrg::detail::LeadingStateEnergies(chan.KetChannel1(), dim_r);
+    const auto e_s =
+        imsrg::detail::LeadingStateEnergies(chan.KetChannel2(), dim_s);
+
+    // Energies do not decrease within a channel, so the last states are the
+    // highest. Skip channels (and avoid detaching shared tensors) that are
+    // entirely below the cut.
+    if ((e_p.back() + e_q.back() <= e2max) &&
+        (e_r.back() + e_s.back() <= e2max)) {
+      continue;
+    }
+
+    auto tensor = op.GetMutableTensorAtIndex(index);
+    for (std::size_t s = 0; s < dim_s; s += 1) {
+      for (std::size_t r = 0; r < dim_r; r += 1) {
+        for (std::size_t q = 0; q < dim_q; q += 1) {
+          for (std::size_t p = 0; p < dim_p; p += 1) {
+            if ((e_p[p] + e_q[q] > e2max) || (e_r[r] + e_s[s] > e2max)) {
+              tensor(p, q, r, s) = 0.0;
+            }
+          }
+        }
+      }
+    }
+    op.EvictTensorAtIndex(index);
+  }
+}
+
+namespace detail {
+std::vector<int> LeadingStateEnergies(const SPChannel& chan, std::size_t dim) {
+  const auto& basis = chan.ChannelBasis();
+  std::vector<int> energies;
+  energies.reserve(dim);
+  for (std::size_t i = 0; i < dim; i += 1) {
+    energies.push_back(basis.at(i).E().AsInt());
+  }
+  return energies;
+}
+}  // namespace detail
+}  // namespace imsrg
@@ -0,0 +1,15 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_OPERATOR_SCALAR_TWO_BODY_TRUNCATION_H_
+#define IMSRG_OPERATOR_SCALAR_TWO_BODY_TRUNCATION_H_
+
+#include "imsrg/operator/scalar/two_body/operator.h"
+
+namespace imsrg {
+
+// Zeroes matrix elements with e_p + e_q > e2max or e_r + e_s > e2max.
+// Channel dims already exclude most of these states, but the corners of
+// truncated channels still hold some of them.
+void ZeroStatesAboveE2Max(Scalar2BOperator& op);
+}
+
+#endif  // IMSRG_OPERATOR_SCALAR_TWO_BODY_TRUNCATION_H_
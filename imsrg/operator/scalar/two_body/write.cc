@@ -0,0 +1,108 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/two_body/write.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "imsrg/files/formats/helpers/me2jp_index.h"
+#include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/openmp_runtime.h"
+#include "imsrg/operator/scalar/two_body/operator.h"
+#include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/total_ang_mom.h"
+
+namespace imsrg {
+
+namespace detail {
+// Whether p, q, r, s is in the order the file stores it:
+// q <= p, s <= r, and (r, s) <= (p, q).
+static bool IsME2JPFileOrder(const imsrg::mexj::NLJJT& p,
+                             const imsrg::mexj::NLJJT& q,
+                             const imsrg::mexj::NLJJT& r,
+                             const imsrg::mexj::NLJJT& s);
+}  // namespace detail
+
+ME2JPFile WriteOperatorToME2JP(const Scalar2BOperator& op, HOEnergy emax) {
+  using imsrg::mexj::NLJJT;
+  if (!imsrg::OpenMPRuntime::IsInitialized()) {
+    imsrg::OpenMPRuntime::InitializeRuntime();
+  }
+
+  auto table = imsrg::mexj::ME2JPIndexTable::FromEMax(emax);
+  std::vector<double> mes(table.NumberOfMatrixElements(), 0.0);
+
+  const auto& ms = op.GetModelSpace();
+  const auto e2max = ms.E2Max().AsInt();
+
+  // Each element in file order is in exactly one channel, so channels write
+  // to disjoint parts of mes.
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t index = 0; index < ms.NumberOfChannels(); index += 1) {
+    const auto& tensor = op.GetTensorAtIndex(index);
+    const auto& channel = ms.ChannelAtIndex(index);
+    const auto jj = channel.ChannelKey().OpChannel().JJ();
+
+    const auto& basis_p = channel.BraChannel1().ChannelBasis();
+    const auto& basis_q = channel.BraChannel2().ChannelBasis();
+    const auto& basis_r = channel.KetChannel1().ChannelBasis();
+    const auto& basis_s = channel.KetChannel2().ChannelBasis();
+
+    for (std::size_t s_i = 0; s_i < channel.KetDim2(); s_i += 1) {
+      const auto s = basis_s.at(s_i);
+      const NLJJT nljjt_s(s);
+      for (std::size_t r_i = 0; r_i < channel.KetDim1(); r_i += 1) {
+        const auto r = basis_r.at(r_i);
+        if (r.E().AsInt() + s.E().AsInt() > e2max) {
+          continue;
+        }
+        const NLJJT nljjt_r(r);
+        for (std::size_t q_i = 0; q_i < channel.BraDim2(); q_i += 1) {
+          const auto q = basis_q.at(q_i);
+          const NLJJT nljjt_q(q);
+          for (std::size_t p_i = 0; p_i < channel.BraDim1(); p_i += 1) {
+            const auto p = basis_p.at(p_i);
+            if (p.E().AsInt() + q.E().AsInt() > e2max) {
+              continue;
+            }
+            const NLJJT nljjt_p(p);
+            if (!imsrg::detail::IsME2JPFileOrder(nljjt_p, nljjt_q, nljjt_r,
+                                                 nljjt_s)) {
+              continue;
+            }
+            const auto base_index =
+                table.Offset(nljjt_p, nljjt_q, nljjt_r, nljjt_s);
+            if (base_index == imsrg::mexj::ME2JPIndexTable::npos) {
+              continue;
+            }
+            const auto jj_min = std::max(
+                imsrg::CouplingMinimum<imsrg::TotalAngMom>(nljjt_p.JJ(),
+                                                           nljjt_q.JJ()),
+                imsrg::CouplingMinimum<imsrg::TotalAngMom>(nljjt_r.JJ(),
+                                                           nljjt_s.JJ()));
+            mes[base_index + (jj.AsInt() - jj_min.AsInt()) / 2] =
+                tensor(p_i, q_i, r_i, s_i);
+          }
+        }
+      }
+    }
+  }
+
+  return ME2JPFile::FromMatrixElements(std::move(mes), emax, op.Herm());
+}
+
+namespace detail {
+bool IsME2JPFileOrder(const imsrg::mexj::NLJJT& p, const imsrg::mexj::NLJJT& q,
+                      const imsrg::mexj::NLJJT& r,
+                      const imsrg::mexj::NLJJT& s) {
+  if ((q.Index() > p.Index()) || (s.Index() > r.Index())) {
+    return false;
+  }
+  return (r.Index() < p.Index()) ||
+         ((r.Index() == p.Index()) && !(s.Index() > q.Index()));
+}
+}  // namespace detail
+
+}  // namespace imsrg
@@ -0,0 +1,17 @@
+// Copyright 2022 Matthias Heinz
+#ifndef IMSRG_OPERATOR_SCALAR_TWO_BODY_WRITE_H_
+#define IMSRG_OPERATOR_SCALAR_TWO_BODY_WRITE_H_
+
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/operator/scalar/two_body/operator.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+namespace imsrg {
+
+// Matrix elements of op in ME2JP file order for emax, to be written with the
+// ME2JPFile writers. Elements outside the model space of op are 0, elements of
+// op above emax are dropped.
+ME2JPFile WriteOperatorToME2JP(const Scalar2BOperator& op, HOEnergy emax);
+}  // namespace imsrg
+
+#endif  // IMSRG_OPERATOR_SCALAR_TWO_BODY_WRITE_H_
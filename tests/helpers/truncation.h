@@ -0,0 +1,40 @@
+// Copyright 2022 Matthias Heinz
+#ifndef TESTS_HELPERS_TRUNCATION_H_
+#define TESTS_HELPERS_TRUNCATION_H_
+
+#include "imsrg/operator/scalar/two_body/operator.h"
+
+namespace imsrg {
+namespace test {
+
+// Zeroes matrix elements with e_p + e_q > e2max or e_r + e_s > e2max.
+inline void MaskStatesAboveE2Max(imsrg::Scalar2BOperator& op, int e2max) {
+  const auto& ms_2b = op.GetModelSpace();
+  for (std::size_t index = 0; index < ms_2b.NumberOfChannels(); index += 1) {
+    const auto& chan = ms_2b.ChannelAtIndex(index);
+    const auto& basis_p = chan.BraChannel1().ChannelBasis();
+    const auto& basis_q = chan.BraChannel2().ChannelBasis();
+    const auto& basis_r = chan.KetChannel1().ChannelBasis();
+    const auto& basis_s = chan.KetChannel2().ChannelBasis();
+    auto tensor = op.GetMutableTensorAtIndex(index);
+    for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+      for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+        for (std::size_t r = 0; r < tensor.dim_size(2); r += 1) {
+          for (std::size_t s = 0; s < tensor.dim_size(3); s += 1) {
+            if ((basis_p.at(p).E().AsInt() + basis_q.at(q).E().AsInt() >
+                 e2max) ||
+                (basis_r.at(r).E().AsInt() + basis_s.at(s).E().AsInt() >
+                 e2max)) {
+              tensor(p, q, r, s) = 0.0;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace imsrg
+
+#endif  // TESTS_HELPERS_TRUNCATION_H_
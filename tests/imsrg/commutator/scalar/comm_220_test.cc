@@ -152,3 +152,59 @@ TEST_CASE("Test emax=6 NAT O16 [2, 2] -> 0 commutator (anti-herm, herm).",
     REQUIRE(result == Approx(expected).margin(1e-5));
   }
 }
+
+TEST_CASE("Test emax=4 NAT O16 [2, 2] -> 0 commutator in reduced precision.") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  auto h2 = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b, Hermiticity::Hermitian());
+  auto gen2 = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b, Hermiticity::AntiHermitian());
+
+  std::string path_to_h2_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04.me2jp";
+  std::string path_to_gen2_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04_"
+      "imaginary-time_Moller_Plesset_gen2.me2jp";
+
+  imsrg::ReadOperatorFromME2JP(
+      ME2JPFile::FromTextFile(path_to_h2_me2jp, emax, Hermiticity::Hermitian()),
+      h2);
+  imsrg::ReadOperatorFromME2JP(
+      ME2JPFile::FromTextFile(path_to_gen2_me2jp, emax,
+                              Hermiticity::AntiHermitian()),
+      gen2);
+
+  const auto expected = imsrg::EvaluateScalar220CommutatorRefImpl(gen2, h2);
+
+  SECTION("float") {
+    const auto h2_f = imsrg::Scalar2BFloatOperator::FromScalar2BOperator(h2);
+    const auto gen2_f =
+        imsrg::Scalar2BFloatOperator::FromScalar2BOperator(gen2);
+
+    const auto result = imsrg::EvaluateScalar220Commutator(gen2_f, h2_f);
+    REQUIRE(result == Approx(expected).epsilon(1e-5));
+  }
+
+  SECTION("bfloat16 generator, float Hamiltonian") {
+    const auto h2_f = imsrg::Scalar2BFloatOperator::FromScalar2BOperator(h2);
+    const auto gen2_bf =
+        imsrg::Scalar2BBFloat16Operator::FromScalar2BOperator(gen2);
+
+    const auto result = imsrg::EvaluateScalar220Commutator(gen2_bf, h2_f);
+    REQUIRE(result == Approx(expected).epsilon(1e-2));
+  }
+}
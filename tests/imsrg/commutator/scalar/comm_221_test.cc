@@ -20,6 +20,7 @@
 #include "imsrg/quantum_numbers/ho_energy.h"
 
 #include "tests/catch.hpp"
+#include "tests/helpers/truncation.h"
 
 TEST_CASE("Test emax=4 NAT O16 [2, 2] -> 1 commutator (anti-herm, herm).") {
   using imsrg::Hermiticity;
@@ -241,3 +242,74 @@ TEST_CASE("Test emax=6 NAT O16 [2, 2] -> 1 commutator (anti-herm, herm).",
     }
   }
 }
+
+TEST_CASE("Test e2max=6 [2, 2] -> 1 commutator matches masked full space.") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+  const int e2max = 6;
+
+  const auto sp_ms = imsrg::SPModelSpace::FromFullBasis(
+      imsrg::SPFullBasis::FromEMaxAndReferenceState(
+          emax, imsrg::ReferenceState::O16()));
+  const auto ms_1b = imsrg::Scalar1BModelSpace::FromSPModelSpace(sp_ms);
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(sp_ms);
+  const auto ms_2b_trunc =
+      imsrg::Scalar2BModelSpace::FromSPModelSpaceAndE2Max(sp_ms,
+                                                          HOEnergy(e2max));
+
+  std::string path_to_h2_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04.me2jp";
+  std::string path_to_gen2_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04_"
+      "imaginary-time_Moller_Plesset_gen2.me2jp";
+
+  const auto h2_me2jp =
+      ME2JPFile::FromTextFile(path_to_h2_me2jp, emax, Hermiticity::Hermitian());
+  const auto gen2_me2jp = ME2JPFile::FromTextFile(path_to_gen2_me2jp, emax,
+                                                  Hermiticity::AntiHermitian());
+
+  auto h2 = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b, Hermiticity::Hermitian());
+  auto gen2 = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b, Hermiticity::AntiHermitian());
+  imsrg::ReadOperatorFromME2JP(h2_me2jp, h2);
+  imsrg::ReadOperatorFromME2JP(gen2_me2jp, gen2);
+
+  // Zero states above e2max in the full-space operators
+  imsrg::test::MaskStatesAboveE2Max(h2, e2max);
+  imsrg::test::MaskStatesAboveE2Max(gen2, e2max);
+
+  auto h2_trunc = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b_trunc, Hermiticity::Hermitian());
+  auto gen2_trunc = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b_trunc, Hermiticity::AntiHermitian());
+  imsrg::ReadOperatorFromME2JP(h2_me2jp, h2_trunc);
+  imsrg::ReadOperatorFromME2JP(gen2_me2jp, gen2_trunc);
+
+  auto expected_result = imsrg::Scalar1BOperator::FromScalar1BModelSpace(
+      ms_1b, Hermiticity::Hermitian());
+  auto actual_result = imsrg::Scalar1BOperator::FromScalar1BModelSpace(
+      ms_1b, Hermiticity::Hermitian());
+
+  imsrg::EvaluateScalar221Commutator(gen2, h2, expected_result);
+  imsrg::EvaluateScalar221Commutator(gen2_trunc, h2_trunc, actual_result);
+
+  for (std::size_t chan_index = 0; chan_index < ms_1b->NumberOfChannels();
+       chan_index += 1) {
+    const auto& exp_tensor = expected_result.GetTensorAtIndex(chan_index);
+    const auto& actual_tensor = actual_result.GetTensorAtIndex(chan_index);
+
+    for (std::size_t p = 0; p < exp_tensor.dim_size(0); p += 1) {
+      for (std::size_t q = 0; q < exp_tensor.dim_size(1); q += 1) {
+        REQUIRE(actual_tensor(p, q) == Approx(exp_tensor(p, q)).margin(1e-8));
+      }
+    }
+  }
+}
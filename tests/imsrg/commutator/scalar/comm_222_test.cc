@@ -16,6 +16,7 @@
 #include "imsrg/quantum_numbers/ho_energy.h"
 
 #include "tests/catch.hpp"
+#include "tests/helpers/truncation.h"
 
 TEST_CASE("Test emax=4 NAT O16 [2, 2] -> 2 commutator (anti-herm, herm).") {
   using imsrg::Hermiticity;
@@ -134,3 +135,78 @@ TEST_CASE("Test emax=4 NAT O16 [2, 2] -> 2 commutator (anti-herm, herm).") {
     }
   }
 }
+
+TEST_CASE("Test e2max=6 [2, 2] -> 2 commutator matches masked full space.") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+  const HOEnergy e2max(6);
+
+  const auto sp_ms = imsrg::SPModelSpace::FromFullBasis(
+      imsrg::SPFullBasis::FromEMaxAndReferenceState(
+          emax, imsrg::ReferenceState::O16()));
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(sp_ms);
+  const auto ms_2b_trunc =
+      imsrg::Scalar2BModelSpace::FromSPModelSpaceAndE2Max(sp_ms, e2max);
+
+  std::string path_to_h2_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04.me2jp";
+  std::string path_to_gen2_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04_"
+      "imaginary-time_Moller_Plesset_gen2.me2jp";
+
+  const auto h2_me2jp =
+      ME2JPFile::FromTextFile(path_to_h2_me2jp, emax, Hermiticity::Hermitian());
+  const auto gen2_me2jp = ME2JPFile::FromTextFile(path_to_gen2_me2jp, emax,
+                                                  Hermiticity::AntiHermitian());
+
+  auto h2 = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b, Hermiticity::Hermitian());
+  auto gen2 = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b, Hermiticity::AntiHermitian());
+  imsrg::ReadOperatorFromME2JP(h2_me2jp, h2);
+  imsrg::ReadOperatorFromME2JP(gen2_me2jp, gen2);
+  imsrg::test::MaskStatesAboveE2Max(h2, e2max.AsInt());
+  imsrg::test::MaskStatesAboveE2Max(gen2, e2max.AsInt());
+
+  auto h2_trunc = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b_trunc, Hermiticity::Hermitian());
+  auto gen2_trunc = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b_trunc, Hermiticity::AntiHermitian());
+  imsrg::ReadOperatorFromME2JP(h2_me2jp, h2_trunc);
+  imsrg::ReadOperatorFromME2JP(gen2_me2jp, gen2_trunc);
+
+  auto expected_result = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b, Hermiticity::Hermitian());
+  auto actual_result = imsrg::Scalar2BOperator::FromScalar2BModelSpace(
+      ms_2b_trunc, Hermiticity::Hermitian());
+
+  imsrg::EvaluateScalar222Commutator(gen2, h2, expected_result);
+  imsrg::test::MaskStatesAboveE2Max(expected_result, e2max.AsInt());
+  imsrg::EvaluateScalar222Commutator(gen2_trunc, h2_trunc, actual_result);
+
+  for (std::size_t chan_index = 0; chan_index < ms_2b_trunc->NumberOfChannels();
+       chan_index += 1) {
+    const auto chankey = ms_2b_trunc->ChannelAtIndex(chan_index).ChannelKey();
+    const auto& exp_tensor = expected_result.GetTensorAtIndex(
+        ms_2b->IndexOfChannelInModelSpace(chankey));
+    const auto& actual_tensor = actual_result.GetTensorAtIndex(chan_index);
+
+    for (std::size_t p = 0; p < actual_tensor.dim_size(0); p += 1) {
+      for (std::size_t q = 0; q < actual_tensor.dim_size(1); q += 1) {
+        for (std::size_t r = 0; r < actual_tensor.dim_size(2); r += 1) {
+          for (std::size_t s = 0; s < actual_tensor.dim_size(3); s += 1) {
+            REQUIRE(actual_tensor(p, q, r, s) ==
+                    Approx(exp_tensor(p, q, r, s)).margin(1e-8));
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,43 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/formats/helpers/binary.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "tests/catch.hpp"
+
+TEST_CASE("Test checksum of matrix elements.") {
+  // Several checksum chunks and a partial last chunk
+  std::vector<double> mes(200001);
+  for (std::size_t i = 0; i < mes.size(); i += 1) {
+    mes[i] = 0.5 * static_cast<double>(i) - 7.0;
+  }
+  const auto checksum = imsrg::mexj::MEChecksum(mes.data(), mes.size());
+
+  SECTION("The checksum does not depend on the number of threads.") {
+    std::uint64_t serial_checksum = 0;
+#pragma omp parallel
+    {
+#pragma omp single
+      serial_checksum = imsrg::mexj::MEChecksum(mes.data(), mes.size());
+    }
+    REQUIRE(serial_checksum == checksum);
+  }
+
+  SECTION("Changing a matrix element changes the checksum.") {
+    mes[mes.size() - 1] += 1.0;
+    REQUIRE(imsrg::mexj::MEChecksum(mes.data(), mes.size()) != checksum);
+  }
+
+  SECTION("Swapping matrix elements changes the checksum.") {
+    std::swap(mes[0], mes[100000]);
+    REQUIRE(imsrg::mexj::MEChecksum(mes.data(), mes.size()) != checksum);
+  }
+
+  SECTION("The checksum depends on the number of matrix elements.") {
+    REQUIRE(imsrg::mexj::MEChecksum(mes.data(), mes.size() - 1) != checksum);
+    REQUIRE(imsrg::mexj::MEChecksum(mes.data(), 0) !=
+            imsrg::mexj::MEChecksum(mes.data(), 1));
+  }
+}
@@ -0,0 +1,104 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/formats/helpers/me2jp_index.h"
+
+#include <algorithm>
+
+#include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/total_ang_mom.h"
+
+#include "tests/catch.hpp"
+
+TEST_CASE("Test ME2JP index table matches file order enumeration.") {
+  using imsrg::TotalAngMom;
+  using imsrg::mexj::ME2JPIndexTable;
+
+  for (int emax_int = 0; emax_int <= 4; emax_int += 1) {
+    const imsrg::HOEnergy emax(emax_int);
+    const auto basis = imsrg::mexj::GetNLJJTs(emax);
+    const imsrg::HOEnergy e2max_full(2 * emax_int);
+    REQUIRE(ME2JPIndexTable::FromEMax(emax).NumberOfMatrixElements() ==
+            ME2JPIndexTable::FromEMaxAndE2Max(emax, e2max_full)
+                .NumberOfMatrixElements());
+
+    for (int e2max_int = 0; e2max_int <= 2 * emax_int; e2max_int += 1) {
+      const imsrg::HOEnergy e2max(e2max_int);
+      const auto table = ME2JPIndexTable::FromEMaxAndE2Max(emax, e2max);
+      const auto runs = imsrg::mexj::ME2JPTruncationRuns(emax, e2max);
+      // Kept matrix elements are in the file order, so index counts them and
+      // index_in_file counts all matrix elements.
+      std::size_t index = 0;
+      std::size_t index_in_file = 0;
+      std::size_t run_index = 0;
+      std::size_t run_end = runs[0];
+
+      for (const auto& p : basis) {
+        for (const auto& q : basis) {
+          if (q.Index() > p.Index()) {
+            continue;
+          }
+          for (const auto& r : basis) {
+            if (r.Index() > p.Index()) {
+              continue;
+            }
+            for (const auto& s : basis) {
+              if ((s.Index() > r.Index()) ||
+                  ((r.Index() == p.Index()) && (s.Index() > q.Index()))) {
+                continue;
+              }
+              std::size_t range_size = 0;
+              if ((p.P() + q.P() == r.P() + s.P()) &&
+                  (p.M_TT() + q.M_TT() == r.M_TT() + s.M_TT())) {
+                range_size =
+                    imsrg::CouplingRangeFromMinAndMax<TotalAngMom>(
+                        std::max(imsrg::CouplingMinimum<TotalAngMom>(p.JJ(),
+                                                                     q.JJ()),
+                                 imsrg::CouplingMinimum<TotalAngMom>(r.JJ(),
+                                                                     s.JJ())),
+                        std::min(imsrg::CouplingMaximum<TotalAngMom>(p.JJ(),
+                                                                     q.JJ()),
+                                 imsrg::CouplingMaximum<TotalAngMom>(r.JJ(),
+                                                                     s.JJ())))
+                        .size();
+              }
+              const bool kept =
+                  (p.E().AsInt() + q.E().AsInt() <= e2max_int) &&
+                  (r.E().AsInt() + s.E().AsInt() <= e2max_int);
+
+              if ((range_size == 0) || !kept) {
+                REQUIRE(table.Offset(p, q, r, s) == ME2JPIndexTable::npos);
+              } else {
+                REQUIRE(table.Offset(p, q, r, s) == index);
+                index += range_size;
+              }
+
+              if (range_size > 0) {
+                while (index_in_file == run_end) {
+                  run_index += 1;
+                  run_end += runs[run_index];
+                }
+                REQUIRE((run_index % 2 == 0) == kept);
+                REQUIRE(index_in_file + range_size <= run_end);
+                index_in_file += range_size;
+              }
+            }
+          }
+        }
+      }
+      REQUIRE(table.NumberOfMatrixElements() == index);
+      REQUIRE(run_index + 1 == runs.size());
+      REQUIRE(index_in_file == run_end);
+    }
+  }
+}
+
+TEST_CASE("Test ME2JP index table for states above emax.") {
+  using imsrg::mexj::ME2JPIndexTable;
+
+  const auto table = ME2JPIndexTable::FromEMax(imsrg::HOEnergy(2));
+  const auto basis = imsrg::mexj::GetNLJJTs(imsrg::HOEnergy(4));
+  const auto& p = basis.back();
+  REQUIRE(table.Offset(p, p, p, p) == ME2JPIndexTable::npos);
+  REQUIRE(table.Offset(p, basis[0], p, basis[0]) == ME2JPIndexTable::npos);
+}
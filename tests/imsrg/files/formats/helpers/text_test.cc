@@ -0,0 +1,133 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/formats/helpers/text.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fmt/core.h"
+
+#include "tests/catch.hpp"
+
+TEST_CASE("Test parsing of short text.") {
+  std::vector<double> values(4, 0.0);
+
+  SECTION("All values are parsed.") {
+    REQUIRE(imsrg::mexj::ParseDoubles(" 1.5\n-2e3\t+0.25   -0.0\n",
+                                      values.data(), 4) == 4);
+    REQUIRE(values[0] == 1.5);
+    REQUIRE(values[1] == -2000.0);
+    REQUIRE(values[2] == 0.25);
+    REQUIRE(values[3] == 0.0);
+  }
+
+  SECTION("Parsing stops after max values.") {
+    REQUIRE(imsrg::mexj::ParseDoubles("1.0 2.0 3.0 not-a-number",
+                                      values.data(), 3) == 3);
+    REQUIRE(values[2] == 3.0);
+  }
+
+  SECTION("Short text gives fewer values.") {
+    REQUIRE(imsrg::mexj::ParseDoubles("1.0 2.0\n", values.data(), 4) == 2);
+    REQUIRE(imsrg::mexj::ParseDoubles("", values.data(), 4) == 0);
+  }
+
+  SECTION("Invalid tokens are rejected.") {
+    REQUIRE_THROWS(
+        imsrg::mexj::ParseDoubles("1.0 2.0x 3.0", values.data(), 3));
+  }
+}
+
+TEST_CASE("Test parsing of long text matches stream extraction.") {
+  std::string text;
+  for (int i = 0; i < 200000; i += 1) {
+    text += fmt::format("{:.12f}{}", (i % 977) * 0.01337 - 5.0,
+                        (i % 10 == 9) ? "\n" : "   ");
+  }
+
+  std::vector<double> values(200000, 0.0);
+  REQUIRE(imsrg::mexj::ParseDoubles(text, values.data(), values.size()) ==
+          values.size());
+
+  std::istringstream stream(text);
+  for (std::size_t i = 0; i < values.size(); i += 1) {
+    double value;
+    stream >> value;
+    REQUIRE(values[i] == value);
+  }
+
+  // Only the first chunks are needed, the bad token is never reached.
+  std::vector<double> prefix(1000, 0.0);
+  REQUIRE(imsrg::mexj::ParseDoubles(text + " not-a-number", prefix.data(),
+                                    prefix.size()) == prefix.size());
+  for (std::size_t i = 0; i < prefix.size(); i += 1) {
+    REQUIRE(prefix[i] == values[i]);
+  }
+}
+
+TEST_CASE("Test parsing of ME2JP test data matches stream extraction.") {
+  std::string path_to_file =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04.me2jp";
+
+  const auto text = imsrg::mexj::ReadWholeFile(path_to_file);
+  const auto body = std::string_view(text).substr(text.find('\n'));
+
+  std::vector<double> expected;
+  {
+    std::ifstream file(path_to_file);
+    std::string header;
+    std::getline(file, header);
+    double value;
+    while (file >> value) {
+      expected.push_back(value);
+    }
+  }
+  REQUIRE(expected.size() > 0);
+
+  std::vector<double> values(expected.size() + 1, 0.0);
+  REQUIRE(imsrg::mexj::ParseDoubles(body, values.data(), values.size()) ==
+          expected.size());
+  for (std::size_t i = 0; i < expected.size(); i += 1) {
+    REQUIRE(values[i] == expected[i]);
+  }
+}
+
+TEST_CASE("Test streaming parser matches parsing of whole text.") {
+  // More than one block, so tokens are split across blocks.
+  std::string text;
+  const std::size_t num_values = 1500000;
+  for (std::size_t i = 0; i < num_values; i += 1) {
+    text += fmt::format("{:.12f}{}", (i % 977) * 0.01337 - 5.0,
+                        (i % 10 == 9) ? "\n" : "   ");
+  }
+  std::vector<double> expected(num_values, 0.0);
+  REQUIRE(imsrg::mexj::ParseDoubles(text, expected.data(), num_values) ==
+          num_values);
+
+  std::vector<double> values;
+  std::size_t num_calls = 0;
+  const auto consume = [&values, &num_calls](const double* chunk,
+                                             std::size_t size) {
+    values.insert(values.end(), chunk, chunk + size);
+    num_calls += 1;
+  };
+
+  SECTION("All values are streamed.") {
+    std::istringstream stream(text);
+    REQUIRE(imsrg::mexj::StreamDoubles(stream, num_values + 1, consume) ==
+            num_values);
+    REQUIRE(num_calls > 1);
+    REQUIRE(values == expected);
+  }
+
+  SECTION("Streaming stops after max values.") {
+    std::istringstream stream(text);
+    REQUIRE(imsrg::mexj::StreamDoubles(stream, 12345, consume) == 12345);
+    REQUIRE(values.size() == 12345);
+    REQUIRE(values.back() == expected[12344]);
+  }
+}
@@ -1,9 +1,16 @@
 // Copyright 2022 Matthias Heinz
 #include "imsrg/files/formats/me1j.h"
 
+#include <zlib.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "imsrg/model_space/single_particle/state.h"
 #include "imsrg/model_space/single_particle/state_string.h"
@@ -81,3 +88,99 @@ TEST_CASE("Test read-in of Ragnar emax=4 NAT ME1J Hamiltonian.") {
             Approx(0.0).margin(1e-5));
   }
 }
+
+TEST_CASE("Test ME1J binary, text, and gzip round trips.") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME1JFile;
+  using imsrg::OccupationNumber;
+  using imsrg::SPState;
+  using imsrg::SPStateString;
+
+  std::string path_to_file =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04.me1j";
+  const std::string path = (std::filesystem::temp_directory_path() /
+                            "imsrg_me1j_test_emax_4.me1j")
+                               .string();
+  std::remove(path.c_str());
+
+  const auto me1j = ME1JFile::FromTextFile(path_to_file, HOEnergy(4),
+                                           Hermiticity::Hermitian());
+
+  std::vector<SPState> states;
+  for (const auto* state : {"n0s1/2", "p0s1/2", "n0p1/2", "p0p1/2", "n0p3/2",
+                            "p0p3/2", "n1s1/2", "p1s1/2", "n2s1/2",
+                            "p0g9/2"}) {
+    states.emplace_back(SPStateString(state), OccupationNumber::Particle());
+  }
+  const auto require_same_mes = [&states, &me1j](const ME1JFile& other) {
+    REQUIRE(other.Get0BPart() == me1j.Get0BPart());
+    for (const auto& p : states) {
+      for (const auto& q : states) {
+        REQUIRE(other.Get1BMatrixElement(p, q) ==
+                me1j.Get1BMatrixElement(p, q));
+      }
+    }
+  };
+
+  SECTION("Binary file matches text file.") {
+    me1j.WriteBinaryFile(path);
+    require_same_mes(
+        ME1JFile::FromBinary(path, HOEnergy(4), Hermiticity::Hermitian()));
+  }
+
+  SECTION("Written text file matches text file.") {
+    me1j.WriteTextFile(path);
+    require_same_mes(
+        ME1JFile::FromTextFile(path, HOEnergy(4), Hermiticity::Hermitian()));
+  }
+
+  SECTION("Gzipped file matches text file.") {
+    std::ifstream text(path_to_file);
+    const std::string contents((std::istreambuf_iterator<char>(text)),
+                               std::istreambuf_iterator<char>());
+    gzFile gz = gzopen(path.c_str(), "wb");
+    REQUIRE(gz != nullptr);
+    REQUIRE(gzwrite(gz, contents.data(),
+                    static_cast<unsigned int>(contents.size())) ==
+            static_cast<int>(contents.size()));
+    REQUIRE(gzclose(gz) == Z_OK);
+
+    require_same_mes(
+        ME1JFile::FromGZippedFile(path, HOEnergy(4), Hermiticity::Hermitian()));
+    // Reading stops early for a smaller emax.
+    REQUIRE_NOTHROW(
+        ME1JFile::FromGZippedFile(path, HOEnergy(2), Hermiticity::Hermitian()));
+  }
+
+  SECTION("Missing gzipped file is rejected.") {
+    REQUIRE_THROWS(
+        ME1JFile::FromGZippedFile(path, HOEnergy(4), Hermiticity::Hermitian()));
+  }
+
+  SECTION("Invalid binary files are rejected.") {
+    REQUIRE_THROWS(
+        ME1JFile::FromBinary(path, HOEnergy(4), Hermiticity::Hermitian()));
+
+    me1j.WriteBinaryFile(path);
+    REQUIRE_THROWS(
+        ME1JFile::FromBinary(path, HOEnergy(4), Hermiticity::AntiHermitian()));
+    REQUIRE_THROWS(
+        ME1JFile::FromBinary(path, HOEnergy(6), Hermiticity::Hermitian()));
+
+    {
+      std::fstream file(path,
+                        std::ios::binary | std::ios::in | std::ios::out);
+      file.seekg(80);
+      const char byte = static_cast<char>(file.get() ^ 0xff);
+      file.seekp(80);
+      file.put(byte);
+    }
+    REQUIRE_THROWS(
+        ME1JFile::FromBinary(path, HOEnergy(4), Hermiticity::Hermitian()));
+  }
+
+  std::remove(path.c_str());
+}
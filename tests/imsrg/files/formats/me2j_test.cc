@@ -0,0 +1,301 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/formats/me2j.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fmt/core.h"
+
+#include "imsrg/files/formats/helpers/gzip.h"
+#include "imsrg/files/formats/helpers/mexj.h"
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/model_space/single_particle/state.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/isospin_projection.h"
+#include "imsrg/quantum_numbers/orbital_ang_mom.h"
+#include "imsrg/quantum_numbers/radial_excitation_number.h"
+#include "imsrg/quantum_numbers/total_ang_mom.h"
+
+#include "tests/catch.hpp"
+
+namespace {
+struct Orbit {
+  int n;
+  int l;
+  int jj;
+};
+
+std::vector<Orbit> OrbitsInME2JOrder(int emax) {
+  std::vector<Orbit> orbits;
+  for (int e = 0; e <= emax; e += 1) {
+    for (int l = e % 2; l <= e; l += 2) {
+      for (int jj = std::abs(2 * l - 1); jj <= 2 * l + 1; jj += 2) {
+        orbits.push_back({(e - l) / 2, l, jj});
+      }
+    }
+  }
+  return orbits;
+}
+
+imsrg::SPState StateInOrbit(const Orbit& o, imsrg::IsospinProj m_tt) {
+  return imsrg::SPState(imsrg::RadialExcitationNumber(o.n),
+                        imsrg::OrbitalAngMom(o.l), imsrg::TotalAngMom(o.jj),
+                        m_tt);
+}
+
+// Isospin-coupled matrix elements in me2j order (e2max = 2 * emax, lmax =
+// emax), inverting the proton-neutron conversion of the matrix elements of
+// file. T forbidden by antisymmetry is 0.
+template <typename File>
+std::vector<double> ME2JMatrixElements(const File& file, int emax) {
+  const auto orbits = OrbitsInME2JOrder(emax);
+  const auto proton = imsrg::IsospinProj::Proton();
+  const auto neutron = imsrg::IsospinProj::Neutron();
+
+  std::vector<double> mes;
+  for (std::size_t a = 0; a < orbits.size(); a += 1) {
+    for (std::size_t b = 0; b <= a; b += 1) {
+      for (std::size_t c = 0; c <= a; c += 1) {
+        for (std::size_t d = 0; d <= ((c == a) ? b : c); d += 1) {
+          const auto& o_a = orbits[a];
+          const auto& o_b = orbits[b];
+          const auto& o_c = orbits[c];
+          const auto& o_d = orbits[d];
+          if ((o_a.l + o_b.l + o_c.l + o_d.l) % 2 != 0) {
+            continue;
+          }
+          const int jj_min =
+              std::max(std::abs(o_a.jj - o_b.jj), std::abs(o_c.jj - o_d.jj));
+          const int jj_max = std::min(o_a.jj + o_b.jj, o_c.jj + o_d.jj);
+          const bool same_orbits = (a == b) || (c == d);
+          const double norm =
+              std::sqrt((a == b ? 2.0 : 1.0) * (c == d ? 2.0 : 1.0));
+          for (int jj = jj_min; jj <= jj_max; jj += 2) {
+            const imsrg::TotalAngMom jj_2b(jj);
+            const bool even_j = (jj / 2) % 2 == 0;
+            const double pnpn = file.Get2BMatrixElement(
+                StateInOrbit(o_a, proton), StateInOrbit(o_b, neutron),
+                StateInOrbit(o_c, proton), StateInOrbit(o_d, neutron), jj_2b);
+            const double pnnp = file.Get2BMatrixElement(
+                StateInOrbit(o_a, proton), StateInOrbit(o_b, neutron),
+                StateInOrbit(o_c, neutron), StateInOrbit(o_d, proton), jj_2b);
+            const double pppp = file.Get2BMatrixElement(
+                StateInOrbit(o_a, proton), StateInOrbit(o_b, proton),
+                StateInOrbit(o_c, proton), StateInOrbit(o_d, proton), jj_2b);
+            const double nnnn = file.Get2BMatrixElement(
+                StateInOrbit(o_a, neutron), StateInOrbit(o_b, neutron),
+                StateInOrbit(o_c, neutron), StateInOrbit(o_d, neutron), jj_2b);
+            const double t_0 = (same_orbits && even_j) ? 0.0 : 1.0;
+            const double t_1 = (same_orbits && !even_j) ? 0.0 : 1.0;
+            mes.push_back(t_0 * (pnpn - pnnp) / norm);
+            mes.push_back(t_1 * pppp);
+            mes.push_back(t_1 * (pnpn + pnnp) / norm);
+            mes.push_back(t_1 * nnnn);
+          }
+        }
+      }
+    }
+  }
+  return mes;
+}
+
+std::string ME2JText(const std::vector<double>& mes) {
+  std::string text = "    me2j file for tests\n";
+  for (std::size_t i = 0; i < mes.size(); i += 1) {
+    text += fmt::format("{:.17g}{}", mes[i], (i % 4 == 3) ? "\n" : " ");
+  }
+  return text;
+}
+
+imsrg::SPState WithFlippedCharge(const imsrg::SPState& p) {
+  return imsrg::SPState(p.RadialN(), p.L(), p.JJ(),
+                        (p.M_TT() == imsrg::IsospinProj::Proton())
+                            ? imsrg::IsospinProj::Neutron()
+                            : imsrg::IsospinProj::Proton());
+}
+
+// Whether the proton-neutron conversion of ME2JMatrixElements is exact for
+// me2jp at p, q, r, s. Otherwise, me2jp breaks isospin symmetry there.
+//
+// For pairs of different orbits, the me2j matrix elements hold the matrix
+// elements with a proton in the larger orbit of the (larger) bra pair, so
+// others are compared with flipped charges (the same for isospin-symmetric
+// interactions). Pairs in the same orbit are only compared for like
+// particles.
+bool IsIsospinSymmetricReference(const imsrg::SPState& p,
+                                 const imsrg::SPState& q,
+                                 const imsrg::SPState& r,
+                                 const imsrg::SPState& s, bool* flip) {
+  using imsrg::mexj::NLJJ;
+  *flip = false;
+  if (p.M_TT() == q.M_TT()) {
+    return true;
+  }
+  // (larger, smaller) orbit index
+  const auto pair = [](const imsrg::SPState& a, const imsrg::SPState& b) {
+    const auto i_a = NLJJ(a).Index().AsSizeT();
+    const auto i_b = NLJJ(b).Index().AsSizeT();
+    return std::make_pair(std::max(i_a, i_b), std::min(i_a, i_b));
+  };
+  const auto pair_pq = pair(p, q);
+  const auto pair_rs = pair(r, s);
+  if ((pair_pq.first == pair_pq.second) || (pair_rs.first == pair_rs.second)) {
+    return false;
+  }
+  const bool bra_is_row = pair_pq >= pair_rs;
+  const auto& row = bra_is_row ? pair_pq : pair_rs;
+  const auto& first = bra_is_row ? p : r;
+  const auto& second = bra_is_row ? q : s;
+  const auto& in_larger_orbit =
+      (NLJJ(first).Index().AsSizeT() == row.first) ? first : second;
+  *flip = in_larger_orbit.M_TT() != imsrg::IsospinProj::Proton();
+  return true;
+}
+
+// Number of proton-neutron matrix elements up to emax that differ between
+// me2j and me2jp, for J allowed for both pairs (see
+// IsIsospinSymmetricReference).
+std::size_t CountMismatches(const imsrg::ME2JFile& me2j,
+                            const imsrg::ME2JPFile& me2jp, int emax) {
+  std::vector<imsrg::SPState> states;
+  for (const auto& o : OrbitsInME2JOrder(emax)) {
+    states.push_back(StateInOrbit(o, imsrg::IsospinProj::Proton()));
+    states.push_back(StateInOrbit(o, imsrg::IsospinProj::Neutron()));
+  }
+
+  std::size_t num_mismatches = 0;
+  for (const auto& p : states) {
+    for (const auto& q : states) {
+      for (const auto& r : states) {
+        for (const auto& s : states) {
+          if (((p.M_TT() + q.M_TT()) != (r.M_TT() + s.M_TT())) ||
+              ((p.L().AsInt() + q.L().AsInt() + r.L().AsInt() +
+                s.L().AsInt()) %
+                   2 !=
+               0)) {
+            continue;
+          }
+          const int jj_min =
+              std::max(std::abs(p.JJ().AsInt() - q.JJ().AsInt()),
+                       std::abs(r.JJ().AsInt() - s.JJ().AsInt()));
+          const int jj_max = std::min(p.JJ().AsInt() + q.JJ().AsInt(),
+                                      r.JJ().AsInt() + s.JJ().AsInt());
+          for (int jj = jj_min; jj <= jj_max; jj += 2) {
+            const imsrg::TotalAngMom jj_2b(jj);
+            bool flip = false;
+            if (!IsIsospinSymmetricReference(p, q, r, s, &flip)) {
+              continue;
+            }
+            const double expected =
+                flip ? me2jp.Get2BMatrixElement(
+                           WithFlippedCharge(p), WithFlippedCharge(q),
+                           WithFlippedCharge(r), WithFlippedCharge(s), jj_2b)
+                     : me2jp.Get2BMatrixElement(p, q, r, s, jj_2b);
+            const double actual = me2j.Get2BMatrixElement(p, q, r, s, jj_2b);
+            if (std::abs(actual - expected) > 1e-10) {
+              num_mismatches += 1;
+            }
+          }
+        }
+      }
+    }
+  }
+  return num_mismatches;
+}
+}  // namespace
+
+TEST_CASE("Test proton-neutron conversion of me2j files.") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JFile;
+  using imsrg::ME2JPFile;
+  using imsrg::OrbitalAngMom;
+
+  std::string path_to_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04.me2jp";
+
+  const auto herm = Hermiticity::Hermitian();
+  const auto me2jp = ME2JPFile::FromTextFile(path_to_me2jp, HOEnergy(4), herm);
+  const auto mes = ME2JMatrixElements(me2jp, 4);
+  const auto text = ME2JText(mes);
+
+  // Converting back to isospin-coupled matrix elements gives the file.
+  const auto count_round_trip_mismatches = [&mes](const ME2JFile& me2j,
+                                                  int emax) {
+    const auto mes_2 = ME2JMatrixElements(me2j, emax);
+    REQUIRE(mes_2.size() <= mes.size());
+    std::size_t num_mismatches = 0;
+    for (std::size_t i = 0; i < mes_2.size(); i += 1) {
+      if (std::abs(mes_2[i] - mes[i]) > 1e-10) {
+        num_mismatches += 1;
+      }
+    }
+    return num_mismatches;
+  };
+
+  const auto dir = std::filesystem::temp_directory_path();
+  const std::string path = (dir / "imsrg_me2j_test.me2j").string();
+  const std::string path_gz = (dir / "imsrg_me2j_test.me2j.gz").string();
+  {
+    std::ofstream file(path);
+    file << text;
+  }
+  {
+    imsrg::mexj::GZipFileWriter file(path_gz);
+    file.Write(text);
+    file.Close();
+  }
+
+  SECTION("Text file.") {
+    const auto me2j = ME2JFile::FromTextFile(path, HOEnergy(4), HOEnergy(8),
+                                             OrbitalAngMom(4), herm);
+    REQUIRE(me2j.EMax() == HOEnergy(4));
+    REQUIRE(me2j.E2Max() == HOEnergy(8));
+    REQUIRE(me2j.LMax() == OrbitalAngMom(4));
+    REQUIRE(CountMismatches(me2j, me2jp, 4) == 0);
+    REQUIRE(count_round_trip_mismatches(me2j, 4) == 0);
+  }
+
+  SECTION("Gzipped file.") {
+    const auto me2j = ME2JFile::FromGZippedFile(
+        path_gz, HOEnergy(4), HOEnergy(8), OrbitalAngMom(4), herm);
+    REQUIRE(CountMismatches(me2j, me2jp, 4) == 0);
+    REQUIRE(count_round_trip_mismatches(me2j, 4) == 0);
+  }
+
+  SECTION("Smaller emax reads the start of the file.") {
+    const auto me2j = ME2JFile::FromTextFile(path, HOEnergy(2), HOEnergy(8),
+                                             OrbitalAngMom(4), herm);
+    REQUIRE(CountMismatches(me2j, me2jp, 2) == 0);
+    REQUIRE(count_round_trip_mismatches(me2j, 2) == 0);
+
+    imsrg::SPState p0d5_2(imsrg::RadialExcitationNumber(0),
+                          imsrg::OrbitalAngMom(2), imsrg::TotalAngMom(5),
+                          imsrg::IsospinProj::Proton());
+    imsrg::SPState p0f7_2(imsrg::RadialExcitationNumber(0),
+                          imsrg::OrbitalAngMom(3), imsrg::TotalAngMom(7),
+                          imsrg::IsospinProj::Proton());
+    REQUIRE(me2j.Get2BMatrixElement(p0f7_2, p0f7_2, p0d5_2, p0d5_2,
+                                    imsrg::TotalAngMom(0)) == 0.0);
+  }
+
+  SECTION("Too short files are rejected.") {
+    REQUIRE_THROWS(ME2JFile::FromTextFile(path, HOEnergy(6), HOEnergy(12),
+                                          OrbitalAngMom(6), herm));
+    REQUIRE_THROWS(ME2JFile::FromGZippedFile(path_gz, HOEnergy(6),
+                                             HOEnergy(12), OrbitalAngMom(6),
+                                             herm));
+  }
+
+  std::filesystem::remove(path);
+  std::filesystem::remove(path_gz);
+}
@@ -1,18 +1,47 @@
 // Copyright 2022 Matthias Heinz
 #include "imsrg/files/formats/me2jp.h"
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "imsrg/model_space/single_particle/full_basis.h"
 #include "imsrg/model_space/single_particle/state.h"
 #include "imsrg/model_space/single_particle/state_string.h"
+#include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
 #include "imsrg/quantum_numbers/hermiticity.h"
 #include "imsrg/quantum_numbers/ho_energy.h"
 #include "imsrg/quantum_numbers/total_ang_mom.h"
 
 #include "tests/catch.hpp"
 
+TEST_CASE("Test packing of ME2JP element locations.") {
+  const imsrg::ME2JPElementLocation not_stored;
+  REQUIRE_FALSE(not_stored.IsStored());
+
+  const std::size_t max_offset = (std::size_t{1} << 61) - 1;
+  for (const std::size_t offset : {std::size_t{0}, std::size_t{12345},
+                                   max_offset}) {
+    for (const int phase : {-1, 1}) {
+      for (const bool herm_swapped : {false, true}) {
+        const imsrg::ME2JPElementLocation loc(offset, phase, herm_swapped);
+        REQUIRE(loc.IsStored());
+        REQUIRE(loc.Offset() == offset);
+        REQUIRE(loc.Phase() == phase);
+        REQUIRE(loc.HermSwapped() == herm_swapped);
+      }
+    }
+  }
+}
+
 TEST_CASE("Test read-in of Ragnar emax=4 NAT ME2JP Hamiltonian.") {
   using imsrg::Hermiticity;
   using imsrg::HOEnergy;
@@ -98,3 +127,216 @@ TEST_CASE("Test read-in of Ragnar emax=4 NAT ME2JP Hamiltonian.") {
             Approx(0.0).margin(1e-5));
   }
 }
+
+TEST_CASE("Test ME2JP binary, text, and gzip round trips.") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+  using imsrg::OccupationNumber;
+  using imsrg::SPState;
+  using imsrg::SPStateString;
+  using imsrg::TotalAngMom;
+
+  std::string path_to_file =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04.me2jp";
+  const std::string path = (std::filesystem::temp_directory_path() /
+                            "imsrg_me2jp_test_emax_4.me2jp")
+                               .string();
+  std::remove(path.c_str());
+
+  const auto me2jp = ME2JPFile::FromTextFile(path_to_file, HOEnergy(4),
+                                             Hermiticity::Hermitian());
+
+  std::vector<SPState> states;
+  for (const auto* state : {"n0s1/2", "p0s1/2", "n0p1/2", "p0p1/2", "n0p3/2",
+                            "p0p3/2", "n1s1/2", "p0d5/2", "n1p3/2"}) {
+    states.emplace_back(SPStateString(state), OccupationNumber::Particle());
+  }
+  const auto require_same_mes = [&states, &me2jp](const ME2JPFile& other) {
+    for (const auto& p : states) {
+      for (const auto& q : states) {
+        for (const auto& r : states) {
+          for (const auto& s : states) {
+            for (int jj = 0; jj <= 6; jj += 2) {
+              REQUIRE(other.Get2BMatrixElement(p, q, r, s, TotalAngMom(jj)) ==
+                      me2jp.Get2BMatrixElement(p, q, r, s, TotalAngMom(jj)));
+            }
+          }
+        }
+      }
+    }
+  };
+
+  SECTION("Binary file matches text file.") {
+    me2jp.WriteBinaryFile(path);
+    require_same_mes(
+        ME2JPFile::FromBinary(path, HOEnergy(4), Hermiticity::Hermitian()));
+  }
+
+  SECTION("Written text file matches text file.") {
+    me2jp.WriteTextFile(path);
+    require_same_mes(
+        ME2JPFile::FromTextFile(path, HOEnergy(4), Hermiticity::Hermitian()));
+  }
+
+  SECTION("Binary file can be read for smaller emax.") {
+    me2jp.WriteBinaryFile(path);
+    const auto me2jp_emax_2 =
+        ME2JPFile::FromBinary(path, HOEnergy(2), Hermiticity::Hermitian());
+    const auto me2jp_text_emax_2 = ME2JPFile::FromTextFile(
+        path_to_file, HOEnergy(2), Hermiticity::Hermitian());
+    SPState n0s1_2(SPStateString("n0s1/2"), OccupationNumber::Particle());
+    SPState p0d5_2(SPStateString("p0d5/2"), OccupationNumber::Particle());
+    REQUIRE(me2jp_emax_2.Get2BMatrixElement(p0d5_2, n0s1_2, p0d5_2, n0s1_2,
+                                            TotalAngMom(4)) ==
+            me2jp_text_emax_2.Get2BMatrixElement(p0d5_2, n0s1_2, p0d5_2,
+                                                 n0s1_2, TotalAngMom(4)));
+  }
+
+  SECTION("Gzipped file matches text file.") {
+    std::ifstream text(path_to_file);
+    const std::string contents((std::istreambuf_iterator<char>(text)),
+                               std::istreambuf_iterator<char>());
+    gzFile gz = gzopen(path.c_str(), "wb");
+    REQUIRE(gz != nullptr);
+    REQUIRE(gzwrite(gz, contents.data(),
+                    static_cast<unsigned int>(contents.size())) ==
+            static_cast<int>(contents.size()));
+    REQUIRE(gzclose(gz) == Z_OK);
+
+    require_same_mes(ME2JPFile::FromGZippedFile(path, HOEnergy(4),
+                                                Hermiticity::Hermitian()));
+    // Reading stops early for a smaller emax.
+    REQUIRE_NOTHROW(ME2JPFile::FromGZippedFile(path, HOEnergy(2),
+                                               Hermiticity::Hermitian()));
+  }
+
+  SECTION("Missing gzipped file is rejected.") {
+    REQUIRE_THROWS(ME2JPFile::FromGZippedFile(path, HOEnergy(4),
+                                              Hermiticity::Hermitian()));
+  }
+
+  SECTION("Invalid binary files are rejected.") {
+    REQUIRE_THROWS(
+        ME2JPFile::FromBinary(path, HOEnergy(4), Hermiticity::Hermitian()));
+
+    me2jp.WriteBinaryFile(path);
+    REQUIRE_THROWS(ME2JPFile::FromBinary(path, HOEnergy(4),
+                                         Hermiticity::AntiHermitian()));
+    REQUIRE_THROWS(
+        ME2JPFile::FromBinary(path, HOEnergy(6), Hermiticity::Hermitian()));
+
+    {
+      std::fstream file(path,
+                        std::ios::binary | std::ios::in | std::ios::out);
+      file.seekg(128);
+      const char byte = static_cast<char>(file.get() ^ 0xff);
+      file.seekp(128);
+      file.put(byte);
+    }
+    REQUIRE_THROWS(
+        ME2JPFile::FromBinary(path, HOEnergy(4), Hermiticity::Hermitian()));
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Test truncated ME2JP reads of larger-emax files.") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+  using imsrg::TotalAngMom;
+
+  std::string path_to_file =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04.me2jp";
+  const auto herm = Hermiticity::Hermitian();
+  const HOEnergy file_emax(4);
+  const HOEnergy emax(3);
+  const HOEnergy e2max(4);
+
+  const auto me2jp = ME2JPFile::FromTextFile(path_to_file, file_emax, herm);
+  const auto basis = imsrg::SPFullBasis::FromEMax(emax);
+
+  // Number of matrix elements that differ from the full file truncated to
+  // emax and e2max
+  const auto count_mismatches = [&](const ME2JPFile& truncated) {
+    std::size_t num_mismatches = 0;
+    for (std::size_t i_p = 0; i_p < basis.size(); i_p += 1) {
+      const auto p = basis.at(i_p);
+      for (std::size_t i_q = 0; i_q < basis.size(); i_q += 1) {
+        const auto q = basis.at(i_q);
+        for (std::size_t i_r = 0; i_r < basis.size(); i_r += 1) {
+          const auto r = basis.at(i_r);
+          for (std::size_t i_s = 0; i_s < basis.size(); i_s += 1) {
+            const auto s = basis.at(i_s);
+            const bool kept =
+                (p.E().AsInt() + q.E().AsInt() <= e2max.AsInt()) &&
+                (r.E().AsInt() + s.E().AsInt() <= e2max.AsInt());
+            // J allowed for both pairs
+            const int jj_min = std::max(
+                imsrg::CouplingMinimum<TotalAngMom>(p.JJ(), q.JJ()).AsInt(),
+                imsrg::CouplingMinimum<TotalAngMom>(r.JJ(), s.JJ()).AsInt());
+            const int jj_max = std::min(
+                imsrg::CouplingMaximum<TotalAngMom>(p.JJ(), q.JJ()).AsInt(),
+                imsrg::CouplingMaximum<TotalAngMom>(r.JJ(), s.JJ()).AsInt());
+            for (int jj = jj_min; jj <= jj_max; jj += 2) {
+              const double expected =
+                  kept ? me2jp.Get2BMatrixElement(p, q, r, s, TotalAngMom(jj))
+                       : 0.0;
+              if (truncated.Get2BMatrixElement(p, q, r, s, TotalAngMom(jj)) !=
+                  expected) {
+                num_mismatches += 1;
+              }
+            }
+          }
+        }
+      }
+    }
+    return num_mismatches;
+  };
+
+  SECTION("Text file.") {
+    const auto truncated =
+        ME2JPFile::FromTextFile(path_to_file, file_emax, emax, e2max, herm);
+    REQUIRE(truncated.EMax() == emax);
+    REQUIRE(truncated.E2Max() == e2max);
+    REQUIRE(count_mismatches(truncated) == 0);
+  }
+
+  SECTION("Gzipped file.") {
+    const std::string path = (std::filesystem::temp_directory_path() /
+                              "imsrg_me2jp_test_truncated.me2jp.gz")
+                                 .string();
+    me2jp.WriteGZippedFile(path);
+    const auto truncated =
+        ME2JPFile::FromGZippedFile(path, file_emax, emax, e2max, herm);
+    std::remove(path.c_str());
+    REQUIRE(count_mismatches(truncated) == 0);
+  }
+
+  SECTION("e2max above 2 * emax keeps everything up to emax.") {
+    const auto truncated = ME2JPFile::FromTextFile(
+        path_to_file, file_emax, HOEnergy(2), HOEnergy(8), herm);
+    REQUIRE(truncated.E2Max() == HOEnergy(4));
+    const auto expected =
+        ME2JPFile::FromTextFile(path_to_file, HOEnergy(2), herm);
+    const auto basis_2 = imsrg::SPFullBasis::FromEMax(HOEnergy(2));
+    for (std::size_t i_p = 0; i_p < basis_2.size(); i_p += 1) {
+      const auto p = basis_2.at(i_p);
+      for (std::size_t i_q = 0; i_q < basis_2.size(); i_q += 1) {
+        const auto q = basis_2.at(i_q);
+        REQUIRE(truncated.Get2BMatrixElement(p, q, p, q, TotalAngMom(2)) ==
+                expected.Get2BMatrixElement(p, q, p, q, TotalAngMom(2)));
+      }
+    }
+  }
+
+  SECTION("emax above file emax is rejected.") {
+    REQUIRE_THROWS(ME2JPFile::FromTextFile(path_to_file, file_emax,
+                                           HOEnergy(5), e2max, herm));
+  }
+}
@@ -0,0 +1,47 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/files/temporary_file.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "tests/catch.hpp"
+
+TEST_CASE("Test temporary files next to their final path.") {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "imsrg_temporary_file_test")
+          .string();
+  std::filesystem::remove(path);
+
+  const auto tmp_path_1 = imsrg::CreateTemporaryFileNextTo(path);
+  const auto tmp_path_2 = imsrg::CreateTemporaryFileNextTo(path);
+  REQUIRE(tmp_path_1 != tmp_path_2);
+  REQUIRE(std::filesystem::exists(tmp_path_1));
+  REQUIRE(std::filesystem::exists(tmp_path_2));
+  REQUIRE(std::filesystem::path(tmp_path_1).parent_path() ==
+          std::filesystem::path(path).parent_path());
+
+  SECTION("A moved file replaces the final path.") {
+    {
+      std::ofstream file(tmp_path_1);
+      file << "contents";
+    }
+    REQUIRE(imsrg::MoveTemporaryFileIntoPlace(tmp_path_1, path));
+    REQUIRE_FALSE(std::filesystem::exists(tmp_path_1));
+    std::ifstream file(path);
+    std::string contents;
+    file >> contents;
+    REQUIRE(contents == "contents");
+  }
+
+  SECTION("A failed move removes the temporary file.") {
+    REQUIRE_FALSE(imsrg::MoveTemporaryFileIntoPlace(
+        tmp_path_1, path + "_missing_directory/file"));
+    REQUIRE_FALSE(std::filesystem::exists(tmp_path_1));
+  }
+
+  imsrg::RemoveTemporaryFile(tmp_path_1);
+  imsrg::RemoveTemporaryFile(tmp_path_2);
+  REQUIRE_FALSE(std::filesystem::exists(tmp_path_2));
+  std::filesystem::remove(path);
+}
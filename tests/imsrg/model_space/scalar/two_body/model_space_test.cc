@@ -0,0 +1,424 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/model_space/scalar/two_body/model_space.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "imsrg/model_space/scalar/two_body/bare_channel_key.h"
+#include "imsrg/model_space/scalar/two_body/channel_key.h"
+#include "imsrg/model_space/scalar/two_body/pandya_channel_key.h"
+#include "imsrg/model_space/single_particle/channel.h"
+#include "imsrg/model_space/single_particle/full_basis.h"
+#include "imsrg/model_space/single_particle/model_space.h"
+#include "imsrg/model_space/single_particle/reference_state.h"
+#include "imsrg/quantum_numbers/coupling/coupling_ranges.h"
+#include "imsrg/quantum_numbers/coupling/factors.h"
+#include "imsrg/quantum_numbers/coupling/wigner_symbols.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+#include "imsrg/quantum_numbers/total_ang_mom.h"
+
+#include "tests/catch.hpp"
+
+TEST_CASE("Test channels match brute-force enumeration (emax=4).") {
+  using imsrg::CouplingMaximum;
+  using imsrg::CouplingMinimum;
+  using imsrg::TotalAngMom;
+
+  const auto sp_ms = imsrg::SPModelSpace::FromFullBasis(
+      imsrg::SPFullBasis::FromEMaxAndReferenceState(
+          imsrg::HOEnergy(4), imsrg::ReferenceState::O16()));
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(sp_ms);
+
+  std::vector<imsrg::Scalar2BChannelKey> exp_chankeys;
+  std::vector<imsrg::Scalar2BBareChannelKey> exp_bare_chans;
+  const auto& sp_chans = sp_ms->Channels();
+  for (const auto& chan_p : sp_chans) {
+    for (const auto& chan_q : sp_chans) {
+      for (const auto& chan_r : sp_chans) {
+        for (const auto& chan_s : sp_chans) {
+          if (chan_p.P() + chan_q.P() != chan_r.P() + chan_s.P()) {
+            continue;
+          }
+          if (chan_p.M_TT() + chan_q.M_TT() != chan_r.M_TT() + chan_s.M_TT()) {
+            continue;
+          }
+          const auto jj_min = std::max(
+              CouplingMinimum<TotalAngMom>(chan_p.JJ(), chan_q.JJ()),
+              CouplingMinimum<TotalAngMom>(chan_r.JJ(), chan_s.JJ()));
+          const auto jj_max = std::min(
+              CouplingMaximum<TotalAngMom>(chan_p.JJ(), chan_q.JJ()),
+              CouplingMaximum<TotalAngMom>(chan_r.JJ(), chan_s.JJ()));
+          if (jj_max < jj_min) {
+            continue;
+          }
+          exp_bare_chans.push_back(
+              {chan_p.ChannelKey(), chan_q.ChannelKey(), chan_r.ChannelKey(),
+               chan_s.ChannelKey()});
+          for (const auto jj_2b :
+               imsrg::CouplingRangeFromMinAndMax(jj_min, jj_max)) {
+            exp_chankeys.push_back(imsrg::Scalar2BChannelKey(
+                {chan_p.ChannelKey(), chan_q.ChannelKey()},
+                {chan_r.ChannelKey(), chan_s.ChannelKey()}, jj_2b));
+          }
+        }
+      }
+    }
+  }
+
+  REQUIRE(ms_2b->NumberOfChannels() == exp_chankeys.size());
+  for (std::size_t i = 0; i < exp_chankeys.size(); i += 1) {
+    const auto& chan = ms_2b->ChannelAtIndex(i);
+    REQUIRE(chan.ChannelKey() == exp_chankeys[i]);
+    REQUIRE(chan.BraDim1() == chan.BraChannel1().size());
+    REQUIRE(chan.BraDim2() == chan.BraChannel2().size());
+    REQUIRE(chan.KetDim1() == chan.KetChannel1().size());
+    REQUIRE(chan.KetDim2() == chan.KetChannel2().size());
+    REQUIRE(ms_2b->IndexOfChannelInModelSpace(exp_chankeys[i]) == i);
+  }
+
+  const auto& bare_chans = ms_2b->BareChannels();
+  REQUIRE(bare_chans.size() == exp_bare_chans.size());
+  for (std::size_t i = 0; i < exp_bare_chans.size(); i += 1) {
+    REQUIRE(bare_chans[i] == exp_bare_chans[i]);
+  }
+}
+
+TEST_CASE("Test channel lookup of channels from a larger space.") {
+  const auto sp_ms = imsrg::SPModelSpace::FromFullBasis(
+      imsrg::SPFullBasis::FromEMaxAndReferenceState(
+          imsrg::HOEnergy(4), imsrg::ReferenceState::O16()));
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(sp_ms);
+
+  const auto ms_2b_large = imsrg::Scalar2BModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              imsrg::HOEnergy(6), imsrg::ReferenceState::O16())));
+
+  const auto is_sp_chan_in_ms = [&sp_ms](const imsrg::SPChannel& sp_chan) {
+    const auto& sp_chans = sp_ms->Channels();
+    return std::any_of(sp_chans.begin(), sp_chans.end(),
+                       [&sp_chan](const imsrg::SPChannel& other) {
+                         return other.ChannelKey() == sp_chan.ChannelKey();
+                       });
+  };
+
+  std::size_t num_found = 0;
+  for (std::size_t i = 0; i < ms_2b_large->NumberOfChannels(); i += 1) {
+    const auto& chan = ms_2b_large->ChannelAtIndex(i);
+    const bool exp_found = is_sp_chan_in_ms(chan.BraChannel1()) &&
+                           is_sp_chan_in_ms(chan.BraChannel2()) &&
+                           is_sp_chan_in_ms(chan.KetChannel1()) &&
+                           is_sp_chan_in_ms(chan.KetChannel2());
+    REQUIRE(ms_2b->IsChannelInModelSpace(chan.ChannelKey()) == exp_found);
+    if (exp_found) {
+      num_found += 1;
+    }
+  }
+  REQUIRE(num_found == ms_2b->NumberOfChannels());
+}
+
+TEST_CASE("Test model space cache file round trip.") {
+  const auto sp_ms = imsrg::SPModelSpace::FromFullBasis(
+      imsrg::SPFullBasis::FromEMaxAndReferenceState(
+          imsrg::HOEnergy(4), imsrg::ReferenceState::O16()));
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(sp_ms);
+
+  const std::string path = (std::filesystem::temp_directory_path() /
+                            "imsrg_model_space_test_emax_4.cache")
+                               .string();
+  std::remove(path.c_str());
+
+  SECTION("Missing file gives nullptr.") {
+    REQUIRE(imsrg::Scalar2BModelSpace::FromCacheFile(sp_ms, path) == nullptr);
+  }
+
+  SECTION("Loaded model space matches built model space.") {
+    ms_2b->WriteToCacheFile(path);
+    const auto ms_2b_cached =
+        imsrg::Scalar2BModelSpace::FromCacheFile(sp_ms, path);
+    REQUIRE(ms_2b_cached != nullptr);
+
+    REQUIRE(ms_2b_cached->NumberOfChannels() == ms_2b->NumberOfChannels());
+    for (std::size_t i = 0; i < ms_2b->NumberOfChannels(); i += 1) {
+      const auto& chan = ms_2b->ChannelAtIndex(i);
+      const auto& chan_cached = ms_2b_cached->ChannelAtIndex(i);
+      REQUIRE(chan_cached.ChannelKey() == chan.ChannelKey());
+      REQUIRE(chan_cached.BraDim1() == chan.BraDim1());
+      REQUIRE(chan_cached.BraDim2() == chan.BraDim2());
+      REQUIRE(chan_cached.KetDim1() == chan.KetDim1());
+      REQUIRE(chan_cached.KetDim2() == chan.KetDim2());
+      REQUIRE(ms_2b_cached->IndexOfChannelInModelSpace(chan.ChannelKey()) ==
+              i);
+    }
+
+    const auto& bare_chans = ms_2b->BareChannels();
+    const auto& bare_chans_cached = ms_2b_cached->BareChannels();
+    REQUIRE(bare_chans_cached.size() == bare_chans.size());
+    for (std::size_t i = 0; i < bare_chans.size(); i += 1) {
+      REQUIRE(bare_chans_cached[i] == bare_chans[i]);
+    }
+  }
+
+  SECTION("File for other SP channels gives nullptr.") {
+    imsrg::Scalar2BModelSpace::FromSPModelSpace(
+        imsrg::SPModelSpace::FromFullBasis(
+            imsrg::SPFullBasis::FromEMaxAndReferenceState(
+                imsrg::HOEnergy(2), imsrg::ReferenceState::O16())))
+        ->WriteToCacheFile(path);
+    REQUIRE(imsrg::Scalar2BModelSpace::FromCacheFile(sp_ms, path) == nullptr);
+  }
+
+  SECTION("Truncated file gives nullptr.") {
+    ms_2b->WriteToCacheFile(path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    REQUIRE(imsrg::Scalar2BModelSpace::FromCacheFile(sp_ms, path) == nullptr);
+  }
+
+  SECTION("Building with cache writes the cache file.") {
+    const auto ms_2b_built =
+        imsrg::Scalar2BModelSpace::FromSPModelSpaceWithCache(sp_ms, path);
+    REQUIRE(ms_2b_built->NumberOfChannels() == ms_2b->NumberOfChannels());
+    REQUIRE(std::filesystem::exists(path));
+    REQUIRE(imsrg::Scalar2BModelSpace::FromCacheFile(sp_ms, path) != nullptr);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Test e2max truncation of channels (emax=4, e2max=6).") {
+  using imsrg::HOEnergy;
+
+  const auto sp_ms = imsrg::SPModelSpace::FromFullBasis(
+      imsrg::SPFullBasis::FromEMaxAndReferenceState(
+          HOEnergy(4), imsrg::ReferenceState::O16()));
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(sp_ms);
+  const auto ms_2b_trunc =
+      imsrg::Scalar2BModelSpace::FromSPModelSpaceAndE2Max(sp_ms, HOEnergy(6));
+
+  REQUIRE(ms_2b->E2Max() == HOEnergy(8));
+  REQUIRE(ms_2b_trunc->E2Max() == HOEnergy(6));
+
+  // Number of states of chan with E + e_other <= e2max
+  const auto num_below = [](const imsrg::SPChannel& chan, int e_other) {
+    std::uint32_t num = 0;
+    const auto& basis = chan.ChannelBasis();
+    for (std::size_t i = 0; i < basis.size(); i += 1) {
+      if (basis.at(i).E().AsInt() + e_other <= 6) {
+        num += 1;
+      }
+    }
+    return num;
+  };
+  const auto min_e = [](const imsrg::SPChannel& chan) {
+    return chan.ChannelBasis().at(0).E().AsInt();
+  };
+
+  std::size_t index_trunc = 0;
+  for (std::size_t i = 0; i < ms_2b->NumberOfChannels(); i += 1) {
+    const auto& chan = ms_2b->ChannelAtIndex(i);
+    const auto& p = chan.BraChannel1();
+    const auto& q = chan.BraChannel2();
+    const auto& r = chan.KetChannel1();
+    const auto& s = chan.KetChannel2();
+    const bool exp_kept =
+        (min_e(p) + min_e(q) <= 6) && (min_e(r) + min_e(s) <= 6);
+    REQUIRE(ms_2b_trunc->IsChannelInModelSpace(chan.ChannelKey()) == exp_kept);
+    if (!exp_kept) {
+      continue;
+    }
+
+    const auto& chan_trunc = ms_2b_trunc->ChannelAtIndex(index_trunc);
+    REQUIRE(chan_trunc.ChannelKey() == chan.ChannelKey());
+    REQUIRE(chan_trunc.BraDim1() == num_below(p, min_e(q)));
+    REQUIRE(chan_trunc.BraDim2() == num_below(q, min_e(p)));
+    REQUIRE(chan_trunc.KetDim1() == num_below(r, min_e(s)));
+    REQUIRE(chan_trunc.KetDim2() == num_below(s, min_e(r)));
+    index_trunc += 1;
+  }
+  REQUIRE(index_trunc == ms_2b_trunc->NumberOfChannels());
+  REQUIRE(index_trunc < ms_2b->NumberOfChannels());
+
+  const auto ms_2b_untrunc =
+      imsrg::Scalar2BModelSpace::FromSPModelSpaceAndE2Max(sp_ms, HOEnergy(8));
+  REQUIRE(ms_2b_untrunc->NumberOfChannels() == ms_2b->NumberOfChannels());
+}
+
+TEST_CASE("Test model space cache file with e2max.") {
+  using imsrg::HOEnergy;
+
+  const auto sp_ms = imsrg::SPModelSpace::FromFullBasis(
+      imsrg::SPFullBasis::FromEMaxAndReferenceState(
+          HOEnergy(4), imsrg::ReferenceState::O16()));
+  const auto ms_2b =
+      imsrg::Scalar2BModelSpace::FromSPModelSpaceAndE2Max(sp_ms, HOEnergy(6));
+
+  const std::string path = (std::filesystem::temp_directory_path() /
+                            "imsrg_model_space_test_emax_4_e2max_6.cache")
+                               .string();
+  std::remove(path.c_str());
+  ms_2b->WriteToCacheFile(path);
+
+  const auto ms_2b_cached =
+      imsrg::Scalar2BModelSpace::FromCacheFile(sp_ms, HOEnergy(6), path);
+  REQUIRE(ms_2b_cached != nullptr);
+  REQUIRE(ms_2b_cached->E2Max() == HOEnergy(6));
+  REQUIRE(ms_2b_cached->NumberOfChannels() == ms_2b->NumberOfChannels());
+  for (std::size_t i = 0; i < ms_2b->NumberOfChannels(); i += 1) {
+    const auto& chan = ms_2b->ChannelAtIndex(i);
+    const auto& chan_cached = ms_2b_cached->ChannelAtIndex(i);
+    REQUIRE(chan_cached.ChannelKey() == chan.ChannelKey());
+    REQUIRE(chan_cached.BraDim1() == chan.BraDim1());
+    REQUIRE(chan_cached.BraDim2() == chan.BraDim2());
+    REQUIRE(chan_cached.KetDim1() == chan.KetDim1());
+    REQUIRE(chan_cached.KetDim2() == chan.KetDim2());
+  }
+
+  REQUIRE(imsrg::Scalar2BModelSpace::FromCacheFile(sp_ms, path) == nullptr);
+  REQUIRE(imsrg::Scalar2BModelSpace::FromCacheFile(sp_ms, HOEnergy(4), path) ==
+          nullptr);
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Test Pandya channel table matches generated Pandya channels.") {
+  const auto sp_ms = imsrg::SPModelSpace::FromFullBasis(
+      imsrg::SPFullBasis::FromEMaxAndReferenceState(
+          imsrg::HOEnergy(4), imsrg::ReferenceState::O16()));
+  const int e2max = GENERATE(8, 6);
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpaceAndE2Max(
+      sp_ms, imsrg::HOEnergy(e2max));
+
+  const auto& bare_chans = ms_2b->BareChannels();
+  const auto& table = ms_2b->PandyaChannelTable();
+  REQUIRE(table.NumberOfBareChannels() == bare_chans.size());
+
+  for (std::size_t i = 0; i < bare_chans.size(); i += 1) {
+    const auto exp_pandya_chans = imsrg::GeneratePandyaChannels(
+        imsrg::BareChannelKeyPandyaSwap(bare_chans[i]));
+    const auto pandya_chans = table.PandyaChannels(i);
+    REQUIRE(pandya_chans.size() == exp_pandya_chans.size());
+
+    for (std::size_t j = 0; j < exp_pandya_chans.size(); j += 1) {
+      const auto& pandya_chan = pandya_chans[j];
+      REQUIRE(pandya_chan.chankey == exp_pandya_chans[j]);
+
+      std::vector<std::size_t> exp_standard_indices;
+      for (const auto& chankey : exp_pandya_chans[j].StandardChannels()) {
+        if (ms_2b->IsChannelInModelSpace(chankey)) {
+          exp_standard_indices.push_back(
+              ms_2b->IndexOfChannelInModelSpace(chankey));
+        }
+      }
+      const auto& standard_chans = pandya_chan.standard_chans;
+      REQUIRE(standard_chans.num_jj == exp_standard_indices.size());
+      for (std::size_t k = 0; k < exp_standard_indices.size(); k += 1) {
+        const auto index = standard_chans.first_index + k;
+        REQUIRE(index == exp_standard_indices[k]);
+        REQUIRE(ms_2b->ChannelAtIndex(index)
+                    .ChannelKey()
+                    .OpChannel()
+                    .JJ()
+                    .AsInt() ==
+                standard_chans.jj_min + 2 * static_cast<int>(k));
+      }
+
+      const auto& exp_state_chans =
+          ms_2b->GetStateChannelsInPandyaOperatorChannel(
+              pandya_chan.chankey.OperatorChannel());
+      const auto state_chans = table.StateChannels(pandya_chan.op_chan_index);
+      REQUIRE(state_chans.size() == exp_state_chans.size());
+      for (std::size_t k = 0; k < exp_state_chans.size(); k += 1) {
+        REQUIRE(state_chans[k] == exp_state_chans[k]);
+      }
+    }
+  }
+}
+
+TEST_CASE("Test Pandya recoupling factors match 6j symbols.") {
+  const auto sp_ms = imsrg::SPModelSpace::FromFullBasis(
+      imsrg::SPFullBasis::FromEMaxAndReferenceState(
+          imsrg::HOEnergy(4), imsrg::ReferenceState::O16()));
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(sp_ms);
+
+  const auto& recoupling = ms_2b->PandyaRecouplingTable();
+  const auto& wigner_engine = imsrg::WignerSymbolEngine::GetInstance();
+
+  const auto& table = ms_2b->PandyaChannelTable();
+  for (std::size_t i = 0; i < table.NumberOfBareChannels(); i += 1) {
+    for (const auto& pandya_chan : table.PandyaChannels(i)) {
+      const auto [chan_p, chan_s, chan_r, chan_q] =
+          pandya_chan.chankey.SingleParticleChannels();
+      const auto jj_p = chan_p.JJ().AsJJ();
+      const auto jj_q = chan_q.JJ().AsJJ();
+      const auto jj_r = chan_r.JJ().AsJJ();
+      const auto jj_s = chan_s.JJ().AsJJ();
+      const auto jj_pand = pandya_chan.chankey.OperatorChannel().JJ().AsJJ();
+
+      for (const auto& chankey : pandya_chan.chankey.StandardChannels()) {
+        const auto jj_std = chankey.OpChannel().JJ().AsJJ();
+        const auto index =
+            recoupling.Index(jj_p, jj_s, jj_r, jj_q, jj_pand, jj_std);
+        REQUIRE(recoupling.ToPandyaFactor(index) ==
+                Approx(-1 * imsrg::HatSquared(jj_std) *
+                       wigner_engine.Wigner6J(jj_p, jj_s, jj_pand, jj_r, jj_q,
+                                              jj_std)));
+        REQUIRE(recoupling.FromPandyaFactor(index) ==
+                Approx(-1 * imsrg::HatSquared(jj_pand) *
+                       wigner_engine.Wigner6J(jj_p, jj_q, jj_std, jj_r, jj_s,
+                                              jj_pand)));
+      }
+    }
+  }
+
+  // Every (j_p, j_s, j_r, j_q, J', J) of the emax=4 space
+  std::size_t num_factors = 0;
+  for (int jj_p = 1; jj_p <= 9; jj_p += 2) {
+    for (int jj_s = 1; jj_s <= 9; jj_s += 2) {
+      for (int jj_r = 1; jj_r <= 9; jj_r += 2) {
+        for (int jj_q = 1; jj_q <= 9; jj_q += 2) {
+          const int n_pand =
+              std::min(jj_p + jj_s, jj_r + jj_q) / 2 -
+              std::max(std::abs(jj_p - jj_s), std::abs(jj_r - jj_q)) / 2 + 1;
+          const int n_std =
+              std::min(jj_p + jj_q, jj_r + jj_s) / 2 -
+              std::max(std::abs(jj_p - jj_q), std::abs(jj_r - jj_s)) / 2 + 1;
+          if ((n_pand > 0) && (n_std > 0)) {
+            num_factors += n_pand * n_std;
+          }
+        }
+      }
+    }
+  }
+  REQUIRE(recoupling.size() == num_factors);
+}
+
+TEST_CASE("Test channel layout matches channel dims.") {
+  const auto sp_ms = imsrg::SPModelSpace::FromFullBasis(
+      imsrg::SPFullBasis::FromEMaxAndReferenceState(
+          imsrg::HOEnergy(4), imsrg::ReferenceState::O16()));
+  const int e2max = GENERATE(8, 6);
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpaceAndE2Max(
+      sp_ms, imsrg::HOEnergy(e2max));
+
+  const auto& layout = ms_2b->ChannelLayout();
+  REQUIRE(layout.NumberOfChannels() == ms_2b->NumberOfChannels());
+
+  std::size_t offset = 0;
+  for (std::size_t i = 0; i < ms_2b->NumberOfChannels(); i += 1) {
+    const auto& chan = ms_2b->ChannelAtIndex(i);
+    const auto& dims = layout.ChannelDims(i);
+    REQUIRE(dims[0] == chan.BraDim1());
+    REQUIRE(dims[1] == chan.BraDim2());
+    REQUIRE(dims[2] == chan.KetDim1());
+    REQUIRE(dims[3] == chan.KetDim2());
+    REQUIRE(layout.Offset(i) == offset);
+    REQUIRE(layout.ChannelSize(i) == dims[0] * dims[1] * dims[2] * dims[3]);
+    offset += layout.ChannelSize(i);
+  }
+  REQUIRE(layout.TotalSize() == offset);
+}
@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "imsrg/model_space/single_particle/reference_state.h"
 #include "imsrg/model_space/single_particle/state.h"
 #include "imsrg/quantum_numbers/ho_energy.h"
 #include "imsrg/quantum_numbers/isospin_projection.h"
@@ -318,3 +319,57 @@ TEST_CASE("Test FromEMax factory method (no occs, emax=8).") {
 
   REQUIRE(basis.size() == 90);
 }
+
+TEST_CASE("Test FromEMaxAndLMax factory method (no occs, emax=6, lmax=2).") {
+  using imsrg::HOEnergy;
+  using imsrg::OrbitalAngMom;
+
+  HOEnergy emax(6);
+
+  auto basis = imsrg::SPFullBasis::FromEMaxAndLMax(emax, OrbitalAngMom(2));
+
+  REQUIRE(basis.size() == 32);
+  for (std::size_t i = 0; i < basis.size(); i += 1) {
+    REQUIRE(basis.at(i).L() <= OrbitalAngMom(2));
+  }
+
+  REQUIRE(imsrg::SPFullBasis::FromEMaxAndLMax(emax, OrbitalAngMom(6)).size() ==
+          56);
+}
+
+TEST_CASE("Test FromEMaxLMaxAndReferenceState rejects references above lmax.") {
+  using imsrg::HOEnergy;
+  using imsrg::OrbitalAngMom;
+
+  REQUIRE(imsrg::SPFullBasis::FromEMaxLMaxAndReferenceState(
+              HOEnergy(4), OrbitalAngMom(1), imsrg::ReferenceState::O16())
+              .size() == 14);
+  REQUIRE_THROWS(imsrg::SPFullBasis::FromEMaxLMaxAndReferenceState(
+      HOEnergy(4), OrbitalAngMom(0), imsrg::ReferenceState::O16()));
+}
+
+TEST_CASE("Test FromEMinEMaxAndReferenceState factory method (O16, e=1-2).") {
+  using imsrg::HOEnergy;
+
+  auto basis = imsrg::SPFullBasis::FromEMinEMaxAndReferenceState(
+      HOEnergy(1), HOEnergy(2), imsrg::ReferenceState::O16());
+
+  // p shell and sd shell
+  REQUIRE(basis.size() == 10);
+  std::size_t num_holes = 0;
+  for (std::size_t i = 0; i < basis.size(); i += 1) {
+    REQUIRE(basis.at(i).E() >= HOEnergy(1));
+    REQUIRE(basis.at(i).E() <= HOEnergy(2));
+    if (basis.at(i).E() == HOEnergy(1)) {
+      REQUIRE(basis.at(i).OccupationN() == imsrg::OccupationNumber::Hole());
+      num_holes += 1;
+    } else {
+      REQUIRE(basis.at(i).OccupationN() ==
+              imsrg::OccupationNumber::Particle());
+    }
+  }
+  REQUIRE(num_holes == 4);
+
+  REQUIRE_THROWS(imsrg::SPFullBasis::FromEMinEMaxAndReferenceState(
+      HOEnergy(2), HOEnergy(1), imsrg::ReferenceState::O16()));
+}
@@ -7,8 +7,13 @@
 #include "imsrg/model_space/jj_p_m_tt.h"
 #include "imsrg/model_space/single_particle/channel.h"
 #include "imsrg/model_space/single_particle/channel_key.h"
+#include "imsrg/model_space/single_particle/full_basis.h"
+#include "imsrg/model_space/single_particle/state_key.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
 #include "imsrg/quantum_numbers/isospin_projection.h"
+#include "imsrg/quantum_numbers/orbital_ang_mom.h"
 #include "imsrg/quantum_numbers/parity.h"
+#include "imsrg/quantum_numbers/radial_excitation_number.h"
 #include "imsrg/quantum_numbers/total_ang_mom.h"
 
 #include "tests/helpers/equality.h"
@@ -113,6 +118,27 @@ TEST_CASE("Test ctor and Channels().") {
   }
 }
 
+TEST_CASE("Test Channel(chankey).") {
+  using imsrg::TotalAngMom;
+
+  for (const auto jjmax : {TotalAngMom(9), TotalAngMom(15), TotalAngMom(45)}) {
+    const auto chans = SampleChannels(jjmax);
+    imsrg::SPModelSpace ms(chans);
+
+    for (const auto& chan : chans) {
+      REQUIRE(ms.IsChannelInModelSpace(chan.ChannelKey()));
+      REQUIRE(ms.Channel(chan.ChannelKey()) == chan);
+    }
+  }
+
+  const auto chans = SampleChannels(TotalAngMom(9));
+  imsrg::SPModelSpace ms(chans);
+  for (const auto& chan : SampleChannels(TotalAngMom(15))) {
+    REQUIRE(ms.IsChannelInModelSpace(chan.ChannelKey()) ==
+            (chan.JJ().AsInt() <= 9));
+  }
+}
+
 TEST_CASE("Test sorting of channels.") {
   using imsrg::TotalAngMom;
 
@@ -127,6 +153,38 @@ TEST_CASE("Test sorting of channels.") {
   }
 }
 
+TEST_CASE("Test state to channel and index lookup.") {
+  for (const auto emax : {2, 4, 6}) {
+    const auto full_basis = imsrg::SPFullBasis::FromEMaxAndLMax(
+        imsrg::HOEnergy(emax), imsrg::OrbitalAngMom(2));
+    const auto ms = imsrg::SPModelSpace::FromFullBasis(full_basis);
+
+    for (const auto& chan : ms->Channels()) {
+      const auto& basis = chan.ChannelBasis();
+      for (std::size_t i = 0; i < basis.size(); i += 1) {
+        const auto key = basis.at(i).StateKey();
+        REQUIRE(imsrg::SPModelSpace::ChannelKeyOfState(key) ==
+                chan.ChannelKey());
+        REQUIRE(ms->IsStateInModelSpace(key));
+        REQUIRE(ms->IndexOfStateInChannel(key) == i);
+      }
+    }
+
+    // Outside of lmax and outside of emax
+    using imsrg::IsospinProj;
+    using imsrg::OrbitalAngMom;
+    using imsrg::RadialExcitationNumber;
+    using imsrg::TotalAngMom;
+    REQUIRE_FALSE(ms->IsStateInModelSpace(
+        imsrg::SPStateKey(RadialExcitationNumber(0), OrbitalAngMom(3),
+                          TotalAngMom(7), IsospinProj::Neutron())));
+    REQUIRE_FALSE(ms->IsStateInModelSpace(
+        imsrg::SPStateKey(RadialExcitationNumber(emax / 2 + 1),
+                          OrbitalAngMom(0), TotalAngMom(1),
+                          IsospinProj::Proton())));
+  }
+}
+
 TEST_CASE("Test copy contructor.") {
   REQUIRE(std::is_copy_constructible<imsrg::SPModelSpace>::value);
 }
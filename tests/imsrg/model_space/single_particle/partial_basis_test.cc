@@ -65,6 +65,45 @@ TEST_CASE(
   REQUIRE_FALSE(IsStateInBasis(p_0d5_hole, basis));
 }
 
+TEST_CASE("Test IndexOf for states in and not in basis.") {
+  using imsrg::IsospinProj;
+  using imsrg::OccupationNumber;
+  using imsrg::OrbitalAngMom;
+  using imsrg::RadialExcitationNumber;
+  using imsrg::SPState;
+  using imsrg::TotalAngMom;
+
+  const SPState p_0s1_hole(RadialExcitationNumber(0), OrbitalAngMom(0),
+                           TotalAngMom(1), IsospinProj::Proton(),
+                           OccupationNumber::Hole());
+
+  const SPState n_0p1_hole(RadialExcitationNumber(0), OrbitalAngMom(1),
+                           TotalAngMom(1), IsospinProj::Neutron(),
+                           OccupationNumber::Hole());
+
+  const SPState n_3f7_part(RadialExcitationNumber(3), OrbitalAngMom(3),
+                           TotalAngMom(7), IsospinProj::Neutron(),
+                           OccupationNumber::Particle());
+
+  imsrg::SPPartialBasis basis({p_0s1_hole, n_0p1_hole});
+
+  REQUIRE(basis.IndexOf(p_0s1_hole.StateKey()) == 0);
+  REQUIRE(basis.IndexOf(n_0p1_hole.StateKey()) == 1);
+  REQUIRE(basis.IndexOf(n_3f7_part.StateKey()) ==
+          imsrg::SPPartialBasis::npos);
+
+  for (const auto emax : {2, 4, 6, 8}) {
+    const auto full_basis =
+        imsrg::SPFullBasis::FromEMax(imsrg::HOEnergy(emax));
+    for (const auto& [jjpmtt, basis_ptr] :
+         imsrg::PartitionSPFullBasisIntoSPPartialBases(full_basis)) {
+      for (std::size_t i = 0; i < basis_ptr->size(); i += 1) {
+        REQUIRE(basis_ptr->IndexOf(basis_ptr->at(i).StateKey()) == i);
+      }
+    }
+  }
+}
+
 TEST_CASE("Test copy contructor.") {
   REQUIRE(std::is_copy_constructible<imsrg::SPPartialBasis>::value);
 }
@@ -0,0 +1,114 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/checkpoint.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "imsrg/files/formats/me1j.h"
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/model_space/scalar/model_space.h"
+#include "imsrg/operator/scalar/one_body/read.h"
+#include "imsrg/operator/scalar/operator.h"
+#include "imsrg/operator/scalar/two_body/read.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+#include "tests/catch.hpp"
+
+TEST_CASE("Test ScalarOperator checkpoint round trips (emax=4).") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME1JFile;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+  const auto herm = Hermiticity::Hermitian();
+
+  const auto ms = imsrg::ScalarModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  const std::string path_prefix =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04";
+
+  auto op = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+  op.SetZeroBodyPart(-100.0);
+  imsrg::ReadOperatorFromME1J(
+      ME1JFile::FromTextFile(path_prefix + ".me1j", emax, herm),
+      op.MutableOneBodyPart());
+  imsrg::ReadOperatorFromME2JP(
+      ME2JPFile::FromTextFile(path_prefix + ".me2jp", emax, herm),
+      op.MutableTwoBodyPart());
+
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "imsrg_checkpoint_test.ckp")
+          .string();
+
+  const auto check_equal = [&op](const imsrg::ScalarOperator& op_2) {
+    REQUIRE(op_2.ZeroBodyPart() == op.ZeroBodyPart());
+    auto diff = op_2;
+    diff.Axpy(-1.0, op);
+    REQUIRE(diff.Norm() == 0.0);
+  };
+
+  SECTION("Round trip.") {
+    imsrg::WriteCheckpoint(op, path);
+    REQUIRE_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    auto op_2 = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+    imsrg::ReadCheckpoint(path, op_2);
+    check_equal(op_2);
+  }
+
+  SECTION("Asynchronous write of a snapshot.") {
+    imsrg::AsyncCheckpointWriter writer;
+    writer.Write(op, path);
+    REQUIRE(writer.IsWriting());
+
+    // Changes after Write are not in the checkpoint.
+    auto op_saved = op;
+    op.Scale(2.0);
+    op.SetZeroBodyPart(0.0);
+    writer.Wait();
+    REQUIRE_FALSE(writer.IsWriting());
+
+    auto op_2 = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+    imsrg::ReadCheckpoint(path, op_2);
+    op = op_saved;
+    check_equal(op_2);
+  }
+
+  SECTION("Wrong hermiticity, model space, or corrupt files are rejected.") {
+    imsrg::WriteCheckpoint(op, path);
+
+    auto op_anti = imsrg::ScalarOperator::FromScalarModelSpace(
+        ms, Hermiticity::AntiHermitian());
+    REQUIRE_THROWS(imsrg::ReadCheckpoint(path, op_anti));
+
+    const auto ms_small = imsrg::ScalarModelSpace::FromSPModelSpace(
+        imsrg::SPModelSpace::FromFullBasis(
+            imsrg::SPFullBasis::FromEMaxAndReferenceState(
+                HOEnergy(2), imsrg::ReferenceState::O16())));
+    auto op_small = imsrg::ScalarOperator::FromScalarModelSpace(ms_small, herm);
+    REQUIRE_THROWS(imsrg::ReadCheckpoint(path, op_small));
+
+    auto op_2 = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+    {
+      // Flip a byte in the last channel tensor.
+      std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+      file.seekg(-1, std::ios::end);
+      const char byte = static_cast<char>(file.get() ^ 0xff);
+      file.seekp(-1, std::ios::end);
+      file.put(byte);
+    }
+    REQUIRE_THROWS(imsrg::ReadCheckpoint(path, op_2));
+
+    REQUIRE_THROWS(imsrg::ReadCheckpoint(path + ".missing", op_2));
+  }
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,101 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/embedding.h"
+
+#include <string>
+
+#include "imsrg/files/formats/me1j.h"
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/model_space/scalar/model_space.h"
+#include "imsrg/model_space/single_particle/full_basis.h"
+#include "imsrg/model_space/single_particle/model_space.h"
+#include "imsrg/model_space/single_particle/reference_state.h"
+#include "imsrg/operator/scalar/one_body/read.h"
+#include "imsrg/operator/scalar/operator.h"
+#include "imsrg/operator/scalar/two_body/read.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+#include "tests/catch.hpp"
+
+TEST_CASE("Test restriction to and embedding from an energy window.") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME1JFile;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+  const HOEnergy emin(1);
+  const auto herm = Hermiticity::Hermitian();
+
+  const auto ms = imsrg::ScalarModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+  const auto ms_window = imsrg::ScalarModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMinEMaxAndReferenceState(
+              emin, emax, imsrg::ReferenceState::O16())));
+
+  const std::string path_prefix =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04";
+
+  auto op = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+  op.SetZeroBodyPart(-100.0);
+  imsrg::ReadOperatorFromME1J(
+      ME1JFile::FromTextFile(path_prefix + ".me1j", emax, herm),
+      op.MutableOneBodyPart());
+  imsrg::ReadOperatorFromME2JP(
+      ME2JPFile::FromTextFile(path_prefix + ".me2jp", emax, herm),
+      op.MutableTwoBodyPart());
+
+  const auto op_window = imsrg::TransferToModelSpace(op, ms_window);
+  REQUIRE(op_window.GetModelSpacePtr() == ms_window);
+  REQUIRE(op_window.ZeroBodyPart() == op.ZeroBodyPart());
+  REQUIRE(ms_window->TwoBodyModelSpace().ChannelLayout().TotalSize() <
+          ms->TwoBodyModelSpace().ChannelLayout().TotalSize());
+
+  const auto op_embedded = imsrg::TransferToModelSpace(op_window, ms);
+  REQUIRE(op_embedded.GetModelSpacePtr() == ms);
+
+  const auto& ms_1b = ms->OneBodyModelSpace();
+  for (std::size_t i = 0; i < ms_1b.NumberOfChannels(); i += 1) {
+    const auto& chan = ms_1b.ChannelAtIndex(i);
+    const auto& basis_p = chan.BraChannel().ChannelBasis();
+    const auto& basis_q = chan.KetChannel().ChannelBasis();
+    const auto& tensor = op.OneBodyPart().GetTensorAtIndex(i);
+    const auto& tensor_embedded = op_embedded.OneBodyPart().GetTensorAtIndex(i);
+    for (std::size_t q = 0; q < basis_q.size(); q += 1) {
+      for (std::size_t p = 0; p < basis_p.size(); p += 1) {
+        const bool in_window =
+            (basis_p.at(p).E() >= emin) && (basis_q.at(q).E() >= emin);
+        REQUIRE(tensor_embedded(p, q) == (in_window ? tensor(p, q) : 0.0));
+      }
+    }
+  }
+
+  const auto& ms_2b = ms->TwoBodyModelSpace();
+  for (std::size_t i = 0; i < ms_2b.NumberOfChannels(); i += 1) {
+    const auto& chan = ms_2b.ChannelAtIndex(i);
+    const auto& basis_p = chan.BraChannel1().ChannelBasis();
+    const auto& basis_q = chan.BraChannel2().ChannelBasis();
+    const auto& basis_r = chan.KetChannel1().ChannelBasis();
+    const auto& basis_s = chan.KetChannel2().ChannelBasis();
+    const auto& tensor = op.TwoBodyPart().GetTensorAtIndex(i);
+    const auto& tensor_embedded = op_embedded.TwoBodyPart().GetTensorAtIndex(i);
+    for (std::size_t s = 0; s < chan.KetDim2(); s += 1) {
+      for (std::size_t r = 0; r < chan.KetDim1(); r += 1) {
+        for (std::size_t q = 0; q < chan.BraDim2(); q += 1) {
+          for (std::size_t p = 0; p < chan.BraDim1(); p += 1) {
+            const bool in_window =
+                (basis_p.at(p).E() >= emin) && (basis_q.at(q).E() >= emin) &&
+                (basis_r.at(r).E() >= emin) && (basis_s.at(s).E() >= emin);
+            REQUIRE(tensor_embedded(p, q, r, s) ==
+                    (in_window ? tensor(p, q, r, s) : 0.0));
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,86 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/load.h"
+
+#include <string>
+
+#include "imsrg/files/formats/me1j.h"
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/model_space/scalar/model_space.h"
+#include "imsrg/operator/scalar/one_body/read.h"
+#include "imsrg/operator/scalar/operator.h"
+#include "imsrg/operator/scalar/two_body/read.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+#include "tests/catch.hpp"
+
+TEST_CASE("Test loading a ScalarOperator while setting up (emax=4).") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME1JFile;
+  using imsrg::ME2JPFile;
+  using imsrg::MEXJFileFormat;
+  using imsrg::ScalarOperatorLoader;
+
+  const HOEnergy emax(4);
+  const auto herm = Hermiticity::Hermitian();
+
+  const std::string path_prefix =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04";
+
+  // Started before the model space is built
+  auto loader = ScalarOperatorLoader::FromME1JAndME2JPFiles(
+      path_prefix + ".me1j", path_prefix + ".me2jp", MEXJFileFormat::kText,
+      emax, herm);
+
+  const auto ms = imsrg::ScalarModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  const auto me1j = ME1JFile::FromTextFile(path_prefix + ".me1j", emax, herm);
+  const auto me2jp =
+      ME2JPFile::FromTextFile(path_prefix + ".me2jp", emax, herm);
+  auto op_ref = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+  op_ref.SetZeroBodyPart(me1j.Get0BPart());
+  imsrg::ReadOperatorFromME1J(me1j, op_ref.MutableOneBodyPart());
+  imsrg::ReadOperatorFromME2JP(me2jp, op_ref.MutableTwoBodyPart());
+
+  const auto check_equal = [&op_ref](const imsrg::ScalarOperator& op) {
+    REQUIRE(op.ZeroBodyPart() == op_ref.ZeroBodyPart());
+    auto diff = op;
+    diff.Axpy(-1.0, op_ref);
+    REQUIRE(diff.Norm() == 0.0);
+  };
+
+  SECTION("Without a plan.") {
+    const auto op = loader.Load(ms);
+    check_equal(op);
+  }
+
+  SECTION("With a plan built before the file is read.") {
+    const auto plan = imsrg::ME2JPReadPlan::FromModelSpaceAndEMax(
+        ms->TwoBodyModelSpacePtr(), emax);
+    const auto op = loader.Load(ms, plan);
+    check_equal(op);
+
+    // Same locations as a plan from the file
+    const auto plan_2 = imsrg::ME2JPReadPlan::FromModelSpaceAndFile(
+        ms->TwoBodyModelSpacePtr(), me2jp);
+    auto op_2 = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+    imsrg::ReadOperatorFromME2JP(me2jp, plan_2, op_2.MutableTwoBodyPart());
+    auto op_3 = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+    imsrg::ReadOperatorFromME2JP(me2jp, plan, op_3.MutableTwoBodyPart());
+    op_3.Axpy(-1.0, op_2);
+    REQUIRE(op_3.Norm() == 0.0);
+  }
+
+  SECTION("Errors from reading are rethrown by Load.") {
+    auto loader_2 = ScalarOperatorLoader::FromME1JAndME2JPFiles(
+        path_prefix + ".me1j", path_prefix + ".missing.me2jp",
+        MEXJFileFormat::kText, emax, herm);
+    REQUIRE_THROWS(loader_2.Load(ms));
+  }
+}
@@ -0,0 +1,224 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/operator.h"
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+#include "imsrg/files/formats/me1j.h"
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/model_space/scalar/model_space.h"
+#include "imsrg/operator/scalar/one_body/read.h"
+#include "imsrg/operator/scalar/one_body/write.h"
+#include "imsrg/operator/scalar/two_body/read.h"
+#include "imsrg/operator/scalar/two_body/write.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+#include "tests/catch.hpp"
+
+namespace {
+double SumOfSquares(const imsrg::ScalarOperator& op) {
+  double sum = op.ZeroBodyPart() * op.ZeroBodyPart();
+  for (std::size_t i = 0; i < op.OneBodyPart().size(); i += 1) {
+    const auto& tensor = op.OneBodyPart().GetTensorAtIndex(i);
+    for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+      for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+        sum += tensor(p, q) * tensor(p, q);
+      }
+    }
+  }
+  for (std::size_t i = 0; i < op.TwoBodyPart().size(); i += 1) {
+    const auto& tensor = op.TwoBodyPart().GetTensorAtIndex(i);
+    for (std::size_t s = 0; s < tensor.dim_size(3); s += 1) {
+      for (std::size_t r = 0; r < tensor.dim_size(2); r += 1) {
+        for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+          for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+            sum += tensor(p, q, r, s) * tensor(p, q, r, s);
+          }
+        }
+      }
+    }
+  }
+  return sum;
+}
+}  // namespace
+
+TEST_CASE("Test ScalarOperator bulk operations (emax=4).") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME1JFile;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+  const auto herm = Hermiticity::Hermitian();
+
+  const auto ms = imsrg::ScalarModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  const std::string path_prefix =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04";
+
+  auto op = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+  op.SetZeroBodyPart(-100.0);
+  imsrg::ReadOperatorFromME1J(
+      ME1JFile::FromTextFile(path_prefix + ".me1j", emax, herm),
+      op.MutableOneBodyPart());
+  imsrg::ReadOperatorFromME2JP(
+      ME2JPFile::FromTextFile(path_prefix + ".me2jp", emax, herm),
+      op.MutableTwoBodyPart());
+
+  const double norm = op.Norm();
+  REQUIRE(norm == Approx(std::sqrt(SumOfSquares(op))));
+
+  SECTION("Scale and Axpy.") {
+    auto op_2 = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+    op_2.CopyValuesFrom(op);
+    REQUIRE(op_2.Norm() == Approx(norm));
+
+    op_2.Scale(3.0);
+    REQUIRE(op_2.ZeroBodyPart() == Approx(-300.0));
+    REQUIRE(op_2.Norm() == Approx(3.0 * norm));
+
+    op_2.Axpy(-2.0, op);
+    REQUIRE(op_2.ZeroBodyPart() == Approx(-100.0));
+    REQUIRE(op_2.Norm() == Approx(norm));
+
+    op_2.Axpy(-1.0, op);
+    REQUIRE(op_2.Norm() == Approx(0.0).margin(1e-8));
+  }
+
+  SECTION("SetZero.") {
+    auto op_2 = op;
+    op_2.SetZero();
+    REQUIRE(op_2.Norm() == 0.0);
+    REQUIRE(op.Norm() == Approx(norm));
+  }
+
+  SECTION("Stream round trip.") {
+    std::stringstream stream;
+    op.WriteToStream(stream);
+
+    auto op_2 = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+    op_2.ReadFromStream(stream);
+    REQUIRE(op_2.ZeroBodyPart() == op.ZeroBodyPart());
+
+    op_2.Axpy(-1.0, op);
+    REQUIRE(op_2.Norm() == 0.0);
+  }
+
+  SECTION("Stream with wrong hermiticity is rejected.") {
+    std::stringstream stream;
+    op.WriteToStream(stream);
+
+    auto op_2 = imsrg::ScalarOperator::FromScalarModelSpace(
+        ms, Hermiticity::AntiHermitian());
+    REQUIRE_THROWS(op_2.ReadFromStream(stream));
+  }
+
+  SECTION("Stream header stores hermiticity as 0 or 1.") {
+    auto op_anti = imsrg::ScalarOperator::FromScalarModelSpace(
+        ms, Hermiticity::AntiHermitian());
+    for (const auto* op_ptr : {&op, &op_anti}) {
+      std::stringstream stream;
+      op_ptr->WriteToStream(stream);
+
+      std::uint64_t header[2] = {0, 0};
+      stream.read(reinterpret_cast<char*>(header), sizeof(header));
+      REQUIRE(header[1] == (op_ptr->Herm().IsHermitian() ? 0 : 1));
+
+      auto op_2 =
+          imsrg::ScalarOperator::FromScalarModelSpace(ms, op_ptr->Herm());
+      stream.seekg(0);
+      op_2.ReadFromStream(stream);
+      op_2.Axpy(-1.0, *op_ptr);
+      REQUIRE(op_2.Norm() == 0.0);
+    }
+  }
+}
+
+TEST_CASE("Test ScalarOperator ME1J/ME2JP write round trips (emax=4).") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME1JFile;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+  const auto herm = Hermiticity::Hermitian();
+
+  const auto ms = imsrg::ScalarModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  const std::string path_prefix =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04";
+
+  auto op = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+  op.SetZeroBodyPart(-100.0 / 3.0);
+  imsrg::ReadOperatorFromME1J(
+      ME1JFile::FromTextFile(path_prefix + ".me1j", emax, herm),
+      op.MutableOneBodyPart());
+  imsrg::ReadOperatorFromME2JP(
+      ME2JPFile::FromTextFile(path_prefix + ".me2jp", emax, herm),
+      op.MutableTwoBodyPart());
+
+  const auto me1j =
+      imsrg::WriteOperatorToME1J(op.OneBodyPart(), emax, op.ZeroBodyPart());
+  const auto me2jp = imsrg::WriteOperatorToME2JP(op.TwoBodyPart(), emax);
+
+  const auto tmp_dir = std::filesystem::temp_directory_path();
+  const std::string path_1b = (tmp_dir / "imsrg_write_test.me1j").string();
+  const std::string path_2b = (tmp_dir / "imsrg_write_test.me2jp").string();
+
+  const auto check_round_trip = [&](const ME1JFile& me1j_read,
+                                    const ME2JPFile& me2jp_read) {
+    auto op_2 = imsrg::ScalarOperator::FromScalarModelSpace(ms, herm);
+    op_2.SetZeroBodyPart(me1j_read.Get0BPart());
+    imsrg::ReadOperatorFromME1J(me1j_read, op_2.MutableOneBodyPart());
+    imsrg::ReadOperatorFromME2JP(me2jp_read, op_2.MutableTwoBodyPart());
+    REQUIRE(op_2.ZeroBodyPart() == op.ZeroBodyPart());
+
+    // Exact: shortest representations read back to the same doubles.
+    op_2.Axpy(-1.0, op);
+    REQUIRE(op_2.Norm() == 0.0);
+  };
+
+  SECTION("In memory.") { check_round_trip(me1j, me2jp); }
+
+  SECTION("Text.") {
+    me1j.WriteTextFile(path_1b);
+    me2jp.WriteTextFile(path_2b);
+    check_round_trip(ME1JFile::FromTextFile(path_1b, emax, herm),
+                     ME2JPFile::FromTextFile(path_2b, emax, herm));
+  }
+
+  SECTION("Gzip.") {
+    me1j.WriteGZippedFile(path_1b + ".gz");
+    me2jp.WriteGZippedFile(path_2b + ".gz");
+    check_round_trip(ME1JFile::FromGZippedFile(path_1b + ".gz", emax, herm),
+                     ME2JPFile::FromGZippedFile(path_2b + ".gz", emax, herm));
+    std::filesystem::remove(path_1b + ".gz");
+    std::filesystem::remove(path_2b + ".gz");
+  }
+
+  SECTION("Binary.") {
+    me1j.WriteBinaryFile(path_1b + ".bin");
+    me2jp.WriteBinaryFile(path_2b + ".bin");
+    check_round_trip(ME1JFile::FromBinary(path_1b + ".bin", emax, herm),
+                     ME2JPFile::FromBinary(path_2b + ".bin", emax, herm));
+    std::filesystem::remove(path_1b + ".bin");
+    std::filesystem::remove(path_2b + ".bin");
+  }
+
+  std::filesystem::remove(path_1b);
+  std::filesystem::remove(path_2b);
+}
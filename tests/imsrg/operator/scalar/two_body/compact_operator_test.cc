@@ -0,0 +1,101 @@
+// Copyright 2022 Matthias Heinz
+#include "imsrg/operator/scalar/two_body/compact_operator.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "imsrg/files/formats/me2jp.h"
+#include "imsrg/operator/scalar/two_body/read.h"
+#include "imsrg/quantum_numbers/hermiticity.h"
+#include "imsrg/quantum_numbers/ho_energy.h"
+
+#include "tests/catch.hpp"
+
+TEST_CASE("Test BFloat16 conversions.") {
+  using imsrg::BFloat16;
+
+  SECTION("Exactly representable values.") {
+    for (const float val : {0.0f, 1.0f, -2.0f, 0.5f, 3.0f, -1024.0f}) {
+      REQUIRE(static_cast<float>(BFloat16(val)) == val);
+    }
+  }
+
+  SECTION("Rounding to nearest even.") {
+    // 1 + 2^-8 is halfway between 1 and 1 + 2^-7.
+    REQUIRE(static_cast<float>(BFloat16(1.0f + 0.00390625f)) == 1.0f);
+    // 1 + 3 * 2^-8 is halfway between 1 + 2^-7 and 1 + 2^-6.
+    REQUIRE(static_cast<float>(BFloat16(1.0f + 3 * 0.00390625f)) ==
+            1.0f + 4 * 0.00390625f);
+  }
+
+  SECTION("Relative error bound.") {
+    for (const float val : {0.1f, -3.14159f, 1234.5678f, 1e-6f}) {
+      const float rounded = static_cast<float>(BFloat16(val));
+      REQUIRE(std::abs(rounded - val) <= std::abs(val) * 0.00390625f);
+    }
+  }
+
+  SECTION("NaN stays NaN.") {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    REQUIRE(std::isnan(static_cast<float>(BFloat16(nan))));
+  }
+}
+
+TEST_CASE("Test compact operator round trip (emax=4).") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  const auto herm = Hermiticity::Hermitian();
+  auto op = imsrg::Scalar2BOperator::FromScalar2BModelSpace(ms_2b, herm);
+
+  std::string path_to_op_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04."
+      "me2jp";
+  imsrg::ReadOperatorFromME2JP(
+      ME2JPFile::FromTextFile(path_to_op_me2jp, emax, herm), op);
+
+  const auto op_f = imsrg::Scalar2BFloatOperator::FromScalar2BOperator(op);
+  const auto op_bf = imsrg::Scalar2BBFloat16Operator::FromScalar2BOperator(op);
+
+  REQUIRE(op_f.size() == op.size());
+  REQUIRE(op_bf.size() == op.size());
+  REQUIRE(2 * op_bf.SizeInBytes() == op_f.SizeInBytes());
+  REQUIRE(op_f.SizeInBytes() ==
+          ms_2b->ChannelLayout().TotalSize() * sizeof(float));
+
+  const auto op_f_expanded = op_f.ToScalar2BOperator();
+  REQUIRE(op_f_expanded.Herm() == herm);
+
+  for (std::size_t chan_index = 0; chan_index < op.size(); chan_index += 1) {
+    const auto& tensor = op.GetTensorAtIndex(chan_index);
+    const auto& tensor_f = op_f.GetTensorAtIndex(chan_index);
+    const auto& tensor_bf = op_bf.GetTensorAtIndex(chan_index);
+    const auto& tensor_f_expanded = op_f_expanded.GetTensorAtIndex(chan_index);
+
+    for (std::size_t s = 0; s < tensor.dim_size(3); s += 1) {
+      for (std::size_t r = 0; r < tensor.dim_size(2); r += 1) {
+        for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+          for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+            const double val = tensor(p, q, r, s);
+            REQUIRE(std::abs(tensor_f(p, q, r, s) - val) <=
+                    std::abs(val) * 6e-8);
+            REQUIRE(std::abs(tensor_bf(p, q, r, s) - val) <=
+                    std::abs(val) * 4e-3);
+            REQUIRE(tensor_f_expanded(p, q, r, s) == tensor_f(p, q, r, s));
+          }
+        }
+      }
+    }
+  }
+}
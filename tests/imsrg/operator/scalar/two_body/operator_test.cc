@@ -1,6 +1,19 @@
 // Copyright 2022 Matthias Heinz
 #include "imsrg/operator/scalar/two_body/operator.h"
 
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "fmt/core.h"
+
+#include "imsrg/files/formats/me2j.h"
 #include "imsrg/files/formats/me2jp.h"
 #include "imsrg/model_space/scalar/two_body/pandya_channel_key.h"
 #include "imsrg/operator/scalar/two_body/read.h"
@@ -9,6 +22,79 @@
 
 #include "tests/catch.hpp"
 
+namespace {
+// Isospin-coupled me2j text (e2max = 2 * emax, lmax = emax) with the matrix
+// elements of me2jp, inverting the proton-neutron conversion. T forbidden by
+// antisymmetry is 0.
+std::string ME2JTextFromME2JP(const imsrg::ME2JPFile& me2jp, int emax) {
+  struct Orbit {
+    int n;
+    int l;
+    int jj;
+  };
+  std::vector<Orbit> orbits;
+  for (int e = 0; e <= emax; e += 1) {
+    for (int l = e % 2; l <= e; l += 2) {
+      for (int jj = std::abs(2 * l - 1); jj <= 2 * l + 1; jj += 2) {
+        orbits.push_back({(e - l) / 2, l, jj});
+      }
+    }
+  }
+  const auto state = [](const Orbit& o, imsrg::IsospinProj m_tt) {
+    return imsrg::SPState(imsrg::RadialExcitationNumber(o.n),
+                          imsrg::OrbitalAngMom(o.l), imsrg::TotalAngMom(o.jj),
+                          m_tt);
+  };
+  const auto p = imsrg::IsospinProj::Proton();
+  const auto n = imsrg::IsospinProj::Neutron();
+
+  std::string text = "    me2j file for tests\n";
+  for (std::size_t a = 0; a < orbits.size(); a += 1) {
+    for (std::size_t b = 0; b <= a; b += 1) {
+      for (std::size_t c = 0; c <= a; c += 1) {
+        for (std::size_t d = 0; d <= ((c == a) ? b : c); d += 1) {
+          const auto& o_a = orbits[a];
+          const auto& o_b = orbits[b];
+          const auto& o_c = orbits[c];
+          const auto& o_d = orbits[d];
+          if ((o_a.l + o_b.l + o_c.l + o_d.l) % 2 != 0) {
+            continue;
+          }
+          const int jj_min =
+              std::max(std::abs(o_a.jj - o_b.jj), std::abs(o_c.jj - o_d.jj));
+          const int jj_max = std::min(o_a.jj + o_b.jj, o_c.jj + o_d.jj);
+          const bool same_orbits = (a == b) || (c == d);
+          const double norm =
+              std::sqrt((a == b ? 2.0 : 1.0) * (c == d ? 2.0 : 1.0));
+          for (int jj = jj_min; jj <= jj_max; jj += 2) {
+            const imsrg::TotalAngMom jj_2b(jj);
+            const bool even_j = (jj / 2) % 2 == 0;
+            const double pnpn = me2jp.Get2BMatrixElement(
+                state(o_a, p), state(o_b, n), state(o_c, p), state(o_d, n),
+                jj_2b);
+            const double pnnp = me2jp.Get2BMatrixElement(
+                state(o_a, p), state(o_b, n), state(o_c, n), state(o_d, p),
+                jj_2b);
+            const double pppp = me2jp.Get2BMatrixElement(
+                state(o_a, p), state(o_b, p), state(o_c, p), state(o_d, p),
+                jj_2b);
+            const double nnnn = me2jp.Get2BMatrixElement(
+                state(o_a, n), state(o_b, n), state(o_c, n), state(o_d, n),
+                jj_2b);
+            const double t_0 = (same_orbits && even_j) ? 0.0 : 1.0;
+            const double t_1 = (same_orbits && !even_j) ? 0.0 : 1.0;
+            text += fmt::format("{:.17g} {:.17g} {:.17g} {:.17g}\n",
+                                t_0 * (pnpn - pnnp) / norm, t_1 * pppp,
+                                t_1 * (pnpn + pnnp) / norm, t_1 * nnnn);
+          }
+        }
+      }
+    }
+  }
+  return text;
+}
+}  // namespace
+
 TEST_CASE("Test double Pandya is identity (emax=4).") {
   using imsrg::Hermiticity;
   using imsrg::HOEnergy;
@@ -115,3 +201,406 @@ TEST_CASE("Test double Pandya is identity (emax=4).") {
     }
   }
 }
+
+TEST_CASE("Test tensor placement and copies (emax=4).") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  const auto herm = Hermiticity::Hermitian();
+  auto op = imsrg::Scalar2BOperator::FromScalar2BModelSpace(ms_2b, herm);
+
+  SECTION("Placement accounts for every channel.") {
+    const auto placement = op.TensorPlacement();
+    REQUIRE(placement.channels_per_thread.size() ==
+            placement.bytes_per_thread.size());
+
+    std::size_t num_chans = 0;
+    std::size_t num_bytes = 0;
+    for (std::size_t i = 0; i < placement.channels_per_thread.size(); i += 1) {
+      num_chans += placement.channels_per_thread[i];
+      num_bytes += placement.bytes_per_thread[i];
+    }
+
+    std::size_t exp_num_bytes = 0;
+    for (std::size_t chan_index = 0; chan_index < ms_2b->NumberOfChannels();
+         chan_index += 1) {
+      const auto& tensor = op.GetTensorAtIndex(chan_index);
+      exp_num_bytes += tensor.dim_size(0) * tensor.dim_size(1) *
+                       tensor.dim_size(2) * tensor.dim_size(3) * sizeof(double);
+      REQUIRE(op.FirstTouchThreadAtIndex(chan_index) >= 0);
+    }
+
+    REQUIRE(num_chans == ms_2b->NumberOfChannels());
+    REQUIRE(num_bytes == exp_num_bytes);
+  }
+
+  SECTION("Channels are placed by the static schedule.") {
+    const auto num_chans = ms_2b->NumberOfChannels();
+    std::vector<int> exp_thread_ids(num_chans, -1);
+#pragma omp parallel for schedule(static)
+    for (std::size_t chan_index = 0; chan_index < num_chans; chan_index += 1) {
+      exp_thread_ids[chan_index] = omp_get_thread_num();
+    }
+
+    for (std::size_t chan_index = 0; chan_index < num_chans; chan_index += 1) {
+      REQUIRE(op.FirstTouchThreadAtIndex(chan_index) ==
+              exp_thread_ids[chan_index]);
+    }
+  }
+
+  SECTION("Copies share tensors until written.") {
+    std::string path_to_op_me2jp =
+        "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+        "calc_emax_04/"
+        "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04."
+        "me2jp";
+
+    const auto op_me2jp = ME2JPFile::FromTextFile(path_to_op_me2jp, emax, herm);
+    imsrg::ReadOperatorFromME2JP(op_me2jp, op);
+
+    auto op_copy = op;
+    for (std::size_t chan_index = 0; chan_index < ms_2b->NumberOfChannels();
+         chan_index += 1) {
+      REQUIRE(op.SharesTensorAtIndex(chan_index));
+      REQUIRE(op_copy.SharesTensorAtIndex(chan_index));
+      REQUIRE(&op.GetTensorAtIndex(chan_index)(0, 0, 0, 0) ==
+              &op_copy.GetTensorAtIndex(chan_index)(0, 0, 0, 0));
+
+      auto tensor = op.GetMutableTensorAtIndex(chan_index);
+      const auto tensor_copy = op_copy.GetTensorAtIndex(chan_index);
+      REQUIRE_FALSE(op.SharesTensorAtIndex(chan_index));
+      REQUIRE(&tensor(0, 0, 0, 0) != &tensor_copy(0, 0, 0, 0));
+
+      const auto dim_p = tensor.dim_size(0);
+      const auto dim_q = tensor.dim_size(1);
+      const auto dim_r = tensor.dim_size(2);
+      const auto dim_s = tensor.dim_size(3);
+
+      for (std::size_t p = 0; p < dim_p; p += 1) {
+        for (std::size_t q = 0; q < dim_q; q += 1) {
+          for (std::size_t r = 0; r < dim_r; r += 1) {
+            for (std::size_t s = 0; s < dim_s; s += 1) {
+              const double val = tensor(p, q, r, s);
+              REQUIRE(tensor_copy(p, q, r, s) == Approx(val).margin(1e-12));
+              tensor(p, q, r, s) = val + 1.0;
+              REQUIRE(tensor_copy(p, q, r, s) == Approx(val).margin(1e-12));
+            }
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("Updating a shared tensor leaves the copy unchanged.") {
+    std::string path_to_op_me2jp =
+        "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+        "calc_emax_04/"
+        "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04."
+        "me2jp";
+
+    const auto op_me2jp = ME2JPFile::FromTextFile(path_to_op_me2jp, emax, herm);
+    imsrg::ReadOperatorFromME2JP(op_me2jp, op);
+
+    const auto op_copy = op;
+    for (std::size_t chan_index = 0; chan_index < ms_2b->NumberOfChannels();
+         chan_index += 1) {
+      op.UpdateTensorAtIndex(
+          chan_index, [](const auto& tensor, auto& new_tensor) {
+            REQUIRE(&tensor(0, 0, 0, 0) != &new_tensor(0, 0, 0, 0));
+            for (std::size_t s = 0; s < new_tensor.dim_size(3); s += 1) {
+              for (std::size_t r = 0; r < new_tensor.dim_size(2); r += 1) {
+                for (std::size_t q = 0; q < new_tensor.dim_size(1); q += 1) {
+                  for (std::size_t p = 0; p < new_tensor.dim_size(0); p += 1) {
+                    new_tensor(p, q, r, s) = 2.0 * tensor(p, q, r, s);
+                  }
+                }
+              }
+            }
+          });
+      REQUIRE_FALSE(op.SharesTensorAtIndex(chan_index));
+
+      const auto tensor = op.GetTensorAtIndex(chan_index);
+      const auto tensor_copy = op_copy.GetTensorAtIndex(chan_index);
+      for (std::size_t s = 0; s < tensor.dim_size(3); s += 1) {
+        for (std::size_t r = 0; r < tensor.dim_size(2); r += 1) {
+          for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+            for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+              REQUIRE(tensor(p, q, r, s) ==
+                      Approx(2.0 * tensor_copy(p, q, r, s)).margin(1e-12));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Test out-of-core operator matches in-memory operator (emax=4).") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  const auto herm = Hermiticity::Hermitian();
+  std::string path_to_op_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04."
+      "me2jp";
+  const auto op_me2jp = ME2JPFile::FromTextFile(path_to_op_me2jp, emax, herm);
+
+  auto op = imsrg::Scalar2BOperator::FromScalar2BModelSpace(ms_2b, herm);
+  imsrg::ReadOperatorFromME2JP(op_me2jp, op);
+
+  const std::string scratch_path =
+      (std::filesystem::temp_directory_path() / "imsrg_operator_test.scratch")
+          .string();
+  auto op_ooc = imsrg::Scalar2BOperator::FromScalar2BModelSpaceOutOfCore(
+      ms_2b, herm, scratch_path);
+  REQUIRE(op_ooc.IsOutOfCore());
+  REQUIRE_FALSE(op.IsOutOfCore());
+
+  imsrg::ReadOperatorFromME2JP(op_me2jp, op_ooc);
+  REQUIRE(op_ooc.FirstTouchThreadAtIndex(0) == -1);
+
+  // Scale one channel to check that writes survive eviction.
+  const std::size_t scaled_index = ms_2b->NumberOfChannels() / 2;
+  {
+    auto tensor = op_ooc.GetMutableTensorAtIndex(scaled_index);
+    for (std::size_t s = 0; s < tensor.dim_size(3); s += 1) {
+      for (std::size_t r = 0; r < tensor.dim_size(2); r += 1) {
+        for (std::size_t q = 0; q < tensor.dim_size(1); q += 1) {
+          for (std::size_t p = 0; p < tensor.dim_size(0); p += 1) {
+            tensor(p, q, r, s) *= 2.0;
+          }
+        }
+      }
+    }
+  }
+  op_ooc.EvictAllTensors();
+
+  for (std::size_t chan_index = 0; chan_index < ms_2b->NumberOfChannels();
+       chan_index += 1) {
+    op_ooc.PrefetchTensorAtIndex(chan_index + 1);
+    const auto& exp_tensor = op.GetTensorAtIndex(chan_index);
+    const auto& actual_tensor = op_ooc.GetTensorAtIndex(chan_index);
+    const double factor = chan_index == scaled_index ? 2.0 : 1.0;
+
+    const auto dim_p = exp_tensor.dim_size(0);
+    const auto dim_q = exp_tensor.dim_size(1);
+    const auto dim_r = exp_tensor.dim_size(2);
+    const auto dim_s = exp_tensor.dim_size(3);
+    REQUIRE(actual_tensor.dim_size(0) == dim_p);
+    REQUIRE(actual_tensor.dim_size(1) == dim_q);
+    REQUIRE(actual_tensor.dim_size(2) == dim_r);
+    REQUIRE(actual_tensor.dim_size(3) == dim_s);
+
+    for (std::size_t p = 0; p < dim_p; p += 1) {
+      for (std::size_t q = 0; q < dim_q; q += 1) {
+        for (std::size_t r = 0; r < dim_r; r += 1) {
+          for (std::size_t s = 0; s < dim_s; s += 1) {
+            REQUIRE(actual_tensor(p, q, r, s) ==
+                    Approx(factor * exp_tensor(p, q, r, s)).margin(1e-12));
+          }
+        }
+      }
+    }
+    op_ooc.EvictTensorAtIndex(chan_index);
+  }
+
+  // Copies share the scratch file until written.
+  auto op_copy = op_ooc;
+  REQUIRE(op_copy.IsOutOfCore());
+  REQUIRE(op_copy.SharesTensorAtIndex(scaled_index));
+  {
+    auto tensor = op_copy.GetMutableTensorAtIndex(scaled_index);
+    REQUIRE_FALSE(op_copy.SharesTensorAtIndex(scaled_index));
+    tensor(0, 0, 0, 0) += 1.0;
+  }
+  op_copy.EvictAllTensors();
+  REQUIRE(op_copy.IsOutOfCore());
+  REQUIRE(op_copy.GetTensorAtIndex(scaled_index)(0, 0, 0, 0) ==
+          Approx(op_ooc.GetTensorAtIndex(scaled_index)(0, 0, 0, 0) + 1.0)
+              .margin(1e-12));
+}
+
+TEST_CASE("Test reading with a precomputed ME2JP read plan (emax=4).") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  const std::string path_prefix =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04";
+  const auto h_me2jp = ME2JPFile::FromTextFile(path_prefix + ".me2jp", emax,
+                                               Hermiticity::Hermitian());
+  const auto gen_me2jp = ME2JPFile::FromTextFile(
+      path_prefix + "_imaginary-time_Moller_Plesset_gen2.me2jp", emax,
+      Hermiticity::AntiHermitian());
+
+  // One plan for both files
+  const auto plan =
+      imsrg::ME2JPReadPlan::FromModelSpaceAndFile(ms_2b, h_me2jp);
+  REQUIRE(plan.EMax() == emax);
+  REQUIRE(plan.SizeInBytes() == ms_2b->ChannelLayout().TotalSize() *
+                                    sizeof(imsrg::ME2JPElementLocation));
+
+  for (const auto* me2jp : {&h_me2jp, &gen_me2jp}) {
+    auto op =
+        imsrg::Scalar2BOperator::FromScalar2BModelSpace(ms_2b, me2jp->Herm());
+    auto op_plan =
+        imsrg::Scalar2BOperator::FromScalar2BModelSpace(ms_2b, me2jp->Herm());
+    imsrg::ReadOperatorFromME2JP(*me2jp, op);
+    imsrg::ReadOperatorFromME2JP(*me2jp, plan, op_plan);
+
+    for (std::size_t chan_index = 0; chan_index < ms_2b->NumberOfChannels();
+         chan_index += 1) {
+      const auto& exp_tensor = op.GetTensorAtIndex(chan_index);
+      const auto& actual_tensor = op_plan.GetTensorAtIndex(chan_index);
+      for (std::size_t s = 0; s < exp_tensor.dim_size(3); s += 1) {
+        for (std::size_t r = 0; r < exp_tensor.dim_size(2); r += 1) {
+          for (std::size_t q = 0; q < exp_tensor.dim_size(1); q += 1) {
+            for (std::size_t p = 0; p < exp_tensor.dim_size(0); p += 1) {
+              REQUIRE(actual_tensor(p, q, r, s) == exp_tensor(p, q, r, s));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Test reading a truncated ME2JP file into a smaller model space.") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy file_emax(4);
+  const HOEnergy emax(3);
+  const HOEnergy e2max(4);
+  const auto herm = Hermiticity::Hermitian();
+
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpaceAndE2Max(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())),
+      e2max);
+
+  std::string path_to_op_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04."
+      "me2jp";
+  const auto full_me2jp =
+      ME2JPFile::FromTextFile(path_to_op_me2jp, file_emax, herm);
+  const auto truncated_me2jp = ME2JPFile::FromTextFile(
+      path_to_op_me2jp, file_emax, emax, ms_2b->E2Max(), herm);
+
+  auto op = imsrg::Scalar2BOperator::FromScalar2BModelSpace(ms_2b, herm);
+  auto op_truncated =
+      imsrg::Scalar2BOperator::FromScalar2BModelSpace(ms_2b, herm);
+  imsrg::ReadOperatorFromME2JP(full_me2jp, op);
+  imsrg::ReadOperatorFromME2JP(truncated_me2jp, op_truncated);
+
+  for (std::size_t chan_index = 0; chan_index < ms_2b->NumberOfChannels();
+       chan_index += 1) {
+    const auto& exp_tensor = op.GetTensorAtIndex(chan_index);
+    const auto& actual_tensor = op_truncated.GetTensorAtIndex(chan_index);
+    for (std::size_t s = 0; s < exp_tensor.dim_size(3); s += 1) {
+      for (std::size_t r = 0; r < exp_tensor.dim_size(2); r += 1) {
+        for (std::size_t q = 0; q < exp_tensor.dim_size(1); q += 1) {
+          for (std::size_t p = 0; p < exp_tensor.dim_size(0); p += 1) {
+            REQUIRE(actual_tensor(p, q, r, s) == exp_tensor(p, q, r, s));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Test reading an isospin-coupled me2j file (emax=4).") {
+  using imsrg::Hermiticity;
+  using imsrg::HOEnergy;
+  using imsrg::ME2JFile;
+  using imsrg::ME2JPFile;
+
+  const HOEnergy emax(4);
+  const auto herm = Hermiticity::Hermitian();
+
+  const auto ms_2b = imsrg::Scalar2BModelSpace::FromSPModelSpace(
+      imsrg::SPModelSpace::FromFullBasis(
+          imsrg::SPFullBasis::FromEMaxAndReferenceState(
+              emax, imsrg::ReferenceState::O16())));
+
+  std::string path_to_op_me2jp =
+      "tests/data/from_ragnar/NN-only/O16/EMN500_N3LO/NAT/hw_24.00/"
+      "calc_emax_04/"
+      "HNO_O16_NN-only_EMN500_N3LO_NAT_mf_calc_emax_04_hw_24.00_emax_04."
+      "me2jp";
+  const auto me2jp = ME2JPFile::FromTextFile(path_to_op_me2jp, emax, herm);
+
+  const std::string path_to_op_me2j =
+      (std::filesystem::temp_directory_path() / "imsrg_operator_test.me2j")
+          .string();
+  {
+    std::ofstream file(path_to_op_me2j);
+    file << ME2JTextFromME2JP(me2jp, emax.AsInt());
+  }
+  const auto me2j = ME2JFile::FromTextFile(
+      path_to_op_me2j, emax, HOEnergy(8), imsrg::OrbitalAngMom(4), herm);
+  std::filesystem::remove(path_to_op_me2j);
+
+  auto op = imsrg::Scalar2BOperator::FromScalar2BModelSpace(ms_2b, herm);
+  auto op_me2j = imsrg::Scalar2BOperator::FromScalar2BModelSpace(ms_2b, herm);
+  imsrg::ReadOperatorFromME2JP(me2jp, op);
+  imsrg::ReadOperatorFromME2J(me2j, op_me2j);
+
+  // The test data breaks isospin symmetry, so only like-particle channels
+  // are the same (see tests/imsrg/files/formats/me2j_test.cc).
+  std::size_t num_mismatches = 0;
+  for (std::size_t chan_index = 0; chan_index < ms_2b->NumberOfChannels();
+       chan_index += 1) {
+    const auto m_tt =
+        ms_2b->ChannelAtIndex(chan_index).ChannelKey().OpChannel().M_TT();
+    if (m_tt.AsInt() == 0) {
+      continue;
+    }
+    const auto& exp_tensor = op.GetTensorAtIndex(chan_index);
+    const auto& actual_tensor = op_me2j.GetTensorAtIndex(chan_index);
+    for (std::size_t s = 0; s < exp_tensor.dim_size(3); s += 1) {
+      for (std::size_t r = 0; r < exp_tensor.dim_size(2); r += 1) {
+        for (std::size_t q = 0; q < exp_tensor.dim_size(1); q += 1) {
+          for (std::size_t p = 0; p < exp_tensor.dim_size(0); p += 1) {
+            if (std::abs(actual_tensor(p, q, r, s) -
+                         exp_tensor(p, q, r, s)) > 1e-10) {
+              num_mismatches += 1;
+            }
+          }
+        }
+      }
+    }
+  }
+  REQUIRE(num_mismatches == 0);
+}